@@ -31,6 +31,8 @@
 
 #define STACK_SIZE          0x1000
 
+#define SCRATCH_ARENA_SZ    0x10000  /* Per-test scratch, reset after every test */
+
 #define PAGE_SIZE_4K        0x1000
 #define PAGE_SIZE_16K       (4 * 0x1000)
 #define PAGE_SIZE_64K       (16 * 0x1000)
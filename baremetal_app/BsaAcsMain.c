@@ -156,6 +156,7 @@ freeBsaAcsMem()
   val_pcie_free_info_table();
   val_iovirt_free_info_table();
   val_peripheral_free_info_table();
+  val_arena_free();
   val_free_shared_mem();
 }
 
@@ -241,6 +242,11 @@ ShellAppMainbsa(
   createPcieVirtInfoTable();
   createPeripheralInfoTable();
 
+  /* Info tables are sized by the platform overrides, only scratch is needed */
+  Status = val_arena_create(0, SCRATCH_ARENA_SZ);
+  if (Status)
+    return Status;
+
   val_allocate_shared_mem();
 
   /* Initialise exception vector, so any unexpected exception gets handled
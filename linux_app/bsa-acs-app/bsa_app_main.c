@@ -16,11 +16,15 @@
  **/
 
 
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <string.h>
 #include <ctype.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <sched.h>
+#include <pthread.h>
+#include <time.h>
 #include "include/bsa_app.h"
 #include <getopt.h>
 
@@ -32,6 +36,15 @@ unsigned long int  g_exception_ret_addr;
 unsigned int g_print_mmio;
 unsigned int g_curr_module;
 unsigned int g_enable_module;
+unsigned int g_num_workers;
+unsigned int g_pcie_sysfs;
+
+typedef struct __BSA_WORKER__ {
+    pthread_t       thread;
+    int             cpu;
+    int             status;
+    bsa_test_plan_t plan;
+}bsa_worker_t;
 
 int
 initialize_test_environment(unsigned int print_level)
@@ -47,15 +60,145 @@ cleanup_test_environment()
     call_drv_clean_test_env();
 }
 
+static void *
+run_worker(void *arg)
+{
+    bsa_worker_t *worker = (bsa_worker_t *)arg;
+    cpu_set_t    cpu_set;
+
+    /* Pin the submitting thread, the kernel runs the shard on this CPU */
+    CPU_ZERO(&cpu_set);
+    CPU_SET(worker->cpu, &cpu_set);
+    if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set))
+        printf("\n       Could not pin shard %d to CPU %d\n", worker->plan.shard, worker->cpu);
+
+    worker->status = call_drv_submit_plan(&worker->plan);
+
+    return NULL;
+}
+
+/**
+  Run the Memory and Peripheral suites and the PCIe BDF table shards on
+  pinned worker threads, one shard per worker. With two workers Memory and
+  Peripheral share the first shard. The output of all shards is captured
+  from the message ring and printed in test number order once every shard
+  has sent its BSA_MSG_SHARD_DONE record.
+
+  @return 0 on success, -1 if the parallel run could not be started
+**/
+int
+execute_tests_parallel(unsigned int num_workers, unsigned int print_level, int run_pcie)
+{
+    bsa_worker_t  *worker;
+    unsigned int  num_shards, pcie_shards, base, submitted, i;
+    long          num_cpus;
+    struct timespec now, deadline;
+    struct timespec idle = {0, BSA_MSG_RING_POLL_MS * 1000000L};
+
+    /* Shard output can only be told apart through the tagged ring */
+    if (!bsa_msg_ring_available())
+        return -1;
+
+    num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (num_cpus < 1)
+        num_cpus = 1;
+
+    /* Memory and Peripheral take the first shards, the rest split PCIe */
+    num_shards = run_pcie ? num_workers : 2;
+    if (num_shards > BSA_PLAN_MAX_SHARDS)
+        num_shards = BSA_PLAN_MAX_SHARDS;
+    base        = (run_pcie && num_shards < 3) ? 1 : 2;
+    pcie_shards = run_pcie ? (num_shards - base) : 0;
+
+    worker = (bsa_worker_t *) calloc(num_shards, sizeof(bsa_worker_t));
+    if (worker == NULL)
+        return -1;
+
+    for (i = 0; i < num_shards; i++) {
+        init_test_plan(&worker[i].plan, 1, print_level, g_sw_view, g_skip_test_num);
+        worker[i].plan.shard      = i;
+        worker[i].plan.pcie_shard = (i >= base) ? (i - base) : 0;
+        worker[i].plan.num_shards = pcie_shards;
+        worker[i].cpu             = i % num_cpus;
+    }
+
+    /* Shards are ordered by test number so the merge stays deterministic */
+    add_test_plan_entry(&worker[0].plan, BSA_MEM_EXECUTE_TEST);
+    add_test_plan_entry(&worker[base - 1].plan, BSA_PER_EXECUTE_TEST);
+    for (i = base; i < num_shards; i++)
+        add_test_plan_entry(&worker[i].plan, BSA_PCIE_EXECUTE_TEST);
+
+    printf("\n      *** Starting Memory Map, Peripherals%s tests on %d shards ***\n",
+           run_pcie ? " and PCIe" : "", num_shards);
+
+    capture_bsa_msg(1);
+
+    for (i = 0; i < num_shards; i++) {
+        if (pthread_create(&worker[i].thread, NULL, run_worker, &worker[i])) {
+            /* Run it from this thread instead */
+            run_worker(&worker[i]);
+            worker[i].thread = 0;
+        }
+    }
+
+    submitted = 0;
+    for (i = 0; i < num_shards; i++) {
+        if (worker[i].thread)
+            pthread_join(worker[i].thread, NULL);
+        if (worker[i].status)
+            printf("\n       Failed to submit shard %d\n", i);
+        else
+            submitted++;
+    }
+
+    /* An older kernel module ignores plans, run sequentially instead */
+    if ((submitted == 0) || !call_drv_plan_accepted()) {
+        flush_bsa_msg_capture();
+        free(worker);
+        return -1;
+    }
+
+    /* Keep the ring drained until every submitted shard has finished. The
+       deadline moves on whenever a record arrives, so only a shard that
+       stays silent for BSA_MSG_SHARD_TIMEOUT_S ends the wait. */
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += BSA_MSG_SHARD_TIMEOUT_S;
+    while (bsa_msg_shards_done() < submitted) {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (read_from_proc_bsa_msg()) {
+            deadline.tv_sec = now.tv_sec + BSA_MSG_SHARD_TIMEOUT_S;
+            continue;
+        }
+        if (now.tv_sec >= deadline.tv_sec)
+            break;
+        nanosleep(&idle, NULL);
+    }
+
+    flush_bsa_msg_capture();
+
+    for (i = 0; i < num_shards; i++) {
+        if (!worker[i].status && !bsa_msg_shard_done(i))
+            printf("\n       Shard %d did not finish, no record for %d s : FAIL\n",
+                   i, BSA_MSG_SHARD_TIMEOUT_S);
+    }
+
+    free(worker);
+    return 0;
+}
+
 void print_help(){
-  printf ("\nUsage: Bsa [-v <n>] | [--skip <n>]\n"
+  printf ("\nUsage: Bsa [-v <n>] | [-j <n>] | [--skip <n>] | [--sysfs]\n"
          "Options:\n"
          "-v      Verbosity of the Prints\n"
          "        1 shows all prints, 5 shows Errors\n"
+         "-j      Number of worker threads to run the suites with\n"
+         "        Each worker is pinned to its own CPU\n"
          "--skip  Test(s) to be skipped\n"
          "        Refer to section 4 of BSA_ACS_User_Guide\n"
          "        To skip a module, use Model_ID as mentioned in user guide\n"
          "        To skip a particular test within a module, use the exact testcase number\n"
+         "--sysfs Also check PCIe register values on config space read from sysfs\n"
+         "        These do not need the BSA kernel module\n"
   );
 }
 
@@ -67,24 +210,29 @@ main (int argc, char **argv)
     char *endptr, *pt;
     int   status;
     int   run_exerciser = 0;
+    bsa_test_plan_t plan;
 
     struct option long_opt[] =
     {
       {"skip", required_argument, NULL, 'n'},
+      {"sysfs", no_argument, NULL, 's'},
       {"help", no_argument, NULL, 'h'},
       {NULL, 0, NULL, 0}
     };
 
-    g_skip_test_num = (unsigned int *) malloc(g_num_skip * sizeof(unsigned int));
+    g_skip_test_num = (unsigned int *) calloc(BSA_PLAN_MAX_SKIP, sizeof(unsigned int));
 
     /* Process Command Line arguments */
-    while ((c = getopt_long(argc, argv, "hv:e:", long_opt, NULL)) != -1)
+    while ((c = getopt_long(argc, argv, "hv:e:j:", long_opt, NULL)) != -1)
     {
        switch (c)
        {
        case 'v':
          g_print_level = strtol(optarg, &endptr, 10);
          break;
+       case 'j':
+         g_num_workers = strtol(optarg, &endptr, 10);
+         break;
        case 'h':
          print_help();
          return 1;
@@ -97,6 +245,9 @@ main (int argc, char **argv)
            pt = strtok(NULL, ",");
          }
          break;
+       case 's':
+         g_pcie_sysfs = 1;
+         break;
        case 'e':
          run_exerciser = 1;
          break;
@@ -124,6 +275,13 @@ main (int argc, char **argv)
 
     printf("\n Starting tests (Print level is %2d)\n\n", g_print_level);
 
+    if (g_pcie_sysfs) {
+        printf("\n      *** Starting PCIe sysfs read-only checks ***\n");
+        /* Only the register values are checked here, the kernel PCIe suite
+           still runs the same tests for the RW/RW1C/RO attribute checks */
+        execute_tests_pcie_sysfs(g_print_level);
+    }
+
     printf(" Gathering system information....\n");
     status = initialize_test_environment(g_print_level);
     if (status) {
@@ -131,20 +289,32 @@ main (int argc, char **argv)
         return 0;
     }
 
-    printf("\n      *** Starting Memory Map tests ***\n");
-    execute_tests_memory(1, g_print_level);
+    if (run_exerciser)
+        printf("\n      *** PCIe Exerciser tests only runs on UEFI ***\n");
 
-    printf("\n      *** Starting Peripherals tests ***\n");
-    execute_tests_peripheral(1, g_print_level);
+    if ((g_num_workers > 1) &&
+        (execute_tests_parallel(g_num_workers, g_print_level, !run_exerciser) == 0))
+        goto done;
 
-    if (run_exerciser) {
-        printf("\n      *** PCIe Exerciser tests only runs on UEFI ***\n");
-        //execute_tests_exerciser(1, g_print_level);
-    } else {
-        printf("\n      *** Starting PCIe tests ***\n");
-        execute_tests_pcie(1, g_print_level);
+    init_test_plan(&plan, 1, g_print_level, g_sw_view, g_skip_test_num);
+    add_test_plan_entry(&plan, BSA_MEM_EXECUTE_TEST);
+    add_test_plan_entry(&plan, BSA_PER_EXECUTE_TEST);
+
+    if (!run_exerciser)
+        add_test_plan_entry(&plan, BSA_PCIE_EXECUTE_TEST);
+
+    printf("\n      *** Starting Memory Map, Peripherals%s tests ***\n",
+           run_exerciser ? "" : " and PCIe");
+
+    /* Older kernel modules do not understand a plan, submit module by module */
+    if (call_drv_execute_plan(&plan) < 0) {
+        execute_tests_memory(1, g_print_level);
+        execute_tests_peripheral(1, g_print_level);
+        if (!run_exerciser)
+            execute_tests_pcie(1, g_print_level);
     }
 
+done:
     printf("\n                    *** BSA tests complete ***\n\n");
 
     cleanup_test_environment();
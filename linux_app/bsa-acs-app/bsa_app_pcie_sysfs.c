@@ -0,0 +1,386 @@
+/** @file
+ * Copyright (c) 2024, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <pthread.h>
+
+#include "include/bsa_app.h"
+
+/* Only the bit-field tables are used from the VAL PCIe header, the
+   prototypes that refer to these types are never called from here */
+typedef struct PERIPHERAL_VECTOR_LIST PERIPHERAL_VECTOR_LIST;
+typedef struct PERIPHERAL_IRQ_MAP PERIPHERAL_IRQ_MAP;
+
+#include "val/include/bsa_acs_common.h"
+#include "val/include/bsa_acs_pcie.h"
+#include "test_pool/pcie/operating_system/test_os_p020_data.h"
+#include "test_pool/pcie/operating_system/test_os_p021_data.h"
+#include "test_pool/pcie/operating_system/test_os_p022_data.h"
+#include "test_pool/pcie/operating_system/test_os_p024_data.h"
+#include "test_pool/pcie/operating_system/test_os_p025_data.h"
+#include "test_pool/pcie/operating_system/test_os_p026_data.h"
+
+/* Status codes as defined in pal_interface.h, which is kernel only */
+#define PCIE_SUCCESS            0x00000000
+#define PCIE_CAP_NOT_FOUND      0x10000010
+#define PCIE_UNKNOWN_RESPONSE   0xFFFFFFFF
+
+/* Bit-field could not be checked because it lies beyond the snapshot */
+#define PCIE_SYSFS_SKIP         2
+
+#define PCIE_SYSFS_DEVICES      "/sys/bus/pci/devices"
+#define PCIE_SYSFS_MAX_THREADS  16
+#define PCIE_SYSFS_MAX_CAPS     48
+
+typedef struct {
+  uint32_t bdf;
+  uint32_t cfg_size;                   /* Bytes readable, 64 for non root users */
+  char     name[16];                   /* SSSS:BB:DD.F */
+  uint8_t  cfg[PCIE_CFG_SIZE];
+} pcie_sysfs_dev_t;
+
+typedef struct {
+  uint32_t                    test_num;
+  char                        *desc;
+  char                        *rule;
+  pcie_cfgreg_bitfield_entry  *table;
+  uint32_t                    num_entries;
+} pcie_sysfs_test_t;
+
+#define PCIE_SYSFS_TEST(n, d, r) \
+  {ACS_PCIE_TEST_NUM_BASE + n, d, r, bf_info_table##n, \
+   sizeof(bf_info_table##n) / sizeof(bf_info_table##n[0])}
+
+/* Value checks of the bit-field tests. Attribute checks write config
+   space and stay in the kernel module. */
+static pcie_sysfs_test_t g_sysfs_test[] = {
+  PCIE_SYSFS_TEST(20, "Type 0/1 common config rule           ", "PCI_IN_05, PCI_IN_19"),
+  PCIE_SYSFS_TEST(21, "Type 0 config header rules            ", "B_PER_12"),
+  PCIE_SYSFS_TEST(22, "Check Type 1 config header rules      ", "PCI_IN_05, PCI_IN_19"),
+  PCIE_SYSFS_TEST(24, "Device capabilities reg rule          ", "PCI_IN_05"),
+  PCIE_SYSFS_TEST(25, "Device Control register rule          ", "PCI_IN_05"),
+  PCIE_SYSFS_TEST(26, "Device cap 2 register rules           ", "PCI_IN_05"),
+};
+
+static pcie_sysfs_dev_t  *g_sysfs_dev;
+static uint32_t          g_sysfs_num_dev;
+static uint32_t          g_sysfs_next_dev;
+static unsigned int      g_sysfs_print_level;
+
+/**
+  Worker of the snapshot thread pool. Each thread claims the next device
+  and reads its whole config space with a single pread.
+**/
+static void *
+pcie_sysfs_read_worker(void *arg)
+{
+  pcie_sysfs_dev_t *dev;
+  char     path[64];
+  uint32_t index;
+  ssize_t  len;
+  int      fd;
+
+  (void)arg;
+
+  while ((index = __atomic_fetch_add(&g_sysfs_next_dev, 1, __ATOMIC_RELAXED)) < g_sysfs_num_dev)
+  {
+      dev = &g_sysfs_dev[index];
+      memset(dev->cfg, 0xFF, sizeof(dev->cfg));
+      dev->cfg_size = 0;
+
+      snprintf(path, sizeof(path), PCIE_SYSFS_DEVICES "/%s/config", dev->name);
+      fd = open(path, O_RDONLY);
+      if (fd < 0)
+          continue;
+
+      len = pread(fd, dev->cfg, PCIE_CFG_SIZE, 0);
+      if (len > 0)
+          dev->cfg_size = len;
+
+      close(fd);
+  }
+
+  return NULL;
+}
+
+/**
+  Take a snapshot of the config space of every function listed in sysfs.
+
+  @return Number of functions found
+**/
+static uint32_t
+pcie_sysfs_snapshot(void)
+{
+  pthread_t      thread[PCIE_SYSFS_MAX_THREADS];
+  struct dirent  *entry;
+  unsigned int   seg, bus, dev, func;
+  uint32_t       max_dev, num_threads, i;
+  long           num_cpus;
+  DIR            *dir;
+  void           *buf;
+
+  dir = opendir(PCIE_SYSFS_DEVICES);
+  if (dir == NULL)
+      return 0;
+
+  max_dev = 0;
+  while ((entry = readdir(dir)) != NULL)
+  {
+      if (sscanf(entry->d_name, "%x:%x:%x.%x", &seg, &bus, &dev, &func) != 4)
+          continue;
+      if (strlen(entry->d_name) >= sizeof(g_sysfs_dev[0].name))
+          continue;
+
+      if (g_sysfs_num_dev == max_dev) {
+          max_dev = max_dev ? (max_dev * 2) : 64;
+          buf = realloc(g_sysfs_dev, max_dev * sizeof(pcie_sysfs_dev_t));
+          if (buf == NULL)
+              break;
+          g_sysfs_dev = buf;
+      }
+
+      g_sysfs_dev[g_sysfs_num_dev].bdf = PCIE_CREATE_BDF(seg, bus, dev, func);
+      memcpy(g_sysfs_dev[g_sysfs_num_dev].name, entry->d_name, strlen(entry->d_name) + 1);
+      g_sysfs_num_dev++;
+  }
+  closedir(dir);
+
+  num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  num_threads = (num_cpus > 0) ? num_cpus : 1;
+  if (num_threads > PCIE_SYSFS_MAX_THREADS)
+      num_threads = PCIE_SYSFS_MAX_THREADS;
+  if (num_threads > g_sysfs_num_dev)
+      num_threads = g_sysfs_num_dev;
+
+  g_sysfs_next_dev = 0;
+  for (i = 0; i < num_threads; i++) {
+      if (pthread_create(&thread[i], NULL, pcie_sysfs_read_worker, NULL))
+          break;
+  }
+
+  /* Whatever is left, including everything if no thread started */
+  pcie_sysfs_read_worker(NULL);
+
+  while (i--)
+      pthread_join(thread[i], NULL);
+
+  return g_sysfs_num_dev;
+}
+
+static uint32_t
+pcie_sysfs_read_cfg(pcie_sysfs_dev_t *dev, uint32_t offset)
+{
+  uint32_t data;
+
+  offset &= ~WORD_ALIGN_MASK;
+  if (offset + sizeof(data) > dev->cfg_size)
+      return PCIE_UNKNOWN_RESPONSE;
+
+  memcpy(&data, &dev->cfg[offset], sizeof(data));
+  return data;
+}
+
+/**
+  Same walk as val_pcie_find_capability on the config space snapshot,
+  bounded so that a broken capability list cannot loop forever.
+**/
+static uint32_t
+pcie_sysfs_find_capability(pcie_sysfs_dev_t *dev, uint32_t cid_type, uint32_t cid,
+  uint32_t *cid_offset)
+{
+  uint32_t reg_value;
+  uint32_t next_cap_offset;
+  uint32_t count = 0;
+
+  if (cid_type == PCIE_CAP) {
+      reg_value = pcie_sysfs_read_cfg(dev, TYPE01_CPR);
+      if (reg_value == PCIE_UNKNOWN_RESPONSE)
+          return PCIE_UNKNOWN_RESPONSE;
+
+      next_cap_offset = (reg_value & TYPE01_CPR_MASK);
+      while (next_cap_offset && (count++ < PCIE_SYSFS_MAX_CAPS))
+      {
+          reg_value = pcie_sysfs_read_cfg(dev, next_cap_offset);
+          if ((reg_value & PCIE_CIDR_MASK) == cid)
+          {
+              *cid_offset = next_cap_offset;
+              return PCIE_SUCCESS;
+          }
+          next_cap_offset = ((reg_value >> PCIE_NCPR_SHIFT) & PCIE_NCPR_MASK);
+      }
+  } else if (cid_type == PCIE_ECAP) {
+      next_cap_offset = PCIE_ECAP_START;
+      while (next_cap_offset && (count++ < (PCIE_CFG_SIZE / 4)))
+      {
+          reg_value = pcie_sysfs_read_cfg(dev, next_cap_offset);
+          if (reg_value == PCIE_UNKNOWN_RESPONSE)
+              break;
+          if ((reg_value & PCIE_ECAP_CIDR_MASK) == cid)
+          {
+              *cid_offset = next_cap_offset;
+              return PCIE_SUCCESS;
+          }
+          next_cap_offset = ((reg_value >> PCIE_ECAP_NCPR_SHIFT) & PCIE_ECAP_NCPR_MASK);
+      }
+  }
+
+  return PCIE_CAP_NOT_FOUND;
+}
+
+/**
+  Device/port type of the function. On-chip peripherals are not known to
+  userspace, so iEP_EP and iEP_RP are reported as EP and RP.
+**/
+static uint32_t
+pcie_sysfs_device_port_type(pcie_sysfs_dev_t *dev)
+{
+  uint32_t pciecs_base;
+  uint32_t reg_value;
+
+  if (pcie_sysfs_find_capability(dev, PCIE_CAP, CID_PCIECS, &pciecs_base))
+      return 0;
+
+  reg_value = pcie_sysfs_read_cfg(dev, pciecs_base + CIDR_OFFSET);
+
+  return (1 << ((reg_value >> ((PCIECR_OFFSET - CIDR_OFFSET)*8 + PCIECR_DPT_SHIFT)) &
+                PCIECR_DPT_MASK));
+}
+
+static uint32_t
+pcie_sysfs_bitfield_check(pcie_sysfs_dev_t *dev, pcie_cfgreg_bitfield_entry *bf_entry)
+{
+  uint32_t bf_value;
+  uint32_t cap_base = 0;
+  uint32_t reg_value;
+  uint32_t reg_offset;
+  uint32_t alignment_byte_cnt;
+  uint32_t status = PCIE_SUCCESS;
+
+  reg_offset = bf_entry->reg_offset;
+  alignment_byte_cnt = (reg_offset & WORD_ALIGN_MASK);
+  reg_offset = reg_offset - alignment_byte_cnt;
+
+  if (bf_entry->reg_type == PCIE_CAP)
+      status = pcie_sysfs_find_capability(dev, PCIE_CAP, bf_entry->cap_id, &cap_base);
+  else if (bf_entry->reg_type == PCIE_ECAP)
+      status = pcie_sysfs_find_capability(dev, PCIE_ECAP, bf_entry->ecap_id, &cap_base);
+
+  if (status != PCIE_SUCCESS)
+  {
+      /* A non root snapshot stops at 64 bytes, the capability may be past it */
+      if (dev->cfg_size < PCIE_CFG_SIZE)
+          return PCIE_SYSFS_SKIP;
+
+      if (g_sysfs_print_level <= 5)
+          printf("\n       %s : Capability 0x%x not found", dev->name,
+                 (bf_entry->reg_type == PCIE_CAP) ? bf_entry->cap_id : bf_entry->ecap_id);
+      return 1;
+  }
+
+  reg_value = pcie_sysfs_read_cfg(dev, cap_base + reg_offset);
+  if (reg_value == PCIE_UNKNOWN_RESPONSE)
+      return PCIE_SYSFS_SKIP;
+  bf_value = (reg_value >> REG_SHIFT(alignment_byte_cnt, bf_entry->start)) &
+                    REG_MASK(bf_entry->end, bf_entry->start);
+
+  if (bf_value != bf_entry->cfg_value)
+  {
+      if (g_sysfs_print_level <= 5)
+          printf("\n       %s : %s: 0x%x instead of 0x%x", dev->name,
+                 bf_entry->err_str1, bf_value, bf_entry->cfg_value);
+      if (!strncmp(bf_entry->err_str1, "WARNING", strlen("WARNING")))
+          return 0;
+      return 1;
+  }
+
+  return 0;
+}
+
+/**
+  Run the read-only PCIe checks against config space read from sysfs.
+  No kernel module is needed for these.
+
+  @return Number of failing tests
+**/
+int
+execute_tests_pcie_sysfs(unsigned int print_level)
+{
+  pcie_sysfs_test_t *test;
+  uint32_t num_fails, num_pass, test_fails = 0;
+  uint32_t dev_index, tbl_index, dp_type;
+  uint32_t status;
+
+  g_sysfs_print_level = print_level;
+
+  if (pcie_sysfs_snapshot() == 0) {
+      printf("\n       No PCIe functions found in " PCIE_SYSFS_DEVICES "\n");
+      return 0;
+  }
+
+  if (g_sysfs_dev[0].cfg_size < PCIE_CFG_SIZE)
+      printf("\n       Extended config space is not readable, run as root\n");
+
+  for (test = g_sysfs_test;
+       test < &g_sysfs_test[sizeof(g_sysfs_test) / sizeof(g_sysfs_test[0])]; test++)
+  {
+      printf("\n%4d : %s", test->test_num, test->desc);
+      num_fails = num_pass = 0;
+
+      for (dev_index = 0; dev_index < g_sysfs_num_dev; dev_index++)
+      {
+          dp_type = pcie_sysfs_device_port_type(&g_sysfs_dev[dev_index]);
+
+          for (tbl_index = 0; tbl_index < test->num_entries; tbl_index++)
+          {
+              if (!(dp_type & test->table[tbl_index].dev_port_bitmask))
+                  continue;
+
+              status = pcie_sysfs_bitfield_check(&g_sysfs_dev[dev_index],
+                                                 &test->table[tbl_index]);
+              if (status == PCIE_SYSFS_SKIP)
+                  continue;
+              if (status)
+                  num_fails++;
+              else
+                  num_pass++;
+          }
+      }
+
+      if (num_fails) {
+          printf("\n       Failed on %d bit-field(s) : FAIL", num_fails);
+          printf("\n       Checkpoint -- %s\n", test->rule);
+          test_fails++;
+      } else if (num_pass) {
+          printf(": Result:  PASS \n");
+      } else {
+          printf(": Result:  -SKIPPED- \n");
+      }
+  }
+
+  free(g_sysfs_dev);
+  g_sysfs_dev = NULL;
+  g_sysfs_num_dev = 0;
+
+  return test_fails;
+}
@@ -17,7 +17,12 @@
 
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
 
 #include <stdint.h>
 #include "include/bsa_drv_intf.h"
@@ -33,6 +38,25 @@ struct __BSA_DRV_PARMS__
     unsigned long   arg2;
 }bsa_drv_parms_t;
 
+static int             g_msg_ring_fd = -1;
+static bsa_msg_ring_t  *g_msg_ring;
+
+/* Records held back while parallel shards are running */
+typedef struct __BSA_MSG_CAPTURE__ {
+    unsigned int    test;
+    unsigned int    shard;
+    unsigned int    seq;
+    char            string[sizeof(((bsa_msg_parms_t *)0)->string)];
+}bsa_msg_capture_t;
+
+static int                g_msg_capture;
+static bsa_msg_capture_t  *g_capture_buf;
+static unsigned int       g_capture_cnt;
+static unsigned int       g_capture_max;
+static unsigned int       g_capture_last_test[BSA_PLAN_MAX_SHARDS];
+static unsigned char      g_shard_done[BSA_PLAN_MAX_SHARDS];
+static unsigned int       g_shards_done;
+
 
 int
 call_drv_get_status(unsigned long int *arg0, unsigned long int *arg1, unsigned long int *arg2)
@@ -66,15 +90,27 @@ int
 call_drv_wait_for_completion()
 {
   unsigned long int arg0, arg1, arg2;
+  struct timespec idle = {0, BSA_MSG_RING_POLL_MS * 1000000L};
 
   arg0 = DRV_STATUS_PENDING;
 
   while (arg0 == DRV_STATUS_PENDING){
+    /* Keep draining while the ring has records, /proc/bsa is only read
+       once it runs empty */
+    if (read_from_proc_bsa_msg() > 0)
+      continue;
+
     call_drv_get_status(&arg0, &arg1, &arg2);
-    read_from_proc_bsa_msg();
+
+    if (arg0 == DRV_STATUS_PENDING)
+      nanosleep(&idle, NULL);
   }
 
-  return arg1;
+  /* Pick up the records produced after the final status update */
+  while (read_from_proc_bsa_msg() > 0);
+
+  /* The module reports a non-negative status, keep -1 free for errors */
+  return (int)(arg1 & 0x7FFFFFFF);
 }
 
 
@@ -85,6 +121,8 @@ call_drv_init_test_env(unsigned int print_level)
     bsa_drv_parms_t test_params;
     int status = 0;
 
+    open_bsa_msg_ring();
+
     fd = fopen("/proc/bsa", "rw+");
     if (NULL == fd)
     {
@@ -128,6 +166,8 @@ call_drv_clean_test_env()
 
     call_drv_wait_for_completion();
 
+    close_bsa_msg_ring();
+
     return 0;
 }
 
@@ -214,22 +254,288 @@ call_update_sw_view(unsigned int api_num, int *p_sw_view)
     return 0;
 }
 
-typedef struct __BSA_MSG__ {
-    char string[92];
-    unsigned long data;
-}bsa_msg_parms_t;
+/**
+  Start a new test plan with the run wide settings.
+**/
+void
+init_test_plan(bsa_test_plan_t *plan, unsigned int num_hart, unsigned int print_level,
+  unsigned int *p_sw_view, unsigned int *p_skip_test_num)
+{
+    memset(plan, 0, sizeof(bsa_test_plan_t));
+
+    plan->api_num  = BSA_EXECUTE_TEST_PLAN;
+    plan->num_hart = num_hart;
+    plan->level    = print_level;
+    memcpy(plan->sw_view, p_sw_view, sizeof(plan->sw_view));
+    memcpy(plan->skip_test_num, p_skip_test_num, sizeof(plan->skip_test_num));
+}
+
+/**
+  Append a module to the plan. Entries are executed in the order added.
+**/
+int
+add_test_plan_entry(bsa_test_plan_t *plan, unsigned int api_num)
+{
+    if (plan->num_entries >= BSA_PLAN_MAX_ENTRIES)
+        return 1;
+
+    plan->entry[plan->num_entries++] = api_num;
+    return 0;
+}
+
+/**
+  Write the plan to the kernel module without waiting for it to complete.
+  The kernel executes the plan on the CPU the write is issued from.
+**/
+int
+call_drv_submit_plan(bsa_test_plan_t *plan)
+{
+    FILE             *fd = NULL;
+    size_t           len;
+
+    fd = fopen("/proc/bsa", "rw+");
+    if (NULL == fd)
+    {
+        printf("fopen failed\n");
+        return -1;
+    }
+
+    len = fwrite(plan, 1, sizeof(bsa_test_plan_t), fd);
+
+    if (fclose(fd) || (len != sizeof(bsa_test_plan_t)))
+        return -1;
+
+    return 0;
+}
+
+/**
+  Check that the kernel module accepted the last plan written. A module
+  that runs plans answers with BSA_EXECUTE_TEST_PLAN as the api number in
+  /proc/bsa, an older one ignores the write and keeps the previous one.
+
+  @return 1 if the plan was accepted, 0 otherwise
+**/
+int
+call_drv_plan_accepted()
+{
+    unsigned long int arg0, arg1, arg2;
+
+    return (call_drv_get_status(&arg0, &arg1, &arg2) == BSA_EXECUTE_TEST_PLAN);
+}
+
+/**
+  Submit the whole plan with a single write and wait until the kernel has
+  run every entry.
+
+  @return Status reported at completion, -1 if the plan could not be
+          submitted or the kernel module does not support plans
+**/
+int
+call_drv_execute_plan(bsa_test_plan_t *plan)
+{
+    if (call_drv_submit_plan(plan))
+        return -1;
+
+    if (!call_drv_plan_accepted())
+        return -1;
+
+    return call_drv_wait_for_completion();
+}
+
+/**
+  Map the kernel message ring. If the kernel module does not support mmap
+  of /proc/bsa_msg, messages are read back one record at a time instead.
+**/
+int
+open_bsa_msg_ring()
+{
+  void *ring;
+
+  if (g_msg_ring)
+    return 0;
+
+  g_msg_ring_fd = open("/proc/bsa_msg", O_RDWR);
+  if (g_msg_ring_fd < 0)
+    return 1;
 
+  ring = mmap(NULL, sizeof(bsa_msg_ring_t), PROT_READ | PROT_WRITE, MAP_SHARED,
+              g_msg_ring_fd, 0);
+  if (ring == MAP_FAILED) {
+    close(g_msg_ring_fd);
+    g_msg_ring_fd = -1;
+    return 1;
+  }
+
+  g_msg_ring = (bsa_msg_ring_t *)ring;
+  if ((g_msg_ring->magic != BSA_MSG_RING_MAGIC) ||
+      (g_msg_ring->num_entries != BSA_MSG_RING_ENTRIES)) {
+    close_bsa_msg_ring();
+    return 1;
+  }
+
+  return 0;
+}
+
+void
+close_bsa_msg_ring()
+{
+  if (g_msg_ring) {
+    munmap(g_msg_ring, sizeof(bsa_msg_ring_t));
+    g_msg_ring = NULL;
+  }
+
+  if (g_msg_ring_fd >= 0) {
+    close(g_msg_ring_fd);
+    g_msg_ring_fd = -1;
+  }
+}
+
+int
+bsa_msg_ring_available()
+{
+  return (g_msg_ring != NULL);
+}
+
+/**
+  While capture is enabled, ring records are buffered instead of printed so
+  that the output of concurrently running shards does not interleave.
+**/
+void
+capture_bsa_msg(int enable)
+{
+  g_msg_capture = enable;
+  memset(g_capture_last_test, 0, sizeof(g_capture_last_test));
+  memset(g_shard_done, 0, sizeof(g_shard_done));
+  g_shards_done = 0;
+}
+
+/**
+  Number of shards that have sent their BSA_MSG_SHARD_DONE record since
+  capture was enabled.
+**/
+unsigned int
+bsa_msg_shards_done()
+{
+  return g_shards_done;
+}
+
+/**
+  @return 1 if the shard has sent its BSA_MSG_SHARD_DONE record, 0 otherwise
+**/
+int
+bsa_msg_shard_done(unsigned int shard)
+{
+  return g_shard_done[shard % BSA_PLAN_MAX_SHARDS];
+}
+
+static void
+capture_msg(bsa_msg_parms_t *msg)
+{
+  bsa_msg_capture_t *buf;
+  unsigned int shard, test;
+
+  shard = BSA_MSG_TAG_SHARD(msg->data) % BSA_PLAN_MAX_SHARDS;
+  test  = BSA_MSG_TAG_TEST(msg->data);
+  if (test == BSA_MSG_SHARD_DONE) {
+    if (!g_shard_done[shard]) {
+      g_shard_done[shard] = 1;
+      g_shards_done++;
+    }
+    return;
+  }
+  if (test)
+    g_capture_last_test[shard] = test;
+
+  if (g_capture_cnt == g_capture_max) {
+    g_capture_max = g_capture_max ? (g_capture_max * 2) : BSA_MSG_RING_ENTRIES;
+    buf = realloc(g_capture_buf, g_capture_max * sizeof(bsa_msg_capture_t));
+    if (buf == NULL) {
+      /* Out of memory, print the record rather than lose it */
+      printf("%.*s", (int)sizeof(msg->string), msg->string);
+      g_capture_max = g_capture_cnt;
+      return;
+    }
+    g_capture_buf = buf;
+  }
+
+  buf = &g_capture_buf[g_capture_cnt];
+  buf->test  = g_capture_last_test[shard];
+  buf->shard = shard;
+  buf->seq   = g_capture_cnt++;
+  memcpy(buf->string, msg->string, sizeof(buf->string));
+}
+
+static int
+compare_capture(const void *a, const void *b)
+{
+  const bsa_msg_capture_t *x = a, *y = b;
+
+  if (x->test != y->test)
+    return (x->test < y->test) ? -1 : 1;
+  if (x->shard != y->shard)
+    return (x->shard < y->shard) ? -1 : 1;
+  return (x->seq < y->seq) ? -1 : (x->seq > y->seq);
+}
+
+/**
+  Print the captured records ordered by test number, then shard, then
+  arrival, and stop capturing.
+**/
+void
+flush_bsa_msg_capture()
+{
+  unsigned int i;
+
+  qsort(g_capture_buf, g_capture_cnt, sizeof(bsa_msg_capture_t), compare_capture);
+
+  for (i = 0; i < g_capture_cnt; i++)
+    printf("%.*s", (int)sizeof(g_capture_buf[i].string), g_capture_buf[i].string);
+
+  free(g_capture_buf);
+  g_capture_buf = NULL;
+  g_capture_cnt = 0;
+  g_capture_max = 0;
+  g_msg_capture = 0;
+}
+
+/**
+  Drain every record published by the kernel since the last call.
+
+  @return Number of records printed from the ring, 0 if it was empty.
+          On the procfs fallback path 0 is returned, -1 on error.
+**/
 int read_from_proc_bsa_msg() {
 
   char buf_msg[sizeof(bsa_msg_parms_t)];
 
   FILE  *fd = NULL;
-  bsa_msg_parms_t msg_params;
+  bsa_msg_parms_t *msg;
+  unsigned int head, tail;
+  int count = 0;
+
+  if (g_msg_ring) {
+    head = __atomic_load_n(&g_msg_ring->head, __ATOMIC_ACQUIRE);
+    tail = g_msg_ring->tail;
+
+    while (tail != head) {
+      msg = &g_msg_ring->msg[tail & (BSA_MSG_RING_ENTRIES - 1)];
+      if (g_msg_capture)
+        capture_msg(msg);
+      else
+        printf("%.*s", (int)sizeof(msg->string), msg->string);
+      tail++;
+      count++;
+    }
+
+    /* Release the slots back to the kernel only after they are consumed */
+    __atomic_store_n(&g_msg_ring->tail, tail, __ATOMIC_RELEASE);
+    return count;
+  }
 
   fd = fopen("/proc/bsa_msg", "r");
   if (NULL == fd) {
     printf("fopen failed\n");
-    return 1;
+    return -1;
   }
 
   /* Print Until buffer is empty */
@@ -44,4 +44,7 @@ execute_tests_peripheral(int num_hart, unsigned int print_level);
 
 int
 execute_tests_memory(int num_hart, unsigned int print_level);
+
+int
+execute_tests_pcie_sysfs(unsigned int print_level);
 #endif
@@ -29,6 +29,7 @@
 #define BSA_UPDATE_SW_VIEW       0x5000
 #define BSA_PER_EXECUTE_TEST     0x6000
 #define BSA_MEM_EXECUTE_TEST     0x7000
+#define BSA_EXECUTE_TEST_PLAN    0x8000
 #define BSA_FREE_INFO_TABLES     0x9000
 
 
@@ -36,6 +37,69 @@
 #define DRV_STATUS_AVAILABLE     0x10000000
 #define DRV_STATUS_PENDING       0x40000000
 
+/* TEST PLAN */
+
+/* A test plan carries everything needed for a run in one write: the
+   modules to execute in order, the skip list, the software view and the
+   verbosity. The kernel runs the entries back to back and streams the
+   results through the message ring. A module that supports plans
+   acknowledges the write by reporting BSA_EXECUTE_TEST_PLAN as the api
+   number of /proc/bsa; older modules ignore it. */
+#define BSA_PLAN_MAX_ENTRIES     16
+#define BSA_PLAN_MAX_SHARDS      32
+#define BSA_PLAN_MAX_SKIP        16   /* BSA_UPDATE_SKIP_LIST carries the first 3 */
+
+typedef struct __BSA_TEST_PLAN__ {
+    unsigned int    api_num;       /* BSA_EXECUTE_TEST_PLAN */
+    unsigned int    num_hart;
+    unsigned int    level;         /* Print level */
+    unsigned int    num_entries;
+    unsigned int    shard;         /* Index of this shard in the run */
+    unsigned int    pcie_shard;    /* Slice of the PCIe BDF table this shard runs */
+    unsigned int    num_shards;    /* PCIe BDF table is split this many ways */
+    unsigned int    sw_view[3];
+    unsigned int    skip_test_num[BSA_PLAN_MAX_SKIP];
+    unsigned int    entry[BSA_PLAN_MAX_ENTRIES];   /* BSA_*_EXECUTE_TEST */
+}bsa_test_plan_t;
+
+/* KERNEL MESSAGE RING */
+
+/* The kernel module exports its log records as a single producer / single
+   consumer ring through mmap() of /proc/bsa_msg. The kernel only advances
+   head and the application only advances tail, so the ring can be drained
+   without any system call. /proc/bsa_msg does not implement poll() and
+   always reads as ready, so a waiter that finds the ring empty sleeps for
+   BSA_MSG_RING_POLL_MS and then checks the status in /proc/bsa. */
+#define BSA_MSG_RING_MAGIC       0x42534152   /* "BSAR" */
+#define BSA_MSG_RING_ENTRIES     1024         /* Must be a power of 2 */
+#define BSA_MSG_RING_POLL_MS     10
+
+/* When shards run in parallel the kernel tags every record with the shard
+   it came from and the test it belongs to, so the output can be merged
+   back in test number order. Records with no test number belong to the
+   previous test of the same shard. */
+/* Every shard ends with one record whose test number is
+   BSA_MSG_SHARD_DONE, so completion is tracked per shard rather than
+   through the single status of /proc/bsa. */
+#define BSA_MSG_SHARD_DONE         0xFFFFFFFF
+#define BSA_MSG_SHARD_TIMEOUT_S    600   /* Longest a shard may stay silent */
+#define BSA_MSG_TAG(shard, test)   (((unsigned long)(shard) << 32) | (test))
+#define BSA_MSG_TAG_SHARD(data)    ((unsigned int)((data) >> 32))
+#define BSA_MSG_TAG_TEST(data)     ((unsigned int)((data) & 0xFFFFFFFF))
+
+typedef struct __BSA_MSG__ {
+    char string[92];
+    unsigned long data;
+}bsa_msg_parms_t;
+
+typedef struct __BSA_MSG_RING__ {
+    unsigned int    magic;
+    unsigned int    num_entries;
+    unsigned int    head;          /* Written by kernel only */
+    unsigned int    tail;          /* Written by application only */
+    bsa_msg_parms_t msg[BSA_MSG_RING_ENTRIES];
+}bsa_msg_ring_t;
+
 
 
 
@@ -60,6 +124,43 @@ call_update_sw_view(unsigned int api_num, int *p_sw_view);
 int
 call_drv_wait_for_completion();
 
+void
+init_test_plan(bsa_test_plan_t *plan, unsigned int num_hart, unsigned int print_level,
+  unsigned int *p_sw_view, unsigned int *p_skip_test_num);
+
+int
+add_test_plan_entry(bsa_test_plan_t *plan, unsigned int api_num);
+
+int
+call_drv_submit_plan(bsa_test_plan_t *plan);
+
+int
+call_drv_plan_accepted();
+
+int
+call_drv_execute_plan(bsa_test_plan_t *plan);
+
+int
+bsa_msg_ring_available();
+
+void
+capture_bsa_msg(int enable);
+
+void
+flush_bsa_msg_capture();
+
+unsigned int
+bsa_msg_shards_done();
+
+int
+bsa_msg_shard_done(unsigned int shard);
+
 int read_from_proc_bsa_msg();
 
+int
+open_bsa_msg_ring();
+
+void
+close_bsa_msg_ring();
+
 #endif
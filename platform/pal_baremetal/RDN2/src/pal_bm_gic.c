@@ -121,6 +121,19 @@ pal_gic_end_of_interrupt(uint32_t int_id)
   return 0;
 }
 
+/**
+  @brief  Claim the highest priority pending interrupt without going through
+          the interrupt handler. Not supported on bare-metal, interrupts are
+          only taken through the installed handlers.
+
+  @return 0, no interrupt claimed
+**/
+uint32_t
+pal_gic_claim_interrupt(void)
+{
+  return 0;
+}
+
 
 /**
  @Registers the interrupt handler for a given IRQ.
@@ -319,10 +319,10 @@ uint64_t get_mem_attr(uint32_t mem_type)
             mem_attr = ATTR_RW_DATA;
             break;
         case(MEMORY_TYPE_NOT_POPULATED):
-            mem_attr = ATTR_USER_RW | ATTR_AF | ATTR_NS; // Do not categorize mem as Dev or Normal
+            mem_attr = ATTR_PRIV_RW; // Do not categorize mem as Dev or Normal, keep the PMA type
             break;
         case(MEMORY_TYPE_RESERVED):
-            mem_attr = ATTR_PRIV_RO | ATTR_AF | ATTR_NS;
+            mem_attr = ATTR_PRIV_RO;
             break;
     }
     return mem_attr;
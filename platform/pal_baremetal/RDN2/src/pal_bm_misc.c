@@ -269,6 +269,54 @@ pal_mem_alloc_pages (uint32_t NumPages)
 #endif
 }
 
+/**
+  @brief  Allocates contiguous numpages inside the physical range
+          [Base, Base + Size). The memory pool cannot place an allocation
+          at a chosen address, so a block that does not land inside the
+          range is returned to the pool.
+
+  @return Start address of base page, NULL if the range has no room
+**/
+void *
+pal_mem_alloc_pages_in_range(uint64_t Base, uint64_t Size, uint32_t NumPages)
+{
+#ifdef ENABLE_OOB
+ /* Below code is not applicable for Bare-metal
+ * Only for FVP OOB experience
+ */
+
+  EFI_STATUS Status;
+  EFI_PHYSICAL_ADDRESS PageBase;
+
+  for (PageBase = Base; (PageBase + (uint64_t)NumPages * EFI_PAGE_SIZE) <= Base + Size;
+       PageBase += EFI_PAGE_SIZE) {
+    Status = gBS->AllocatePages (AllocateAddress,
+                                 EfiBootServicesData,
+                                 NumPages,
+                                 &PageBase);
+    if (!EFI_ERROR(Status))
+      return (VOID*)(UINTN)PageBase;
+  }
+
+  return NULL;
+#else
+  uint64_t addr;
+  void *page;
+
+  page = pal_mem_alloc_pages(NumPages);
+  if (page == NULL)
+      return NULL;
+
+  addr = (uint64_t)pal_mem_virt_to_phys(page);
+  if ((addr >= Base) && (addr + (uint64_t)NumPages * PLATFORM_PAGE_SIZE <= Base + Size))
+      return page;
+
+  /* pal_mem_free_pages does not return pages to the pool */
+  mem_free(page);
+  return NULL;
+#endif
+}
+
 /**
   @brief  frees continguous numpages starting from page
           at address PageBase
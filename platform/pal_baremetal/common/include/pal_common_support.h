@@ -181,57 +181,29 @@ void *mem_alloc(size_t alignment, size_t size);
 
 #define MEM_SIZE_64K              0x10000
 
-#define ATTR_NORMAL_NONCACHEABLE  (0x0ull << 2)
-#define ATTR_NORMAL_WB_WA_RA      (0x1ull << 2)
-#define ATTR_DEVICE               (0x2ull << 2)
-#define ATTR_NORMAL_WB            (0x1ull << 3)
-
-/* Stage 1 Inner and Outer Cacheability attribute encoding without TEX remap */
-#define ATTR_S1_NONCACHEABLE   (0x0ull << 2)
-#define ATTR_S1_WB_WA_RA       (0x1ull << 2)
-#define ATTR_S1_WT_RA          (0x2ull << 2)
-#define ATTR_S1_WB_RA          (0x3ull << 2)
-
-/* Stage 2 MemAttr[1:0] encoding for Normal memory */
-#define ATTR_S2_INNER_NONCACHEABLE   (0x1ull << 2)
-#define ATTR_S2_INNER_WT_CACHEABLE   (0x2ull << 2)
-#define ATTR_S2_INNER_WB_CACHEABLE   (0x3ull << 2)
-
-#define ATTR_NS   (0x1ull << 5)
-#define ATTR_S    (0x0ull << 5)
-
-#define ATTR_STAGE1_AP_RW    (0x1ull << 6)
-#define ATTR_STAGE2_AP_RW    (0x3ull << 6)
-#define ATTR_STAGE2_MASK     (0x3ull << 6 | 0x1ull << 4)
-#define ATTR_STAGE2_MASK_RO  (0x1ull << 6 | 0x1ull << 4)
-
-#define ATTR_NON_SHARED     (0x0ull << 8)
-#define ATTR_OUTER_SHARED   (0x2ull << 8)
-#define ATTR_INNER_SHARED   (0x3ull << 8)
-
-#define ATTR_AF     (0x1ull << 10)
-#define ATTR_nG     (0x1ull << 11)
-#define ATTR_UXN    (0x1ull << 54)
-#define ATTR_PXN    (0x1ull << 53)
-
-#define ATTR_PRIV_RW        (0x0ull << 6)
-#define ATTR_PRIV_RO        (0x2ull << 6)
-#define ATTR_USER_RW        (0x1ull << 6)
-#define ATTR_USER_RO        (0x3ull << 6)
-
-#define ATTR_CODE           (ATTR_S1_WB_WA_RA | ATTR_USER_RO | \
-                              ATTR_AF | ATTR_INNER_SHARED | ATTR_NS)
-#define ATTR_RO_DATA        (ATTR_S1_WB_WA_RA | ATTR_USER_RO | \
-                              ATTR_UXN | ATTR_PXN | ATTR_AF | \
-                              ATTR_INNER_SHARED | ATTR_NS)
-#define ATTR_RW_DATA        (ATTR_S1_WB_WA_RA | \
-                              ATTR_USER_RW | ATTR_UXN | ATTR_PXN | ATTR_AF \
-                              | ATTR_INNER_SHARED | ATTR_NS)
-#define ATTR_DEVICE_RW      (ATTR_DEVICE | ATTR_USER_RW | ATTR_UXN | \
-                              ATTR_PXN | ATTR_AF | ATTR_INNER_SHARED | ATTR_NS)
-#define ATTR_RW_DATA_NC      (ATTR_S1_NONCACHEABLE | \
-                              ATTR_USER_RW | ATTR_UXN | ATTR_PXN | ATTR_AF \
-                              | ATTR_INNER_SHARED | ATTR_NS)
+/* Leaf PTE bits of the Sv stage 1 tables built by val_pgt_create. The
+   image runs in S-mode with a single address space, so leaves are global
+   and never carry U. */
+#define ATTR_PTE_R          (0x1ull << 1)
+#define ATTR_PTE_W          (0x1ull << 2)
+#define ATTR_PTE_X          (0x1ull << 3)
+#define ATTR_PTE_G          (0x1ull << 5)
+#define ATTR_PTE_A          (0x1ull << 6)
+#define ATTR_PTE_D          (0x1ull << 7)
+
+/* Svpbmt memory type, PMA keeps the type given by the platform PMAs */
+#define ATTR_PBMT_PMA       (0x0ull << 61)
+#define ATTR_PBMT_NC        (0x1ull << 61)
+#define ATTR_PBMT_IO        (0x2ull << 61)
+
+#define ATTR_PRIV_RO        (ATTR_PTE_R | ATTR_PTE_A | ATTR_PTE_G)
+#define ATTR_PRIV_RW        (ATTR_PTE_R | ATTR_PTE_W | ATTR_PTE_A | ATTR_PTE_D | ATTR_PTE_G)
+
+#define ATTR_CODE           (ATTR_PRIV_RO | ATTR_PTE_X | ATTR_PBMT_PMA)
+#define ATTR_RO_DATA        (ATTR_PRIV_RO | ATTR_PBMT_PMA)
+#define ATTR_RW_DATA        (ATTR_PRIV_RW | ATTR_PBMT_PMA)
+#define ATTR_DEVICE_RW      (ATTR_PRIV_RW | ATTR_PBMT_IO)
+#define ATTR_RW_DATA_NC     (ATTR_PRIV_RW | ATTR_PBMT_NC)
 
 typedef struct {
   uint64_t   Arg0;
@@ -246,8 +218,23 @@ typedef struct {
 
 typedef struct {
   uint32_t num_of_hart;
+  uint32_t num_of_isa;        ///< Distinct ISA strings in isa_pool
+  uint32_t isa_pool_used;     ///< Bytes of isa_pool in use
 } HART_INFO_HDR;
 
+#define HART_MAX_ISA_STRINGS   16
+#define HART_ISA_POOL_SIZE     4096
+#define HART_ISA_NONE          0xFFFFFFFF
+#define HART_ID_INVALID        0xFFFFFFFFFFFFFFFFULL
+
+/**
+  @brief  ISA string shared by all HARTs that reference the same RHCT ISA node
+**/
+typedef struct {
+  uint32_t rhct_offset;      ///< Offset of the ISA string node in the RHCT
+  uint32_t pool_offset;      ///< Offset of the null-terminated string in isa_pool
+} HART_ISA_ENTRY;
+
 /**
   @brief  structure instance for HART entry
 **/
@@ -258,15 +245,58 @@ typedef struct {
   uint32_t   ext_intc_id;     ///< The unique ID of the external interrupts connected to this hart.
   uint64_t   imsic_base;      ///< Physical base address of the Incoming MSI Controller (IMSIC) MMIO region of this hart.
   uint32_t   imsic_size;      ///< Size in bytes of the IMSIC MMIO region of this hart.
-  char8_t    isa_string[512]; ///< Null-terminated ASCII Instruction Set Architecture (ISA) string for this hart.
+  uint32_t   cbom_block_size; ///< Zicbom cache block size in bytes from the RHCT CMO node, 0 if absent.
+  uint32_t   isa_index;       ///< Index into isa[] of the HART_INFO_TABLE, HART_ISA_NONE if absent.
 } HART_INFO_ENTRY;
 
 typedef struct {
   HART_INFO_HDR    header;
+  HART_ISA_ENTRY   isa[HART_MAX_ISA_STRINGS];
+  char8_t          isa_pool[HART_ISA_POOL_SIZE];
   HART_INFO_ENTRY  hart_info[];
 } HART_INFO_TABLE;
 
+/**  NUMA related Definitions **/
+#define NUMA_MAX_DOMAINS      16    /* SLIT distances kept for the first 16 domains */
+#define NUMA_MAX_MEM_RANGES   64
+#define NUMA_MAX_HARTS        1024
+#define NUMA_MAX_INITIATORS   32
+#define NUMA_NODE_ANY         0xFFFFFFFF
+#define NUMA_DISTANCE_LOCAL   10
+
+typedef struct {
+  uint32_t    prox_domain;
+  uint32_t    flags;                  ///< SRAT memory affinity flags
+  uint64_t    base;
+  uint64_t    length;
+}NUMA_MEM_ENTRY;
+
+typedef struct {
+  uint32_t    prox_domain;
+  uint32_t    acpi_processor_uid;     ///< From the SRAT RINTC affinity structure
+}NUMA_HART_ENTRY;
+
+typedef struct {
+  uint32_t    prox_domain;
+  uint32_t    bdf;                    ///< PCI generic initiator, PCIE_CREATE_BDF format
+}NUMA_INITIATOR_ENTRY;
+
+typedef struct {
+  uint32_t              num_domains;  ///< 0 when the platform has no SRAT
+  uint32_t              num_mem;
+  uint32_t              num_hart;
+  uint32_t              num_initiator;
+  uint8_t               distance[NUMA_MAX_DOMAINS][NUMA_MAX_DOMAINS]; ///< SLIT, 0 if absent
+  NUMA_MEM_ENTRY        mem[NUMA_MAX_MEM_RANGES];
+  NUMA_HART_ENTRY       hart[NUMA_MAX_HARTS];
+  NUMA_INITIATOR_ENTRY  initiator[NUMA_MAX_INITIATORS];
+}NUMA_INFO_TABLE;
+
+void pal_numa_create_info_table(NUMA_INFO_TABLE *numa_info_table);
+
 void pal_hart_data_cache_ops_by_va(uint64_t addr, uint32_t type);
+void pal_hart_data_cache_ops_by_range(uint64_t addr, uint64_t length, uint32_t type,
+                                      uint32_t block_size);
 
 typedef struct {
   uint32_t   gic_version;
@@ -722,5 +752,6 @@ void *pal_memcpy(void *DestinationBuffer, const void *SourceBuffer, uint32_t Len
 void *pal_strncpy(void *DestinationStr, const void *SourceStr, uint32_t Length);
 uint32_t pal_strncmp(const char8_t *str1, const char8_t *str2, uint32_t len);
 void pal_mem_set(void *buf, uint32_t size, uint8_t value);
+void pal_mem_enable_vector(uint32_t enable);
 
 #endif
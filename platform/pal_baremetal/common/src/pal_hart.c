@@ -23,6 +23,10 @@
 extern HART_INFO_TABLE platform_hart_cfg;
 extern HART_INFO_TABLE *g_hart_info_table;
 extern int32_t gPsciConduit;
+extern uint64_t g_primary_mpidr;
+
+/* g_primary_mpidr before the boot entry has recorded the boot hart */
+#define PAL_PRIMARY_MPIDR_UNSET 0xFFFFFFFFu
 
 uint8_t   *gSecondaryPeStack;
 uint64_t  gMpidrMax;
@@ -125,6 +129,7 @@ pal_hart_create_info_table(HART_INFO_TABLE *PeTable)
   }
 
   PeTable->header.num_of_hart = platform_hart_cfg.header.num_of_hart;
+  PeTable->header.num_of_isa = 0;
   if (PeTable->header.num_of_hart == 0) {
     return;
   }
@@ -135,6 +140,7 @@ pal_hart_create_info_table(HART_INFO_TABLE *PeTable)
       PeTable->hart_info[PeIndex].hart_num = PeIndex;
       PeTable->hart_info[PeIndex].pmu_gsiv = platform_hart_cfg.hart_info[PeIndex].pmu_gsiv;
       PeTable->hart_info[PeIndex].gmain_gsiv = platform_hart_cfg.hart_info[PeIndex].gmain_gsiv;
+      PeTable->hart_info[PeIndex].isa_index = HART_ISA_NONE;
       pal_hart_data_cache_ops_by_va((uint64_t)(&PeTable->hart_info[PeIndex]), CLEAN_AND_INVALIDATE);
 
       MpidrAff0Max = UPDATE_AFF_MAX(MpidrAff0Max, PeTable->hart_info[PeIndex].mpidr, 0x00000000ff);
@@ -232,6 +238,37 @@ pal_hart_data_cache_ops_by_va(uint64_t addr, uint32_t type)
 
 }
 
+/* Line size stepped by when the caller does not know the cache block size */
+#define PAL_CACHE_LINE_SIZE_DEFAULT 64
+
+/**
+  @brief Perform cache maintenance operation on an address range
+
+  @param addr       - start address of the range
+  @param length     - length of the range in bytes
+  @param type       - type of cache ops
+  @param block_size - cache block size in bytes, 0 to step by the default line size
+
+  @return  None
+**/
+void
+pal_hart_data_cache_ops_by_range(uint64_t addr, uint64_t length, uint32_t type, uint32_t block_size)
+{
+  uint64_t aligned_addr, end_addr;
+
+  /* unknown block size, still cover every line of the range */
+  if (block_size == 0)
+      block_size = PAL_CACHE_LINE_SIZE_DEFAULT;
+
+  aligned_addr = addr & ~((uint64_t)block_size - 1);
+  end_addr = addr + length;
+
+  while (aligned_addr < end_addr) {
+      pal_hart_data_cache_ops_by_va(aligned_addr, type);
+      aligned_addr += block_size;
+  }
+}
+
 /**
   @brief Returns the number of currently present PEs
 
@@ -245,3 +282,18 @@ pal_hart_get_num()
   }
   return g_hart_info_table->header.num_of_hart;
 }
+
+/**
+  @brief Returns the Hart ID of the boot hart, as recorded by the baremetal
+         boot entry in g_primary_mpidr.
+
+  @return  Hart ID of the boot hart, HART_ID_INVALID if none was recorded
+**/
+uint64_t
+pal_hart_get_boot_hart_id(void)
+{
+  if (g_primary_mpidr == PAL_PRIMARY_MPIDR_UNSET)
+      return HART_ID_INVALID;
+
+  return g_primary_mpidr;
+}
@@ -358,6 +358,123 @@ pal_target_is_bm()
   return 1;
 }
 
+#define PAL_WORD_SIZE         sizeof(uint64_t)
+#define PAL_WORD_MASK         (PAL_WORD_SIZE - 1)
+#define PAL_BYTE_PATTERN      0x0101010101010101ull
+
+/* Buffers shorter than this are not worth a vsetvli round trip */
+#define PAL_VECTOR_MIN_LEN    64
+
+/* Set by pal_mem_enable_vector() once every hart is known to implement V */
+static uint32_t g_mem_vector;
+
+#if defined(__riscv)
+#define SSTATUS_VS_INITIAL    (0x1ul << 9)
+
+/* Register groups written by the e8/m8 loops below */
+#define PAL_RVV_CLOBBER_V8_M8   "v8", "v9", "v10", "v11", "v12", "v13", "v14", "v15"
+#define PAL_RVV_CLOBBER_V16_M8  "v16", "v17", "v18", "v19", "v20", "v21", "v22", "v23"
+
+static void
+pal_mem_set_rvv(uint8_t *d, uint64_t n, uint8_t value)
+{
+  uint64_t vl;
+
+  __asm__ volatile (".option push\n\t"
+                    ".option arch, +v\n\t"
+                    "1:\n\t"
+                    "vsetvli %[vl], %[n], e8, m8, ta, ma\n\t"
+                    "vmv.v.x v8, %[val]\n\t"
+                    "vse8.v  v8, (%[d])\n\t"
+                    "add %[d], %[d], %[vl]\n\t"
+                    "sub %[n], %[n], %[vl]\n\t"
+                    "bnez %[n], 1b\n\t"
+                    ".option pop"
+                    : [vl] "=&r" (vl), [n] "+r" (n), [d] "+r" (d)
+                    : [val] "r" ((uint64_t)value)
+                    : "memory", PAL_RVV_CLOBBER_V8_M8);
+}
+
+static void
+pal_memcpy_rvv(uint8_t *d, const uint8_t *s, uint64_t n)
+{
+  uint64_t vl;
+
+  __asm__ volatile (".option push\n\t"
+                    ".option arch, +v\n\t"
+                    "1:\n\t"
+                    "vsetvli %[vl], %[n], e8, m8, ta, ma\n\t"
+                    "vle8.v  v8, (%[s])\n\t"
+                    "vse8.v  v8, (%[d])\n\t"
+                    "add %[s], %[s], %[vl]\n\t"
+                    "add %[d], %[d], %[vl]\n\t"
+                    "sub %[n], %[n], %[vl]\n\t"
+                    "bnez %[n], 1b\n\t"
+                    ".option pop"
+                    : [vl] "=&r" (vl), [n] "+r" (n), [d] "+r" (d), [s] "+r" (s)
+                    :
+                    : "memory", PAL_RVV_CLOBBER_V8_M8);
+}
+
+/* Returns the offset of the first differing byte, or -1 if the buffers match */
+static int64_t
+pal_mem_compare_rvv(const uint8_t *p1, const uint8_t *p2, uint64_t n)
+{
+  uint64_t vl;
+  int64_t idx;
+  const uint8_t *base = p1;
+
+  __asm__ volatile (".option push\n\t"
+                    ".option arch, +v\n\t"
+                    "1:\n\t"
+                    "vsetvli %[vl], %[n], e8, m8, ta, ma\n\t"
+                    "vle8.v  v8, (%[p1])\n\t"
+                    "vle8.v  v16, (%[p2])\n\t"
+                    "vmsne.vv v0, v8, v16\n\t"
+                    "vfirst.m %[idx], v0\n\t"
+                    "bgez %[idx], 2f\n\t"
+                    "add %[p1], %[p1], %[vl]\n\t"
+                    "add %[p2], %[p2], %[vl]\n\t"
+                    "sub %[n], %[n], %[vl]\n\t"
+                    "bnez %[n], 1b\n\t"
+                    "j 3f\n\t"
+                    "2:\n\t"
+                    "add %[idx], %[idx], %[p1]\n\t"
+                    "sub %[idx], %[idx], %[base]\n\t"
+                    "3:\n\t"
+                    ".option pop"
+                    : [vl] "=&r" (vl), [idx] "=&r" (idx), [n] "+r" (n),
+                      [p1] "+r" (p1), [p2] "+r" (p2)
+                    : [base] "r" (base)
+                    : "memory", "v0", PAL_RVV_CLOBBER_V8_M8, PAL_RVV_CLOBBER_V16_M8);
+
+  return idx;
+}
+#endif
+
+/**
+  @brief  Allow the memory primitives to use the RISC-V vector extension.
+          Called by VAL once the HART info table shows V on every hart, and
+          again on each secondary hart at entry since sstatus is per hart.
+
+  @param  enable  1 to use vector variants, 0 to stay on the scalar paths
+
+  @return None
+**/
+void
+pal_mem_enable_vector(uint32_t enable)
+{
+#if defined(__riscv)
+  if (enable) {
+      /* vector state must be on before the first vector instruction */
+      __asm__ volatile ("csrs sstatus, %0" : : "r" (SSTATUS_VS_INITIAL));
+  }
+  g_mem_vector = enable;
+#else
+  (void)enable;
+#endif
+}
+
 /**
   Copies a source buffer to a destination buffer, and returns the destination buffer.
 
@@ -372,16 +489,35 @@ void *
 pal_memcpy(void *DestinationBuffer, const void *SourceBuffer, uint32_t Length)
 {
 
-    uint32_t i;
-    const char *s = (char *)SourceBuffer;
-    char *d = (char *) DestinationBuffer;
+    const uint8_t *s = (const uint8_t *)SourceBuffer;
+    uint8_t *d = (uint8_t *)DestinationBuffer;
+    uint64_t n = Length;
 
-    for(i = 0; i < Length; i++)
-    {
-        d[i] = s[i];
+#if defined(__riscv)
+    if (g_mem_vector && n >= PAL_VECTOR_MIN_LEN) {
+        pal_memcpy_rvv(d, s, n);
+        return DestinationBuffer;
     }
+#endif
 
-    return d;
+    /* Word copies are only possible when both buffers share an alignment */
+    if ((((uint64_t)d ^ (uint64_t)s) & PAL_WORD_MASK) == 0) {
+        while (n && ((uint64_t)d & PAL_WORD_MASK)) {
+            *d++ = *s++;
+            n--;
+        }
+        while (n >= PAL_WORD_SIZE) {
+            *(uint64_t *)d = *(const uint64_t *)s;
+            d += PAL_WORD_SIZE;
+            s += PAL_WORD_SIZE;
+            n -= PAL_WORD_SIZE;
+        }
+    }
+
+    while (n--)
+        *d++ = *s++;
+
+    return DestinationBuffer;
 }
 
 uint32_t pal_strncmp(const char8_t *str1, const char8_t *str2, uint32_t len)
@@ -427,28 +563,74 @@ void *pal_strncpy(void *DestinationStr, const void *SourceStr, uint32_t Length)
 int32_t
 pal_mem_compare(void *Src, void *Dest, uint32_t Len)
 {
-    if (Len != 0) {
-    register const unsigned char *p1 = Dest, *p2 = Src;
+    const uint8_t *p1 = Dest, *p2 = Src;
+    uint64_t n = Len;
 
-    do {
-      if (*p1++ != *p2++)
-        return (*--p1 - *--p2);
-    } while (--Len != 0);
-  }
-  return (0);
+    if (n == 0)
+        return 0;
+
+#if defined(__riscv)
+    if (g_mem_vector && n >= PAL_VECTOR_MIN_LEN) {
+        int64_t idx = pal_mem_compare_rvv(p1, p2, n);
+
+        return (idx < 0) ? 0 : (p1[idx] - p2[idx]);
+    }
+#endif
+
+    /* Compare a word at a time, the differing byte is located below */
+    if ((((uint64_t)p1 ^ (uint64_t)p2) & PAL_WORD_MASK) == 0) {
+        while (n && ((uint64_t)p1 & PAL_WORD_MASK)) {
+            if (*p1 != *p2)
+                return (*p1 - *p2);
+            p1++;
+            p2++;
+            n--;
+        }
+        while (n >= PAL_WORD_SIZE &&
+               *(const uint64_t *)p1 == *(const uint64_t *)p2) {
+            p1 += PAL_WORD_SIZE;
+            p2 += PAL_WORD_SIZE;
+            n -= PAL_WORD_SIZE;
+        }
+    }
+
+    while (n--) {
+        if (*p1 != *p2)
+            return (*p1 - *p2);
+        p1++;
+        p2++;
+    }
+
+    return 0;
 }
 
 void
 pal_mem_set(void *buf, uint32_t size, uint8_t value)
 {
-    unsigned char *ptr = buf;
+    uint8_t *ptr = buf;
+    uint64_t n = size;
+    uint64_t pattern = PAL_BYTE_PATTERN * value;
+
+#if defined(__riscv)
+    if (g_mem_vector && n >= PAL_VECTOR_MIN_LEN) {
+        pal_mem_set_rvv(ptr, n, value);
+        return;
+    }
+#endif
 
-    while (size--)
-    {
-        *ptr++ = (unsigned char)value;
+    while (n && ((uint64_t)ptr & PAL_WORD_MASK)) {
+        *ptr++ = value;
+        n--;
+    }
+
+    while (n >= PAL_WORD_SIZE) {
+        *(uint64_t *)ptr = pattern;
+        ptr += PAL_WORD_SIZE;
+        n -= PAL_WORD_SIZE;
     }
 
-    return (void) buf;
+    while (n--)
+        *ptr++ = value;
 }
 
 /* The functions implemented below are to enable console prints via UART driver */
@@ -668,3 +850,20 @@ pal_dump_dtb()
 {
   print(ACS_PRINT_ERR, " DTB dump not available for platform initialized with ACPI table\n", 0);
 }
+
+/**
+  @brief  Baremetal platforms describe no proximity domains, all memory is
+          treated as uniform.
+
+  @param  numa_info_table  Address where the NUMA information needs to be filled.
+
+  @return None
+**/
+void
+pal_numa_create_info_table(NUMA_INFO_TABLE *numa_info_table)
+{
+  if (numa_info_table == NULL)
+      return;
+
+  pal_mem_set(numa_info_table, sizeof(NUMA_INFO_TABLE), 0);
+}
@@ -82,6 +82,26 @@ pal_timer_get_counter_frequency(void)
   return PLATFORM_BM_TIMER_CNTFRQ;
 }
 
+/**
+  @brief  This API returns the current value of the hart local time counter
+
+  @param  None
+
+  @return Counter value in ticks of the timebase frequency
+**/
+uint64_t
+pal_timer_get_counter(void)
+{
+#if defined(__riscv)
+  uint64_t count;
+
+  __asm__ volatile ("rdtime %0" : "=r" (count));
+  return count;
+#else
+  return 0;
+#endif
+}
+
 
 /**
   @brief  This API fills in the WD_INFO_TABLE with information about Watchdogs
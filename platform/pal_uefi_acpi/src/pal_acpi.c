@@ -371,3 +371,69 @@ pal_get_fadt_ptr (
 
   return 0;
 }
+
+/**
+  @brief   Iterate through the tables pointed by XSDT and return SRAT Table address
+  @param   None
+  @return  64-bit address of SRAT table
+  @retval  0:  SRAT table could not be found
+**/
+UINT64
+pal_get_srat_ptr (
+  VOID
+  )
+{
+  EFI_ACPI_DESCRIPTION_HEADER   *Xsdt;
+  UINT64                        *Entry64;
+  UINT32                        Entry64Num;
+  UINT32                        Idx;
+
+  Xsdt = (EFI_ACPI_DESCRIPTION_HEADER *) pal_get_xsdt_ptr();
+  if (Xsdt == NULL) {
+      bsa_print(ACS_PRINT_ERR, L" XSDT not found\n");
+      return 0;
+  }
+
+  Entry64 = (UINT64 *)(Xsdt + 1);
+  Entry64Num = (Xsdt->Length - sizeof (EFI_ACPI_DESCRIPTION_HEADER)) >> 3;
+  for (Idx = 0; Idx < Entry64Num; Idx++) {
+    if (*(UINT32 *)(UINTN)(Entry64[Idx]) == EFI_ACPI_6_1_SYSTEM_RESOURCE_AFFINITY_TABLE_SIGNATURE) {
+      return (UINT64)(Entry64[Idx]);
+    }
+  }
+
+  return 0;
+}
+
+/**
+  @brief   Iterate through the tables pointed by XSDT and return SLIT Table address
+  @param   None
+  @return  64-bit address of SLIT table
+  @retval  0:  SLIT table could not be found
+**/
+UINT64
+pal_get_slit_ptr (
+  VOID
+  )
+{
+  EFI_ACPI_DESCRIPTION_HEADER   *Xsdt;
+  UINT64                        *Entry64;
+  UINT32                        Entry64Num;
+  UINT32                        Idx;
+
+  Xsdt = (EFI_ACPI_DESCRIPTION_HEADER *) pal_get_xsdt_ptr();
+  if (Xsdt == NULL) {
+      bsa_print(ACS_PRINT_ERR, L" XSDT not found\n");
+      return 0;
+  }
+
+  Entry64 = (UINT64 *)(Xsdt + 1);
+  Entry64Num = (Xsdt->Length - sizeof (EFI_ACPI_DESCRIPTION_HEADER)) >> 3;
+  for (Idx = 0; Idx < Entry64Num; Idx++) {
+    if (*(UINT32 *)(UINTN)(Entry64[Idx]) == EFI_ACPI_6_1_SYSTEM_LOCALITY_INFORMATION_TABLE_SIGNATURE) {
+      return (UINT64)(Entry64[Idx]);
+    }
+  }
+
+  return 0;
+}
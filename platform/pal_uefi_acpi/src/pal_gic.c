@@ -25,17 +25,50 @@
 #include <Protocol/HardwareInterrupt.h>
 #include <Protocol/HardwareInterrupt2.h>
 
+#include <sbi/riscv_asm.h>
+#include <sbi/riscv_encoding.h>
+
 #include "include/pal_uefi.h"
 #include "include/bsa_pcie_enum.h"
 
+/* Supervisor indirect CSR access and top external interrupt */
+#define PAL_CSR_SISELECT        0x150
+#define PAL_CSR_SIREG           0x151
+#define PAL_CSR_STOPEI          0x15C
+#define PAL_IMSIC_EIP0          0x80
+#define PAL_IMSIC_TOPEI_SHIFT   16
+
 static EFI_ACPI_6_1_MULTIPLE_APIC_DESCRIPTION_TABLE_HEADER *gMadtHdr;
 
 EFI_HARDWARE_INTERRUPT_PROTOCOL *gInterrupt = NULL;
 EFI_HARDWARE_INTERRUPT2_PROTOCOL *gInterrupt2 = NULL;
 
+/* Set when the MADT describes an IMSIC, interrupts are then claimed and
+   completed through stopei and the eip registers instead of the protocol */
+static BOOLEAN gImsicPresent = FALSE;
+
 UINT64
 pal_get_madt_ptr();
 
+/**
+  @brief  Look up the hardware interrupt protocols once. Later calls return
+          the cached handles.
+
+  @return None
+**/
+static
+VOID
+pal_gic_locate_protocols (
+  VOID
+  )
+{
+  if (gInterrupt == NULL)
+    gBS->LocateProtocol (&gHardwareInterruptProtocolGuid, NULL, (VOID **)&gInterrupt);
+
+  if (gInterrupt2 == NULL)
+    gBS->LocateProtocol (&gHardwareInterrupt2ProtocolGuid, NULL, (VOID **)&gInterrupt2);
+}
+
 /**
   @brief  Populate information about the IIC sub-system at the input address.
           In a UEFI-ACPI framework, this information is part of the MADT table.
@@ -49,6 +82,8 @@ pal_gic_create_info_table(GIC_INFO_TABLE *GicTable)
 {
   EFI_ACPI_6_1_GIC_STRUCTURE    *Entry = NULL;
   EFI_ACPI_6_5_IMSIC_STRUCTURE  *ImsicEntry = NULL;
+  EFI_ACPI_6_5_APLIC_STRUCTURE  *AplicEntry = NULL;
+  EFI_ACPI_6_5_PLIC_STRUCTURE   *PlicEntry = NULL;
   GIC_INFO_ENTRY                *GicEntry = NULL;
   UINT32                         Length= 0;
   UINT32                         TableLength;
@@ -67,6 +102,7 @@ pal_gic_create_info_table(GIC_INFO_TABLE *GicTable)
   GicTable->header.num_gicd = 0;
   GicTable->header.num_its = 0;
   GicTable->header.num_msi_frame = 0;
+  GicTable->header.num_aplic = 0;
 
   gMadtHdr = (EFI_ACPI_6_1_MULTIPLE_APIC_DESCRIPTION_TABLE_HEADER *) pal_get_madt_ptr();
 
@@ -104,11 +140,43 @@ pal_gic_create_info_table(GIC_INFO_TABLE *GicTable)
       bsa_print(ACS_PRINT_INFO, L"   RISC-V IMSIC is found\n");
       GicTable->header.supervisor_intr_num = ImsicEntry->SupervisorModeInterruptIdentityNumber;
       GicTable->header.guest_intr_num = ImsicEntry->GuestModeInterruptIdentityNumber;
+      GicTable->header.guest_index_bits = ImsicEntry->GuestIndexBits;
+      GicTable->header.hart_index_bits = ImsicEntry->HartIndexBits;
+      GicTable->header.group_index_bits = ImsicEntry->GroupIndexBits;
+      /* the last field is the group index shift, named HartIndexShift in the header */
+      GicTable->header.group_index_shift = ImsicEntry->HartIndexShift;
+      gImsicPresent = TRUE;
+    }
+
+    if (Entry->Type == EFI_ACPI_6_5_APLIC) {
+      AplicEntry = (EFI_ACPI_6_5_APLIC_STRUCTURE *) Entry;
+      GicEntry->type = ENTRY_TYPE_APLIC;
+      GicEntry->base = AplicEntry->APLICAddress;
+      GicEntry->length = AplicEntry->APLICSize;
+      GicEntry->entry_id = AplicEntry->APLICId;
+      GicEntry->flags = AplicEntry->Flags;
+      GicEntry->spi_count = AplicEntry->ExternalInterruptSources;
+      GicEntry->spi_base = AplicEntry->GlobalSystemInterruptBase;
+      GicEntry->num_idc = AplicEntry->IDCNumber;
+      bsa_print(ACS_PRINT_INFO, L"   RISC-V APLIC %d is found at 0x%lx\n", GicEntry->entry_id, GicEntry->base);
+      bsa_print(ACS_PRINT_DEBUG, L"    Sources %d GSI base %d", GicEntry->spi_count, GicEntry->spi_base);
+      bsa_print(ACS_PRINT_DEBUG, L" IDCs %d\n", GicEntry->num_idc);
+      GicTable->header.num_aplic++;
+      GicEntry++;
     }
 
     if (Entry->Type == EFI_ACPI_6_5_PLIC) {
+      PlicEntry = (EFI_ACPI_6_5_PLIC_STRUCTURE *) Entry;
       GicEntry->type = ENTRY_TYPE_PLIC;
-      bsa_print(ACS_PRINT_INFO, L"   RISC-V PLIC is found, record field TBD\n");
+      GicEntry->base = PlicEntry->PLICAddress;
+      GicEntry->length = PlicEntry->PLICSize;
+      GicEntry->entry_id = PlicEntry->PLICId;
+      GicEntry->flags = PlicEntry->Flags;
+      GicEntry->spi_count = PlicEntry->ExternalInterruptSources;
+      GicEntry->spi_base = PlicEntry->GSIV;
+      GicEntry->num_idc = 0;
+      bsa_print(ACS_PRINT_INFO, L"   RISC-V PLIC %d is found at 0x%lx\n", GicEntry->entry_id, GicEntry->base);
+      GicEntry++;
     }
 
     Length += Entry->Length;
@@ -117,6 +185,8 @@ pal_gic_create_info_table(GIC_INFO_TABLE *GicTable)
 
   GicEntry->type = 0xFF;  //Indicate end of data
 
+  /* resolve the interrupt protocols here rather than on every ISR install or EOI */
+  pal_gic_locate_protocols();
 }
 
 /**
@@ -124,7 +194,10 @@ pal_gic_create_info_table(GIC_INFO_TABLE *GicTable)
           the interrupt service routine for the IRQ to the UEFI Framework
 
   @param  int_id  Interrupt ID which needs to be enabled and service routine installed for
-  @param  isr     Function pointer of the Interrupt service routine
+  @param  isr     Function pointer of the Interrupt service routine. It is registered
+                  as a HARDWARE_INTERRUPT_HANDLER, so it is called as
+                  isr(Source, SystemContext) with the interrupt ID as Source.
+                  val_gic_isr_dispatch relies on this to find the identity.
 
   @return Status of the operation
 **/
@@ -134,9 +207,8 @@ pal_gic_install_isr(UINT32 int_id,  VOID (*isr)())
 
   EFI_STATUS  Status;
 
- // Find the interrupt controller protocol.
-  Status = gBS->LocateProtocol (&gHardwareInterruptProtocolGuid, NULL, (VOID **)&gInterrupt);
-  if (EFI_ERROR(Status)) {
+  pal_gic_locate_protocols();
+  if (gInterrupt == NULL) {
     return 0xFFFFFFFF;
   }
 
@@ -166,11 +238,16 @@ UINT32
 pal_gic_end_of_interrupt(UINT32 int_id)
 {
 
-  EFI_STATUS  Status;
+  /* MSIs have no end of interrupt, completing is clearing the pending bit,
+     which is already clear if the handler claimed through stopei */
+  if (gImsicPresent) {
+    csr_write(PAL_CSR_SISELECT, PAL_IMSIC_EIP0 + (int_id / __riscv_xlen) * (__riscv_xlen / 32));
+    csr_clear(PAL_CSR_SIREG, 1UL << (int_id % __riscv_xlen));
+    return 0;
+  }
 
- // Find the interrupt controller protocol.
-  Status = gBS->LocateProtocol (&gHardwareInterruptProtocolGuid, NULL, (VOID **)&gInterrupt);
-  if (EFI_ERROR(Status)) {
+  pal_gic_locate_protocols();
+  if (gInterrupt == NULL) {
     return 0xFFFFFFFF;
   }
 
@@ -194,9 +271,8 @@ pal_gic_set_intr_trigger(UINT32 int_id, INTR_TRIGGER_INFO_TYPE_e trigger_type)
 
   EFI_STATUS  Status;
 
-  /* Find the interrupt protocol. */
-  Status = gBS->LocateProtocol (&gHardwareInterrupt2ProtocolGuid, NULL, (VOID **)&gInterrupt2);
-  if (EFI_ERROR(Status)) {
+  pal_gic_locate_protocols();
+  if (gInterrupt2 == NULL) {
     return 0xFFFFFFFF;
   }
 
@@ -212,6 +288,24 @@ pal_gic_set_intr_trigger(UINT32 int_id, INTR_TRIGGER_INFO_TYPE_e trigger_type)
   return 0;
 }
 
+/**
+  @brief  Claim the highest priority pending and enabled interrupt of the
+          S-level interrupt file with a single stopei swap, without going
+          through the interrupt protocol.
+
+  @return Claimed interrupt ID, 0 if none is pending or there is no IMSIC
+**/
+UINT32
+pal_gic_claim_interrupt (
+  VOID
+  )
+{
+  if (!gImsicPresent)
+    return 0;
+
+  return (UINT32)(csr_swap(PAL_CSR_STOPEI, 0) >> PAL_IMSIC_TOPEI_SHIFT);
+}
+
 /** Place holder function. Need to be implemented if needed in later releases
   @brief Registers the interrupt handler for a given IRQ
 
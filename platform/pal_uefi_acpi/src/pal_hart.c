@@ -22,6 +22,7 @@
 #include "Include/IndustryStandard/Acpi61.h"
 #include <Protocol/AcpiTable.h>
 #include <Protocol/Cpu.h>
+#include <Protocol/RiscVBootProtocol.h>
 
 #include <sbi/riscv_asm.h>
 #include <sbi/riscv_encoding.h>
@@ -114,6 +115,38 @@ pal_hart_get_num()
   return (UINT32)g_num_hart;
 }
 
+/**
+  @brief  Return the Hart ID of the hart that loaded the application, as
+          reported by the RISC-V EFI boot protocol.
+
+  @param  None
+
+  @return Hart ID, or HART_ID_INVALID if the protocol is not installed
+**/
+UINT64
+pal_hart_get_boot_hart_id (
+  VOID
+  )
+{
+  EFI_STATUS               Status;
+  RISCV_EFI_BOOT_PROTOCOL  *BootProtocol;
+  UINTN                    BootHartId;
+
+  Status = gBS->LocateProtocol (&gRiscVEfiBootProtocolGuid, NULL, (VOID **)&BootProtocol);
+  if (EFI_ERROR (Status)) {
+    bsa_print(ACS_PRINT_WARN, L" RISC-V boot protocol not found\n");
+    return HART_ID_INVALID;
+  }
+
+  Status = BootProtocol->GetBootHartId (BootProtocol, &BootHartId);
+  if (EFI_ERROR (Status)) {
+    bsa_print(ACS_PRINT_WARN, L" GetBootHartId failed %r\n", Status);
+    return HART_ID_INVALID;
+  }
+
+  return (UINT64)BootHartId;
+}
+
 /**
   @brief   Returns the Max of each 8-bit Affinity fields in MPIDR.
   @param   None
@@ -177,6 +210,60 @@ PalAllocateSecondaryStack(UINT64 mpidr)
 
 }
 
+/* RHCT CMO extension node, block sizes are encoded as log2 of the size in bytes */
+#pragma pack(1)
+typedef struct {
+  EFI_ACPI_6_5_RHCT_NODE_HEADER  Header;
+  UINT8                          Reserved;
+  UINT8                          CbomBlockSize;
+  UINT8                          CbopBlockSize;
+  UINT8                          CbozBlockSize;
+} PAL_RHCT_CMO_NODE;
+#pragma pack()
+
+/**
+  @brief  Return the isa[] index of an RHCT ISA string node, copying the string
+          into the pool the first time the node is referenced. Harts sharing
+          a node share the string.
+
+  @param  PeTable        - HART information table
+  @param  NodeOffset     - Offset of the ISA string node in the RHCT
+  @param  IsaStringNode  - The ISA string node
+
+  @return Index into PeTable->isa, HART_ISA_NONE if the pool is full
+**/
+static
+UINT32
+pal_hart_intern_isa_string (
+  HART_INFO_TABLE                             *PeTable,
+  UINT32                                      NodeOffset,
+  EFI_ACPI_6_5_RHCT_ISA_STRING_NODE_STRUCTURE *IsaStringNode
+  )
+{
+  HART_INFO_HDR  *Hdr = &PeTable->header;
+  UINT32         Index;
+
+  for (Index = 0; Index < Hdr->num_of_isa; Index++) {
+    if (PeTable->isa[Index].rhct_offset == NodeOffset)
+      return Index;
+  }
+
+  if (Hdr->num_of_isa >= HART_MAX_ISA_STRINGS ||
+      Hdr->isa_pool_used + IsaStringNode->ISALength + 1 > HART_ISA_POOL_SIZE) {
+    bsa_print(ACS_PRINT_ERR, L"      Error: ISA string pool full, length %d\n", IsaStringNode->ISALength);
+    return HART_ISA_NONE;
+  }
+
+  Index = Hdr->num_of_isa++;
+  PeTable->isa[Index].rhct_offset = NodeOffset;
+  PeTable->isa[Index].pool_offset = Hdr->isa_pool_used;
+  CopyMem(&PeTable->isa_pool[Hdr->isa_pool_used], IsaStringNode->ISAString, IsaStringNode->ISALength);
+  PeTable->isa_pool[Hdr->isa_pool_used + IsaStringNode->ISALength] = 0;
+  Hdr->isa_pool_used += IsaStringNode->ISALength + 1;
+
+  return Index;
+}
+
 /**
   @brief  This API fills in the HART_INFO Table with information about the PEs in the
           system. This is achieved by parsing the ACPI - MADT table.
@@ -192,6 +279,7 @@ pal_hart_create_info_table(HART_INFO_TABLE *PeTable)
   EFI_ACPI_6_5_RHCT_NODE_HEADER               *RhctNodeEntry = NULL;
   EFI_ACPI_6_5_RHCT_HART_INFO_NODE_STRUCTURE  *HartInfoNode = NULL;
   EFI_ACPI_6_5_RHCT_ISA_STRING_NODE_STRUCTURE *IsaStringNode = NULL;
+  PAL_RHCT_CMO_NODE                           *CmoNode = NULL;
   HART_INFO_ENTRY                               *Ptr = NULL;
   UINT32                                      MadtTableLength = 0;
   UINT32                                      RhctTableLength = 0;
@@ -205,8 +293,10 @@ pal_hart_create_info_table(HART_INFO_TABLE *PeTable)
     return;
   }
 
-  /* initialise number of PEs to zero */
+  /* initialise number of PEs and interned ISA strings to zero */
   PeTable->header.num_of_hart = 0;
+  PeTable->header.num_of_isa = 0;
+  PeTable->header.isa_pool_used = 0;
 
   gMadtHdr = (EFI_ACPI_6_1_MULTIPLE_APIC_DESCRIPTION_TABLE_HEADER *) pal_get_madt_ptr();
 
@@ -251,6 +341,8 @@ pal_hart_create_info_table(HART_INFO_TABLE *PeTable)
         Ptr->ext_intc_id = Entry->ExternalINTCId;
         Ptr->imsic_base = Entry->IMSICBase;
         Ptr->imsic_size = Entry->IMSICSize;
+        Ptr->cbom_block_size = 0;
+        Ptr->isa_index = HART_ISA_NONE;
         bsa_print(ACS_PRINT_DEBUG, L"  HartID 0x%lx HART num 0x%x\n", Ptr->hart_id, Ptr->hart_num);
         bsa_print(ACS_PRINT_DEBUG, L"    Processor UID %d\n", Ptr->acpi_processor_uid);
         bsa_print(ACS_PRINT_DEBUG, L"    IMSIC Base 0x%lx IMSIC Size 0x%x\n", Ptr->imsic_base, Ptr->imsic_size);
@@ -268,15 +360,16 @@ pal_hart_create_info_table(HART_INFO_TABLE *PeTable)
               switch (RhctNodeEntry->Type) {
                 case EFI_ACPI_6_5_RHCT_NODE_TYPE_ISA_STRING_NODE:
                   IsaStringNode = (EFI_ACPI_6_5_RHCT_ISA_STRING_NODE_STRUCTURE *) RhctNodeEntry;
-                  if (IsaStringNode->ISALength > sizeof(Ptr->isa_string)) {
-                    bsa_print(ACS_PRINT_ERR, L"      Error: ISA String size overflow %d\n", IsaStringNode->ISALength);
-                  }
-                  CopyMem(Ptr->isa_string, IsaStringNode->ISAString, IsaStringNode->ISALength);
-                  bsa_print(ACS_PRINT_INFO, L"      ISA string found: %a\n", Ptr->isa_string);
+                  Ptr->isa_index = pal_hart_intern_isa_string(PeTable, HartInfoNode->Offsets[Index2],
+                                                              IsaStringNode);
+                  bsa_print(ACS_PRINT_INFO, L"      ISA string found, pool index %d\n", Ptr->isa_index);
                   break;
 
                 case EFI_ACPI_6_5_RHCT_NODE_TYPE_CMO_EXTENSION_NODE:
-                  bsa_print(ACS_PRINT_INFO, L"      CMO found\n");
+                  CmoNode = (PAL_RHCT_CMO_NODE *) RhctNodeEntry;
+                  if (CmoNode->CbomBlockSize != 0)
+                    Ptr->cbom_block_size = 1u << CmoNode->CbomBlockSize;
+                  bsa_print(ACS_PRINT_INFO, L"      CMO found, CBOM block size %d\n", Ptr->cbom_block_size);
                   break;
 
                 case EFI_ACPI_6_5_RHCT_NODE_TYPE_MMU_NODE:
@@ -460,6 +553,64 @@ pal_hart_data_cache_ops_by_va(UINT64 addr, UINT32 type)
   }
 }
 
+/* Zicbom instructions on the block addressed by a0, encoded directly as the
+   toolchain assembler may predate the cbo.* mnemonics */
+#define CBO_INVAL_A0  ".word 0x0005200F"
+#define CBO_CLEAN_A0  ".word 0x0015200F"
+#define CBO_FLUSH_A0  ".word 0x0025200F"
+
+#define CBO_RANGE(insn, start, end, block_size)                          \
+  do {                                                                    \
+    register UINT64 _Addr __asm__("a0");                                  \
+    for (_Addr = (start); _Addr < (end); _Addr += (block_size))           \
+      __asm__ volatile (insn : : "r"(_Addr) : "memory");                  \
+  } while (0)
+
+/**
+  @brief Perform cache maintenance operation on an address range. With Zicbom
+         one cbo.* is issued per cache block followed by a single fence, else
+         one whole cache fence is issued for the entire range.
+
+  @param addr       - start address of the range
+  @param length     - length of the range in bytes
+  @param type       - type of cache ops
+  @param block_size - Zicbom cache block size in bytes, 0 if Zicbom is absent
+
+  @return  None
+**/
+VOID
+pal_hart_data_cache_ops_by_range(UINT64 addr, UINT64 length, UINT32 type, UINT32 block_size)
+{
+  UINT64 Start, End;
+
+  if (length == 0)
+    return;
+
+  if (block_size == 0) {
+    pal_hart_data_cache_ops_by_va(addr, type);
+    return;
+  }
+
+  Start = addr & ~((UINT64)block_size - 1);
+  End   = addr + length;
+
+  switch(type){
+      case CLEAN:
+          CBO_RANGE(CBO_CLEAN_A0, Start, End, block_size);
+      break;
+      case INVALIDATE:
+          CBO_RANGE(CBO_INVAL_A0, Start, End, block_size);
+      break;
+      case CLEAN_AND_INVALIDATE:
+      default:
+          CBO_RANGE(CBO_FLUSH_A0, Start, End, block_size);
+  }
+
+  /* order the block operations, and keep the instruction fetch coherent
+     as the per address fallback does */
+  __asm__ volatile ("fence rw, rw\n\tfence.i" : : : "memory");
+}
+
 UINT64
 pal_hart_get_hstatus (void)
 {
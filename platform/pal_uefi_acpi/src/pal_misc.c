@@ -313,6 +313,22 @@ pal_mem_set (
   SetMem(Buf, Size, Value);
 }
 
+/**
+  @brief  Allow the memory primitives to use vector instructions. The UEFI
+          BaseMemoryLib routines are used as is, so this is a no-op.
+
+  @param  Enable  1 if every hart implements the vector extension
+
+  @return None
+**/
+VOID
+pal_mem_enable_vector (
+  UINT32 Enable
+  )
+{
+  (VOID)Enable;
+}
+
 /**
   @brief  Allocate memory which is to be used to share data across PEs
 
@@ -700,6 +716,48 @@ pal_mem_free_aligned(VOID *Buffer)
     }
 }
 
+/**
+  @brief Allocates the requested number of pages inside a physical address range.
+         Candidate bases are tried on 2MiB boundaries so that large buffers are
+         not split across superpage mappings.
+
+  @param Base      Start of the physical range
+  @param Size      Size of the physical range in bytes
+  @param NumPages  Number of memory pages needed
+
+  @return Address of the allocated space, NULL if no candidate was free
+**/
+VOID *
+pal_mem_alloc_pages_in_range (
+  UINT64 Base,
+  UINT64 Size,
+  UINT32 NumPages
+  )
+{
+  EFI_STATUS           Status;
+  EFI_PHYSICAL_ADDRESS PageBase;
+  UINT64               Length;
+  UINT64               End;
+  UINT32               Tries;
+
+  Length   = (UINT64)NumPages * EFI_PAGE_SIZE;
+  End      = Base + Size;
+  PageBase = (Base + SIZE_2MB - 1) & ~((UINT64)SIZE_2MB - 1);
+
+  for (Tries = 0; Tries < 64 && (PageBase + Length) <= End; Tries++) {
+    Status = gBS->AllocatePages (AllocateAddress,
+                                 EfiBootServicesData,
+                                 NumPages,
+                                 &PageBase);
+    if (!EFI_ERROR(Status))
+      return (VOID*)(UINTN)PageBase;
+
+    PageBase += SIZE_2MB;
+  }
+
+  return NULL;
+}
+
 /**
   @brief Free number of pages in the memory as requested.
 
@@ -717,29 +775,44 @@ pal_mem_free_pages(
   gBS->FreePages((EFI_PHYSICAL_ADDRESS)(UINTN)PageBase, NumPages);
 }
 
-VOID
+/* CPU arch protocol, located once on first use */
+static EFI_CPU_ARCH_PROTOCOL *mCpuArch;
+
+/**
+  @brief  Map a device memory region as uncached.
+
+  @param  Address  Start address of the region
+  @param  Size     Size of the region in bytes
+
+  @return 0 - Success, 1 - Failure
+**/
+UINT32
 pal_mem_map_add_mmio (
   UINT64  Address,
   UINT64  Size
   )
 {
   EFI_STATUS  Status;
-  EFI_CPU_ARCH_PROTOCOL   *Cpu;
 
   /* Check Whether Cpu architectural protocol is installed */
-  Status = gBS->LocateProtocol ( &gEfiCpuArchProtocolGuid, NULL, (VOID **)&Cpu);
-  if (EFI_ERROR(Status)) {
-    bsa_print(ACS_PRINT_ERR, L" Could not get Cpu Arch Protocol %x\n", Status);
-    return;
+  if (mCpuArch == NULL) {
+    Status = gBS->LocateProtocol ( &gEfiCpuArchProtocolGuid, NULL, (VOID **)&mCpuArch);
+    if (EFI_ERROR(Status)) {
+      bsa_print(ACS_PRINT_ERR, L" Could not get Cpu Arch Protocol %x\n", Status);
+      mCpuArch = NULL;
+      return 1;
+    }
   }
 
   /* Set Memory Attributes */
-  Status = Cpu->SetMemoryAttributes (Cpu,
-                                     Address,
-                                     Size,
-                                     EFI_MEMORY_UC | EFI_MEMORY_RUNTIME);
+  Status = mCpuArch->SetMemoryAttributes (mCpuArch,
+                                          Address,
+                                          Size,
+                                          EFI_MEMORY_UC | EFI_MEMORY_RUNTIME);
   if (EFI_ERROR (Status)) {
     bsa_print(ACS_PRINT_ERR, L" Could not Set Memory Attribute %x\n", Status);
-    return;
+    return 1;
   }
+
+  return 0;
 }
\ No newline at end of file
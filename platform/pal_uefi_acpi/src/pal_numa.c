@@ -0,0 +1,184 @@
+/** @file
+ * Copyright (c) 2016-2023, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+**/
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiLib.h>
+
+#include "Include/IndustryStandard/Acpi65.h"
+#include <Protocol/AcpiTable.h>
+
+#include "include/pal_uefi.h"
+
+UINT64
+pal_get_srat_ptr();
+
+UINT64
+pal_get_slit_ptr();
+
+#define PAL_SRAT_TYPE_MEMORY            1
+#define PAL_SRAT_TYPE_GENERIC_INITIATOR 5
+#define PAL_SRAT_TYPE_RINTC             7
+
+#define PAL_SRAT_ENABLED                0x1
+#define PAL_SRAT_DEVICE_HANDLE_PCI      1
+
+#pragma pack(1)
+/* SRAT RINTC affinity structure (ACPI 6.6), links an ACPI processor UID to a domain */
+typedef struct {
+  UINT8   Type;
+  UINT8   Length;
+  UINT16  Reserved;
+  UINT32  ProximityDomain;
+  UINT32  AcpiProcessorUid;
+  UINT32  Flags;
+  UINT32  ClockDomain;
+} PAL_SRAT_RINTC_AFFINITY;
+
+/* SRAT generic initiator affinity structure with a PCI device handle */
+typedef struct {
+  UINT8   Type;
+  UINT8   Length;
+  UINT8   Reserved1;
+  UINT8   DeviceHandleType;
+  UINT32  ProximityDomain;
+  UINT16  PciSegment;
+  UINT16  PciBdf;
+  UINT8   Reserved2[12];
+  UINT32  Flags;
+  UINT32  Reserved3;
+} PAL_SRAT_GI_AFFINITY;
+#pragma pack()
+
+/**
+  @brief  Record the highest proximity domain seen so far.
+**/
+static
+VOID
+pal_numa_note_domain(NUMA_INFO_TABLE *NumaTable, UINT32 Domain)
+{
+  if (Domain + 1 > NumaTable->num_domains)
+    NumaTable->num_domains = Domain + 1;
+}
+
+/**
+  @brief  Populate the proximity domain information of memory ranges, harts
+          and PCI initiators from the SRAT, and the domain distances from the
+          SLIT. Platforms without an SRAT report zero domains.
+
+  @param  NumaTable  Address of the memory region where this information is to be filled in
+
+  @return None
+**/
+VOID
+pal_numa_create_info_table(NUMA_INFO_TABLE *NumaTable)
+{
+  EFI_ACPI_DESCRIPTION_HEADER                                   *Srat;
+  EFI_ACPI_6_5_SYSTEM_LOCALITY_DISTANCE_INFORMATION_TABLE_HEADER *Slit;
+  EFI_ACPI_6_5_MEMORY_AFFINITY_STRUCTURE                        *MemEntry;
+  PAL_SRAT_RINTC_AFFINITY                                       *HartEntry;
+  PAL_SRAT_GI_AFFINITY                                          *GiEntry;
+  UINT8                                                         *Entry;
+  UINT8                                                         *End;
+  UINT8                                                         *Matrix;
+  UINT64                                                        Localities;
+  UINT32                                                        Row, Col;
+
+  if (NumaTable == NULL) {
+    bsa_print(ACS_PRINT_ERR, L" Input NUMA Table Pointer is NULL. Cannot create NUMA INFO\n");
+    return;
+  }
+
+  ZeroMem(NumaTable, sizeof (NUMA_INFO_TABLE));
+
+  Srat = (EFI_ACPI_DESCRIPTION_HEADER *) pal_get_srat_ptr();
+  if (Srat == NULL) {
+    bsa_print(ACS_PRINT_INFO, L" SRAT not found, treating memory as uniform\n");
+    return;
+  }
+
+  Entry = (UINT8 *)Srat + sizeof (EFI_ACPI_6_5_SYSTEM_RESOURCE_AFFINITY_TABLE_HEADER);
+  End   = (UINT8 *)Srat + Srat->Length;
+
+  while (Entry + 2 <= End && Entry[1] != 0) {
+    switch (Entry[0]) {
+      case PAL_SRAT_TYPE_MEMORY:
+        MemEntry = (EFI_ACPI_6_5_MEMORY_AFFINITY_STRUCTURE *)Entry;
+        if (!(MemEntry->Flags & PAL_SRAT_ENABLED) || NumaTable->num_mem >= NUMA_MAX_MEM_RANGES)
+          break;
+        NumaTable->mem[NumaTable->num_mem].prox_domain = MemEntry->ProximityDomain;
+        NumaTable->mem[NumaTable->num_mem].flags  = MemEntry->Flags;
+        NumaTable->mem[NumaTable->num_mem].base   = LShiftU64 (MemEntry->AddressBaseHigh, 32) |
+                                                    MemEntry->AddressBaseLow;
+        NumaTable->mem[NumaTable->num_mem].length = LShiftU64 (MemEntry->LengthHigh, 32) |
+                                                    MemEntry->LengthLow;
+        pal_numa_note_domain(NumaTable, MemEntry->ProximityDomain);
+        NumaTable->num_mem++;
+        break;
+
+      case PAL_SRAT_TYPE_RINTC:
+        HartEntry = (PAL_SRAT_RINTC_AFFINITY *)Entry;
+        if (!(HartEntry->Flags & PAL_SRAT_ENABLED) || NumaTable->num_hart >= NUMA_MAX_HARTS)
+          break;
+        NumaTable->hart[NumaTable->num_hart].prox_domain        = HartEntry->ProximityDomain;
+        NumaTable->hart[NumaTable->num_hart].acpi_processor_uid = HartEntry->AcpiProcessorUid;
+        pal_numa_note_domain(NumaTable, HartEntry->ProximityDomain);
+        NumaTable->num_hart++;
+        break;
+
+      case PAL_SRAT_TYPE_GENERIC_INITIATOR:
+        GiEntry = (PAL_SRAT_GI_AFFINITY *)Entry;
+        if (!(GiEntry->Flags & PAL_SRAT_ENABLED) ||
+            GiEntry->DeviceHandleType != PAL_SRAT_DEVICE_HANDLE_PCI ||
+            NumaTable->num_initiator >= NUMA_MAX_INITIATORS)
+          break;
+        /* SRAT packs bus[15:8], device[7:3], function[2:0] */
+        NumaTable->initiator[NumaTable->num_initiator].prox_domain = GiEntry->ProximityDomain;
+        NumaTable->initiator[NumaTable->num_initiator].bdf =
+          (GiEntry->PciSegment << 24) | ((GiEntry->PciBdf >> 8) << 16) |
+          (((GiEntry->PciBdf >> 3) & 0x1F) << 8) | (GiEntry->PciBdf & 0x7);
+        pal_numa_note_domain(NumaTable, GiEntry->ProximityDomain);
+        NumaTable->num_initiator++;
+        break;
+
+      default:
+        break;
+    }
+    Entry += Entry[1];
+  }
+
+  Slit = (EFI_ACPI_6_5_SYSTEM_LOCALITY_DISTANCE_INFORMATION_TABLE_HEADER *) pal_get_slit_ptr();
+  if (Slit == NULL)
+    return;
+
+  Localities = Slit->NumberOfSystemLocalities;
+  if (sizeof (*Slit) + Localities * Localities > Slit->Header.Length) {
+    bsa_print(ACS_PRINT_WARN, L" SLIT length does not cover %ld localities\n", Localities);
+    return;
+  }
+
+  Matrix = (UINT8 *)(Slit + 1);
+  for (Row = 0; Row < Localities && Row < NUMA_MAX_DOMAINS; Row++)
+    for (Col = 0; Col < Localities && Col < NUMA_MAX_DOMAINS; Col++)
+      NumaTable->distance[Row][Col] = Matrix[Row * Localities + Col];
+
+  if (Localities > NumaTable->num_domains)
+    NumaTable->num_domains = (UINT32)Localities;
+
+  bsa_print(ACS_PRINT_INFO, L" NUMA domains: %d\n", NumaTable->num_domains);
+}
@@ -23,6 +23,9 @@
 #include <Protocol/AcpiTable.h>
 #include "Include/IndustryStandard/Acpi61.h"
 
+#include <sbi/riscv_asm.h>
+#include <sbi/riscv_encoding.h>
+
 #include "include/pal_uefi.h"
 #include "../include/platform_override.h"
 
@@ -191,6 +194,19 @@ pal_timer_get_counter_frequency(VOID)
   return PLATFORM_OVERRIDE_TIMER_CNTFRQ;
 }
 
+/**
+  @brief  This API returns the current value of the hart local time counter
+
+  @param  None
+
+  @return Counter value in ticks of the timebase frequency
+**/
+UINT64
+pal_timer_get_counter(VOID)
+{
+  return csr_read(CSR_TIME);
+}
+
 /**
   @brief This API overrides the watch dog timer specified by WdTable
          Note: Only one watchdog information can be assigned as an override
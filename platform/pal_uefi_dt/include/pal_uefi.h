@@ -90,8 +90,23 @@ typedef struct {
 
 typedef struct {
   UINT32 num_of_hart;
+  UINT32 num_of_isa;        ///< Distinct ISA strings in isa_pool
+  UINT32 isa_pool_used;     ///< Bytes of isa_pool in use
 }HART_INFO_HDR;
 
+#define HART_MAX_ISA_STRINGS   16
+#define HART_ISA_POOL_SIZE     4096
+#define HART_ISA_NONE          0xFFFFFFFF
+#define HART_ID_INVALID        0xFFFFFFFFFFFFFFFFULL
+
+/**
+  @brief  ISA string shared by all HARTs that reference the same RHCT ISA node
+**/
+typedef struct {
+  UINT32 rhct_offset;      ///< Offset of the ISA string node in the RHCT
+  UINT32 pool_offset;      ///< Offset of the null-terminated string in isa_pool
+}HART_ISA_ENTRY;
+
 /**
   @brief  structure instance for HART entry
 **/
@@ -102,15 +117,20 @@ typedef struct {
   uint32_t   ext_intc_id;     ///< The unique ID of the external interrupts connected to this hart.
   uint64_t   imsic_base;      ///< Physical base address of the Incoming MSI Controller (IMSIC) MMIO region of this hart.
   uint32_t   imsic_size;      ///< Size in bytes of the IMSIC MMIO region of this hart.
-  char8_t    isa_string[512]; ///< Null-terminated ASCII Instruction Set Architecture (ISA) string for this hart.
+  uint32_t   cbom_block_size; ///< Zicbom cache block size in bytes from the RHCT CMO node, 0 if absent.
+  UINT32   isa_index;       ///< Index into isa[] of the HART_INFO_TABLE, HART_ISA_NONE if absent.
 }HART_INFO_ENTRY;
 
 typedef struct {
   HART_INFO_HDR    header;
+  HART_ISA_ENTRY   isa[HART_MAX_ISA_STRINGS];
+  char8_t          isa_pool[HART_ISA_POOL_SIZE];
   HART_INFO_ENTRY  hart_info[];
 }HART_INFO_TABLE;
 
 VOID     pal_hart_data_cache_ops_by_va(UINT64 addr, UINT32 type);
+VOID     pal_hart_data_cache_ops_by_range(UINT64 addr, UINT64 length, UINT32 type,
+                                          UINT32 block_size);
 
 #define CLEAN_AND_INVALIDATE  0x1
 #define CLEAN                 0x2
@@ -462,5 +482,44 @@ UINT64  pal_memory_get_unpopulated_addr(UINT64 *addr, UINT32 instance);
 
 VOID    pal_mem_free(VOID *buffer);
 UINT32  pal_hart_get_num();
+UINT64  pal_hart_get_boot_hart_id(VOID);
+
+/**  NUMA related Definitions **/
+#define NUMA_MAX_DOMAINS      16    /* SLIT distances kept for the first 16 domains */
+#define NUMA_MAX_MEM_RANGES   64
+#define NUMA_MAX_HARTS        1024
+#define NUMA_MAX_INITIATORS   32
+#define NUMA_NODE_ANY         0xFFFFFFFF
+#define NUMA_DISTANCE_LOCAL   10
+
+typedef struct {
+  UINT32    prox_domain;
+  UINT32    flags;                  ///< SRAT memory affinity flags
+  UINT64    base;
+  UINT64    length;
+}NUMA_MEM_ENTRY;
+
+typedef struct {
+  UINT32    prox_domain;
+  UINT32    acpi_processor_uid;     ///< From the SRAT RINTC affinity structure
+}NUMA_HART_ENTRY;
+
+typedef struct {
+  UINT32    prox_domain;
+  UINT32    bdf;                    ///< PCI generic initiator, PCIE_CREATE_BDF format
+}NUMA_INITIATOR_ENTRY;
+
+typedef struct {
+  UINT32                num_domains;  ///< 0 when the platform has no SRAT
+  UINT32                num_mem;
+  UINT32                num_hart;
+  UINT32                num_initiator;
+  UINT8                 distance[NUMA_MAX_DOMAINS][NUMA_MAX_DOMAINS]; ///< SLIT, 0 if absent
+  NUMA_MEM_ENTRY        mem[NUMA_MAX_MEM_RANGES];
+  NUMA_HART_ENTRY       hart[NUMA_MAX_HARTS];
+  NUMA_INITIATOR_ENTRY  initiator[NUMA_MAX_INITIATORS];
+}NUMA_INFO_TABLE;
+
+VOID pal_numa_create_info_table(NUMA_INFO_TABLE *numa_info_table);
 
 #endif
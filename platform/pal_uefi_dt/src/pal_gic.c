@@ -335,6 +335,21 @@ pal_gic_end_of_interrupt(UINT32 int_id)
   return 0;
 }
 
+/**
+  @brief  Claim the highest priority pending interrupt without going through
+          the interrupt protocol. Not supported on the devicetree target,
+          interrupts are only taken through the registered handlers.
+
+  @return 0, no interrupt claimed
+**/
+UINT32
+pal_gic_claim_interrupt (
+  VOID
+  )
+{
+  return 0;
+}
+
 /**
   @brief  Set Trigger type Edge/Level
 
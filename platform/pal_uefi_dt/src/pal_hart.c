@@ -23,6 +23,7 @@
 #include <Include/libfdt.h>
 #include <Protocol/AcpiTable.h>
 #include <Protocol/Cpu.h>
+#include <Protocol/RiscVBootProtocol.h>
 
 #include "include/pal_uefi.h"
 #include "include/pal_dt.h"
@@ -152,6 +153,38 @@ pal_hart_get_num()
   return (UINT32)g_num_hart;
 }
 
+/**
+  @brief  Return the Hart ID of the hart that loaded the application, as
+          reported by the RISC-V EFI boot protocol.
+
+  @param  None
+
+  @return Hart ID, or HART_ID_INVALID if the protocol is not installed
+**/
+UINT64
+pal_hart_get_boot_hart_id (
+  VOID
+  )
+{
+  EFI_STATUS               Status;
+  RISCV_EFI_BOOT_PROTOCOL  *BootProtocol;
+  UINTN                    BootHartId;
+
+  Status = gBS->LocateProtocol (&gRiscVEfiBootProtocolGuid, NULL, (VOID **)&BootProtocol);
+  if (EFI_ERROR (Status)) {
+    bsa_print(ACS_PRINT_WARN, L" RISC-V boot protocol not found\n");
+    return HART_ID_INVALID;
+  }
+
+  Status = BootProtocol->GetBootHartId (BootProtocol, &BootHartId);
+  if (EFI_ERROR (Status)) {
+    bsa_print(ACS_PRINT_WARN, L" GetBootHartId failed %r\n", Status);
+    return HART_ID_INVALID;
+  }
+
+  return (UINT64)BootHartId;
+}
+
 /**
   @brief   Returns the Max of each 8-bit Affinity fields in MPIDR.
   @param   None
@@ -229,6 +262,7 @@ pal_hart_create_info_table(HART_INFO_TABLE *PeTable)
   }
 
   PeTable->header.num_of_hart = 0;
+  PeTable->header.num_of_isa = 0;
 
   Entry = (EFI_ACPI_6_1_GIC_STRUCTURE *) (gMadtHdr + 1);
   Length = sizeof (EFI_ACPI_6_1_MULTIPLE_APIC_DESCRIPTION_TABLE_HEADER);
@@ -241,6 +275,7 @@ pal_hart_create_info_table(HART_INFO_TABLE *PeTable)
       Ptr->mpidr    = Entry->MPIDR;
       Ptr->hart_num   = PeTable->header.num_of_hart;
       Ptr->pmu_gsiv = Entry->PerformanceInterruptGsiv;
+      Ptr->isa_index = HART_ISA_NONE;
       bsa_print(ACS_PRINT_DEBUG, L"  MPIDR %x HART num %d\n", Ptr->mpidr, Ptr->hart_num);
       pal_hart_data_cache_ops_by_va((UINT64)Ptr, CLEAN_AND_INVALIDATE);
       Ptr++;
@@ -413,6 +448,37 @@ pal_hart_data_cache_ops_by_va(UINT64 addr, UINT32 type)
 
 }
 
+/* Line size stepped by when the caller does not know the cache block size */
+#define PAL_CACHE_LINE_SIZE_DEFAULT 64
+
+/**
+  @brief Perform cache maintenance operation on an address range
+
+  @param addr       - start address of the range
+  @param length     - length of the range in bytes
+  @param type       - type of cache ops
+  @param block_size - cache block size in bytes, 0 to step by the default line size
+
+  @return  None
+**/
+VOID
+pal_hart_data_cache_ops_by_range(UINT64 addr, UINT64 length, UINT32 type, UINT32 block_size)
+{
+  UINT64 aligned_addr, end_addr;
+
+  /* unknown block size, still cover every line of the range */
+  if (block_size == 0)
+      block_size = PAL_CACHE_LINE_SIZE_DEFAULT;
+
+  aligned_addr = addr & ~((UINT64)block_size - 1);
+  end_addr = addr + length;
+
+  while (aligned_addr < end_addr) {
+      pal_hart_data_cache_ops_by_va(aligned_addr, type);
+      aligned_addr += block_size;
+  }
+}
+
 /**
   @brief  This API fills in the HART_INFO_TABLE  with information about PMU
           in the system. This is achieved by parsing the DT.
@@ -553,8 +619,9 @@ pal_hart_create_info_table_dt(HART_INFO_TABLE *PeTable)
   int offset, parent_offset;
   CHAR8 * Pstatus;
 
-  /* initialise number of PEs to zero */
+  /* initialise number of PEs and ISA strings to zero */
   PeTable->header.num_of_hart = 0;
+  PeTable->header.num_of_isa = 0;
 
   dt_ptr = pal_get_dt_ptr();
   if (dt_ptr == 0) {
@@ -625,6 +692,7 @@ pal_hart_create_info_table_dt(HART_INFO_TABLE *PeTable)
       }
 
       Ptr->hart_num   = PeTable->header.num_of_hart;
+      Ptr->isa_index  = HART_ISA_NONE;
       pal_hart_data_cache_ops_by_va((UINT64)Ptr, CLEAN_AND_INVALIDATE);
       PeTable->header.num_of_hart++;
 
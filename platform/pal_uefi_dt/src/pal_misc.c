@@ -308,6 +308,22 @@ pal_mem_set (
   SetMem(Buf, Size, Value);
 }
 
+/**
+  @brief  Allow the memory primitives to use vector instructions. The UEFI
+          BaseMemoryLib routines are used as is, so this is a no-op.
+
+  @param  Enable  1 if every hart implements the vector extension
+
+  @return None
+**/
+VOID
+pal_mem_enable_vector (
+  UINT32 Enable
+  )
+{
+  (VOID)Enable;
+}
+
 /**
   @brief  Allocate memory which is to be used to share data across PEs
 
@@ -660,6 +676,48 @@ pal_mem_free_aligned (VOID *Buffer)
     }
 }
 
+/**
+  @brief Allocates the requested number of pages inside a physical address range.
+         Candidate bases are tried on 2MiB boundaries so that large buffers are
+         not split across superpage mappings.
+
+  @param Base      Start of the physical range
+  @param Size      Size of the physical range in bytes
+  @param NumPages  Number of memory pages needed
+
+  @return Address of the allocated space, NULL if no candidate was free
+**/
+VOID *
+pal_mem_alloc_pages_in_range (
+  UINT64 Base,
+  UINT64 Size,
+  UINT32 NumPages
+  )
+{
+  EFI_STATUS           Status;
+  EFI_PHYSICAL_ADDRESS PageBase;
+  UINT64               Length;
+  UINT64               End;
+  UINT32               Tries;
+
+  Length   = (UINT64)NumPages * EFI_PAGE_SIZE;
+  End      = Base + Size;
+  PageBase = (Base + SIZE_2MB - 1) & ~((UINT64)SIZE_2MB - 1);
+
+  for (Tries = 0; Tries < 64 && (PageBase + Length) <= End; Tries++) {
+    Status = gBS->AllocatePages (AllocateAddress,
+                                 EfiBootServicesData,
+                                 NumPages,
+                                 &PageBase);
+    if (!EFI_ERROR(Status))
+      return (VOID*)(UINTN)PageBase;
+
+    PageBase += SIZE_2MB;
+  }
+
+  return NULL;
+}
+
 /**
   @brief Free number of pages in the memory as requested.
 
@@ -676,3 +734,20 @@ pal_mem_free_pages(
 {
   gBS->FreePages((EFI_PHYSICAL_ADDRESS)(UINTN)PageBase, NumPages);
 }
+
+/**
+  @brief  Proximity domains are not parsed from the devicetree, all memory
+          is treated as uniform.
+
+  @param  NumaTable  Address where the NUMA information needs to be filled.
+
+  @return None
+**/
+VOID
+pal_numa_create_info_table(NUMA_INFO_TABLE *NumaTable)
+{
+  if (NumaTable == NULL)
+    return;
+
+  pal_mem_set(NumaTable, sizeof(NUMA_INFO_TABLE), 0);
+}
@@ -174,6 +174,22 @@ pal_timer_get_counter_frequency(VOID)
   return PLATFORM_OVERRIDE_TIMER_CNTFRQ;
 }
 
+/**
+  @brief  This API returns the current value of the hart local time counter
+
+  @param  None
+
+  @return Counter value in ticks of the timebase frequency
+**/
+UINT64
+pal_timer_get_counter(VOID)
+{
+  UINT64 Count;
+
+  __asm__ volatile ("rdtime %0" : "=r" (Count));
+  return Count;
+}
+
 /**
   @brief This API overrides the watch dog timer specified by WdTable
          Note: Only one watchdog information can be assigned as an override
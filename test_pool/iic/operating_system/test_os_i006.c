@@ -0,0 +1,188 @@
+/** @file
+ * Copyright (c) 2016-2018, 2021, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#include "val/include/bsa_acs_val.h"
+#include "val/include/val_interface.h"
+
+#include "val/include/bsa_acs_gic.h"
+#include "val/include/bsa_acs_iic.h"
+#include "val/include/bsa_acs_hart.h"
+
+#define TEST_NUM   (ACS_GIC_TEST_NUM_BASE + 6)
+#define TEST_RULE  "MF_IIC_030_010"
+#define TEST_DESC  "Full identity range EIE/EIP sweep                    "
+
+#define EIX_PATTERN  0xA5C3F00F5A3C0FF0ULL
+
+static IMSIC_FILE_STATE saved;
+static IMSIC_FILE_STATE restored;
+
+/**
+ * @brief Word pattern that differs between words, so two eip/eie selectors
+          aliasing the same register are caught.
+ */
+static
+uint64_t
+eix_pattern(uint32_t word)
+{
+  uint32_t rot = (word * 7) & 63;
+
+  return (rot == 0) ? EIX_PATTERN : (EIX_PATTERN << rot) | (EIX_PATTERN >> (64 - rot));
+}
+
+/**
+ * @brief Check every implemented identity bit of one of the eie or eip arrays
+          a whole word at a time:
+          1. All ones reads back as all implemented bits.
+          2. A different pattern in every word reads back unchanged once all
+             words are written.
+          3. All zeros reads back as zero.
+          4. Words beyond the implemented identities read as zero.
+ * @return 0 on success, otherwise the failing checkpoint
+ */
+static
+uint32_t
+eix_sweep(bool pend, uint32_t num_words)
+{
+  uint32_t w;
+  uint64_t mask, val;
+
+  for (w = 0; w < num_words; w++) {
+    mask = (w == 0) ? ~BIT(0) : ~0ULL;
+    val_iic_imsic_eix_word_write(w, pend, ~0ULL);
+    val = val_iic_imsic_eix_word_read(w, pend);
+    if (val != mask) {
+      val_print(ACS_PRINT_ERR, "\n       Set all failed at irq %d", w * 64 + __builtin_ctzll(val ^ mask));
+      return 1;
+    }
+  }
+
+  for (w = 0; w < num_words; w++)
+    val_iic_imsic_eix_word_write(w, pend, eix_pattern(w));
+
+  for (w = 0; w < num_words; w++) {
+    mask = (w == 0) ? ~BIT(0) : ~0ULL;
+    val = val_iic_imsic_eix_word_read(w, pend);
+    if (val != (eix_pattern(w) & mask)) {
+      val_print(ACS_PRINT_ERR, "\n       Pattern mismatch at irq %d",
+                w * 64 + __builtin_ctzll(val ^ (eix_pattern(w) & mask)));
+      return 2;
+    }
+  }
+
+  for (w = 0; w < num_words; w++) {
+    val_iic_imsic_eix_word_write(w, pend, 0);
+    val = val_iic_imsic_eix_word_read(w, pend);
+    if (val != 0) {
+      val_print(ACS_PRINT_ERR, "\n       Clear all failed at irq %d", w * 64 + __builtin_ctzll(val));
+      return 3;
+    }
+  }
+
+  for (w = num_words; w < IMSIC_MAX_EIX_WORDS; w++) {
+    val_iic_imsic_eix_word_write(w, pend, ~0ULL);
+    val = val_iic_imsic_eix_word_read(w, pend);
+    if (val != 0) {
+      val_print(ACS_PRINT_ERR, "\n       Unimplemented irq %d is writable", w * 64 + __builtin_ctzll(val));
+      return 4;
+    }
+  }
+
+  return 0;
+}
+
+/**
+ * @brief 1. Snapshot the S-level interrupt file and hold off delivery.
+          2. Sweep every implemented identity in the eie array, then in the
+          eip array, with whole word accesses.
+          3. Restore the snapshot and check eie, eithreshold and eidelivery
+          read back as saved. eip is not compared since a device may pend an
+          identity meanwhile.
+ */
+static
+void
+payload()
+{
+  uint32_t index = val_hart_get_index_mpid(val_hart_get_mpid());
+  uint32_t num_words = val_iic_imsic_eix_num_words();
+  uint32_t status, w;
+
+  val_print(ACS_PRINT_INFO, "\n       EIE/EIP words to check: %d", num_words);
+
+  val_iic_imsic_file_save(&saved);
+  val_iic_imsic_eidelivery_update(0);
+  for (w = 0; w < num_words; w++) {
+    val_iic_imsic_eix_word_write(w, false, 0);
+    val_iic_imsic_eix_word_write(w, true, 0);
+  }
+
+  status = eix_sweep(false, num_words);
+  if (status) {
+    val_print(ACS_PRINT_ERR, "\n       EIEk sweep failed", 0);
+    val_iic_imsic_file_restore(&saved);
+    val_set_status(index, RESULT_FAIL(TEST_NUM, status));
+    return;
+  }
+
+  status = eix_sweep(true, num_words);
+  if (status) {
+    val_print(ACS_PRINT_ERR, "\n       EIPk sweep failed", 0);
+    val_iic_imsic_file_restore(&saved);
+    val_set_status(index, RESULT_FAIL(TEST_NUM, 4 + status));
+    return;
+  }
+
+  val_iic_imsic_file_restore(&saved);
+  val_iic_imsic_file_save(&restored);
+
+  if (restored.eidelivery != saved.eidelivery || restored.eithreshold != saved.eithreshold) {
+    val_print(ACS_PRINT_ERR, "\n       EIDELIVERY/EITHRESHOLD not restored", 0);
+    val_set_status(index, RESULT_FAIL(TEST_NUM, 9));
+    return;
+  }
+
+  for (w = 0; w < num_words; w++) {
+    if (restored.eie[w] != saved.eie[w]) {
+      val_print(ACS_PRINT_ERR, "\n       EIEk word %d not restored", w);
+      val_set_status(index, RESULT_FAIL(TEST_NUM, 10));
+      return;
+    }
+  }
+
+  val_set_status(index, RESULT_PASS(TEST_NUM, 1));
+}
+
+uint32_t
+os_i006_entry(uint32_t num_hart)
+{
+
+  uint32_t status = ACS_STATUS_FAIL;
+
+  num_hart = 1;  //This IIC test is run on single processor
+
+  status = val_initialize_test(TEST_NUM, TEST_DESC, num_hart);
+
+  if (status != ACS_STATUS_SKIP)
+      val_run_test_payload(TEST_NUM, num_hart, payload, 0);
+
+  /* get the result from all HART and check for failure */
+  status = val_check_for_error(TEST_NUM, num_hart, TEST_RULE);
+
+  val_report_status(0, BSA_ACS_END(TEST_NUM), NULL);
+
+  return status;
+}
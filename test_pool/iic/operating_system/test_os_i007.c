@@ -0,0 +1,124 @@
+/** @file
+ * Copyright (c) 2016-2018, 2021, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#include "val/include/bsa_acs_val.h"
+#include "val/include/val_interface.h"
+
+#include "val/include/bsa_acs_gic.h"
+#include "val/include/bsa_acs_iic.h"
+#include "val/include/bsa_acs_hart.h"
+#include "val/include/bsa_acs_memory.h"
+#include "val/include/bsa_acs_iic_perf.h"
+
+#define TEST_NUM   (ACS_GIC_TEST_NUM_BASE + 7)
+#define TEST_RULE  "ME_IIC_PERF_010_010"
+#define TEST_DESC  "Measure MSI to handler latency per hart              "
+
+static IIC_PERF_MSI_RESULT_t *g_result;
+
+static
+void
+msi_payload(void)
+{
+  uint32_t index = val_hart_get_index_mpid(val_hart_get_mpid());
+
+  if (val_iic_perf_msi_latency(&g_result[index]))
+      val_set_status(index, RESULT_SKIP(TEST_NUM, 1));
+  else
+      val_set_status(index, RESULT_PASS(TEST_NUM, 1));
+}
+
+/**
+ * @brief On every hart in turn:
+ * 1. Enable a few S-level identities in the hart's own interrupt file.
+ * 2. Write each identity to the seteipnum_le register of the file, reading
+ *    the time counter just before the write and on entry to the external
+ *    interrupt handler, which claims the identity through stopei.
+ * 3. Report min/median/p99/max per identity and a log2 histogram per
+ *    hart, in IICPERF lines, after the time counter resolution. An MSI
+ *    that is not taken, or is claimed under another identity, fails the
+ *    test.
+ */
+static
+void
+payload()
+{
+  uint32_t index = val_hart_get_index_mpid(val_hart_get_mpid());
+  uint32_t num_hart = val_hart_get_num();
+  uint32_t i, status, tested = 0, failed = 0;
+
+  if (!val_hart_all_have_ext(EXT_SSAIA)) {
+      val_print(ACS_PRINT_DEBUG, "\n       Ssaia not implemented by every hart", 0);
+      val_set_status(index, RESULT_SKIP(TEST_NUM, 1));
+      return;
+  }
+
+  g_result = val_memory_calloc(num_hart, sizeof(IIC_PERF_MSI_RESULT_t));
+  if (g_result == NULL || val_iic_perf_init()) {
+      val_print(ACS_PRINT_ERR, "\n       Benchmark setup failed", 0);
+      if (g_result != NULL)
+          val_memory_free(g_result);
+      val_set_status(index, RESULT_FAIL(TEST_NUM, 1));
+      return;
+  }
+
+  for (i = 0; i < num_hart; i++) {
+      status = val_hart_run_payload(TEST_NUM, i, msi_payload, IIC_PERF_HART_TIMEOUT_S);
+      if (status == ACS_STATUS_SKIP)
+          continue;
+      if (status) {
+          failed++;
+          continue;
+      }
+
+      tested++;
+      val_iic_perf_report_msi(i, &g_result[i]);
+      if (g_result[i].lost || g_result[i].misclaimed)
+          failed++;
+  }
+
+  val_iic_perf_free();
+  val_memory_free(g_result);
+
+  if (failed)
+      val_set_status(index, RESULT_FAIL(TEST_NUM, 2));
+  else if (tested == 0)
+      val_set_status(index, RESULT_SKIP(TEST_NUM, 2));
+  else
+      val_set_status(index, RESULT_PASS(TEST_NUM, 1));
+}
+
+uint32_t
+os_i007_entry(uint32_t num_hart)
+{
+
+  uint32_t status = ACS_STATUS_FAIL;
+
+  num_hart = 1;  //The primary hart drives the other harts one at a time
+
+  status = val_initialize_test(TEST_NUM, TEST_DESC, num_hart);
+
+  if (status != ACS_STATUS_SKIP)
+      val_run_test_payload(TEST_NUM, num_hart, payload, 0);
+
+  /* get the result from all HART and check for failure */
+  status = val_check_for_error(TEST_NUM, num_hart, TEST_RULE);
+
+  val_report_status(0, BSA_ACS_END(TEST_NUM), NULL);
+
+  return status;
+}
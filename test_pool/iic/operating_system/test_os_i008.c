@@ -0,0 +1,102 @@
+/** @file
+ * Copyright (c) 2016-2018, 2021, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#include "val/include/bsa_acs_val.h"
+#include "val/include/val_interface.h"
+
+#include "val/include/bsa_acs_gic.h"
+#include "val/include/bsa_acs_iic.h"
+#include "val/include/bsa_acs_hart.h"
+#include "val/include/bsa_acs_memory.h"
+#include "val/include/bsa_acs_iic_perf.h"
+
+#define TEST_NUM   (ACS_GIC_TEST_NUM_BASE + 8)
+#define TEST_RULE  "ME_IIC_PERF_010_020"
+#define TEST_DESC  "Measure cross hart IPI latency matrix                "
+
+/**
+ * @brief For every receiving hart:
+ * 1. Park the receiver with its interrupt file armed for a ping identity.
+ *    Its handler answers each ping with a pong MSI to the sender.
+ * 2. On every other hart in turn, send pings to the receiver's seteipnum_le
+ *    page and time each round trip up to entry of the pong handler.
+ * 3. Report the median round trip of every hart pair as one IICPERF,IPIROW
+ *    line per sender. Unanswered pings fail the test.
+ * The test is skipped when a hart cannot be started, which is the case on
+ * every RISC-V system until val_execute_on_pe goes through SBI HSM.
+ */
+static
+void
+payload()
+{
+  uint32_t index = val_hart_get_index_mpid(val_hart_get_mpid());
+  IIC_PERF_IPI_RESULT_t result;
+  uint32_t status;
+
+  if (val_hart_get_num() < 2) {
+      val_print(ACS_PRINT_DEBUG, "\n       Skipping as num of HART is 1    ", 0);
+      val_set_status(index, RESULT_SKIP(TEST_NUM, 1));
+      return;
+  }
+
+  if (!val_hart_all_have_ext(EXT_SSAIA)) {
+      val_print(ACS_PRINT_DEBUG, "\n       Ssaia not implemented by every hart", 0);
+      val_set_status(index, RESULT_SKIP(TEST_NUM, 2));
+      return;
+  }
+
+  if (val_iic_perf_init()) {
+      val_print(ACS_PRINT_ERR, "\n       Benchmark setup failed", 0);
+      val_set_status(index, RESULT_FAIL(TEST_NUM, 1));
+      return;
+  }
+
+  status = val_iic_perf_ipi_matrix(TEST_NUM, &result);
+  if (result.pair != NULL) {
+      val_iic_perf_report_ipi(&result);
+      val_memory_free(result.pair);
+  }
+  val_iic_perf_free();
+
+  if (status == ACS_STATUS_SKIP)
+      val_set_status(index, RESULT_SKIP(TEST_NUM, 3));
+  else if (status != ACS_STATUS_PASS || result.lost)
+      val_set_status(index, RESULT_FAIL(TEST_NUM, 2));
+  else
+      val_set_status(index, RESULT_PASS(TEST_NUM, 1));
+}
+
+uint32_t
+os_i008_entry(uint32_t num_hart)
+{
+
+  uint32_t status = ACS_STATUS_FAIL;
+
+  num_hart = 1;  //The primary hart drives the other harts
+
+  status = val_initialize_test(TEST_NUM, TEST_DESC, num_hart);
+
+  if (status != ACS_STATUS_SKIP)
+      val_run_test_payload(TEST_NUM, num_hart, payload, 0);
+
+  /* get the result from all HART and check for failure */
+  status = val_check_for_error(TEST_NUM, num_hart, TEST_RULE);
+
+  val_report_status(0, BSA_ACS_END(TEST_NUM), NULL);
+
+  return status;
+}
@@ -0,0 +1,105 @@
+/** @file
+ * Copyright (c) 2016-2018, 2021, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#include "val/include/bsa_acs_val.h"
+#include "val/include/val_interface.h"
+
+#include "val/include/bsa_acs_gic.h"
+#include "val/include/bsa_acs_iic.h"
+#include "val/include/bsa_acs_hart.h"
+#include "val/include/bsa_acs_memory.h"
+#include "val/include/bsa_acs_iic_perf.h"
+
+#define TEST_NUM   (ACS_GIC_TEST_NUM_BASE + 9)
+#define TEST_RULE  "ME_IIC_PERF_010_030"
+#define TEST_DESC  "Measure APLIC wired interrupt to handler latency     "
+
+/**
+ * @brief For every APLIC domain in the MADT, on the primary hart:
+ * 1. Pick a free source and make it pending through setipnum, as an edge on
+ *    its wire would, with the domain in direct mode and then in MSI mode.
+ * 2. Time each delivery from the setipnum write to entry of the external
+ *    interrupt handler, which claims through the IDC or through stopei.
+ * 3. Time the same identity written straight to the interrupt file, so the
+ *    cost of the MSI forwarding hop can be read off the IICPERF lines.
+ * A domain mode that is not implemented is reported as unsupported. An
+ * interrupt that is not taken, or claimed under another ID, fails the test.
+ */
+static
+void
+payload()
+{
+  uint32_t index = val_hart_get_index_mpid(val_hart_get_mpid());
+  uint32_t num_aplic = val_iic_aplic_get_num();
+  IIC_PERF_WIRED_RESULT_t result;
+  uint32_t i, path, tested = 0, failed = 0;
+
+  if (num_aplic == 0) {
+      val_print(ACS_PRINT_DEBUG, "\n       No APLIC in the MADT", 0);
+      val_set_status(index, RESULT_SKIP(TEST_NUM, 1));
+      return;
+  }
+
+  if (val_iic_perf_init()) {
+      val_print(ACS_PRINT_ERR, "\n       Benchmark setup failed", 0);
+      val_set_status(index, RESULT_FAIL(TEST_NUM, 1));
+      return;
+  }
+
+  for (i = 0; i < num_aplic; i++) {
+      if (val_iic_perf_wired_latency(i, &result))
+          continue;
+
+      val_iic_perf_report_wired(&result);
+      for (path = 0; path < IIC_PERF_WIRED_PATHS; path++) {
+          if (result.supported[path] && path != IIC_PERF_WIRED_IMSIC)
+              tested++;
+          if (result.lost[path] || result.misclaimed[path])
+              failed++;
+      }
+  }
+
+  val_iic_perf_free();
+
+  if (failed)
+      val_set_status(index, RESULT_FAIL(TEST_NUM, 2));
+  else if (tested == 0)
+      val_set_status(index, RESULT_SKIP(TEST_NUM, 2));
+  else
+      val_set_status(index, RESULT_PASS(TEST_NUM, 1));
+}
+
+uint32_t
+os_i009_entry(uint32_t num_hart)
+{
+
+  uint32_t status = ACS_STATUS_FAIL;
+
+  num_hart = 1;  //This IIC test is run on single processor
+
+  status = val_initialize_test(TEST_NUM, TEST_DESC, num_hart);
+
+  if (status != ACS_STATUS_SKIP)
+      val_run_test_payload(TEST_NUM, num_hart, payload, 0);
+
+  /* get the result from all HART and check for failure */
+  status = val_check_for_error(TEST_NUM, num_hart, TEST_RULE);
+
+  val_report_status(0, BSA_ACS_END(TEST_NUM), NULL);
+
+  return status;
+}
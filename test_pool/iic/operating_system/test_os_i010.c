@@ -0,0 +1,103 @@
+/** @file
+ * Copyright (c) 2016-2018, 2021, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#include "val/include/bsa_acs_val.h"
+#include "val/include/val_interface.h"
+
+#include "val/include/bsa_acs_gic.h"
+#include "val/include/bsa_acs_iic.h"
+#include "val/include/bsa_acs_hart.h"
+#include "val/include/bsa_acs_memory.h"
+#include "val/include/bsa_acs_iic_perf.h"
+
+#define TEST_NUM   (ACS_GIC_TEST_NUM_BASE + 10)
+#define TEST_RULE  "ME_IIC_PERF_010_040"
+#define TEST_DESC  "Measure interrupt storm absorption rate              "
+
+static IIC_PERF_STORM_RESULT_t storm;
+static IIC_PERF_OVERHEAD_RESULT_t overhead;
+
+/**
+ * @brief On the primary hart:
+ * 1. Time the IMSIC claim through stopei and the end of interrupt path with
+ *    delivery masked, per operation.
+ * 2. Storm the hart with MSIs it writes to its own interrupt file, at rates
+ *    from 1k to 1M per second and back to back.
+ * 3. Report generated against delivered interrupts, the lost rate and the
+ *    first saturated rate in IICPERF lines.
+ * Losses at high rates are expected and only reported. A storm in which
+ * not a single interrupt is delivered fails the test.
+ */
+static
+void
+payload()
+{
+  uint32_t index = val_hart_get_index_mpid(val_hart_get_mpid());
+  uint32_t tested = 0, failed = 0;
+
+  if (val_hart_get_imsic_base(index) == 0) {
+      val_print(ACS_PRINT_DEBUG, "\n       No IMSIC for this hart", 0);
+      val_set_status(index, RESULT_SKIP(TEST_NUM, 1));
+      return;
+  }
+
+  if (val_iic_perf_init()) {
+      val_print(ACS_PRINT_ERR, "\n       Benchmark setup failed", 0);
+      val_set_status(index, RESULT_FAIL(TEST_NUM, 1));
+      return;
+  }
+
+  if (val_iic_perf_overhead(&overhead) == ACS_STATUS_PASS)
+      val_iic_perf_report_overhead(&overhead);
+
+  if (val_iic_perf_storm(IIC_PERF_STORM_SELF, &storm) == ACS_STATUS_PASS) {
+      tested++;
+      val_iic_perf_report_storm(&storm);
+      if (storm.step[0].delivered == 0)
+          failed++;
+  }
+
+  val_iic_perf_free();
+
+  if (failed)
+      val_set_status(index, RESULT_FAIL(TEST_NUM, 2));
+  else if (tested == 0)
+      val_set_status(index, RESULT_SKIP(TEST_NUM, 2));
+  else
+      val_set_status(index, RESULT_PASS(TEST_NUM, 1));
+}
+
+uint32_t
+os_i010_entry(uint32_t num_hart)
+{
+
+  uint32_t status = ACS_STATUS_FAIL;
+
+  num_hart = 1;  //This IIC test is run on single processor
+
+  status = val_initialize_test(TEST_NUM, TEST_DESC, num_hart);
+
+  if (status != ACS_STATUS_SKIP)
+      val_run_test_payload(TEST_NUM, num_hart, payload, 0);
+
+  /* get the result from all HART and check for failure */
+  status = val_check_for_error(TEST_NUM, num_hart, TEST_RULE);
+
+  val_report_status(0, BSA_ACS_END(TEST_NUM), NULL);
+
+  return status;
+}
@@ -0,0 +1,100 @@
+/** @file
+ * Copyright (c) 2016-2018, 2021, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#include "val/include/bsa_acs_val.h"
+#include "val/include/val_interface.h"
+
+#include "val/include/bsa_acs_gic.h"
+#include "val/include/bsa_acs_iic.h"
+#include "val/include/bsa_acs_hart.h"
+#include "val/include/bsa_acs_memory.h"
+#include "val/include/bsa_acs_iic_perf.h"
+
+#define TEST_NUM   (ACS_GIC_TEST_NUM_BASE + 12)
+#define TEST_RULE  "ME_IIC_PERF_010_060"
+#define TEST_DESC  "Check IMSIC priority and threshold arbitration       "
+
+static IIC_PERF_ARB_RESULT_t arb;
+
+/**
+ * @brief On the primary hart, with delivery masked in sie:
+ * 1. Pend random sets of 1 to 2047 identities in bulk and claim them through
+ *    stopei under a random eithreshold, then with no threshold.
+ * 2. Compare every claim against a reference model: the lowest pending
+ *    identity below the threshold, and 0 once none is left below it.
+ * 3. Time claiming and completing each whole set, and report the drain
+ *    time and claim rate per pending population in IICPERF lines.
+ * A claim out of priority order, at or above the threshold, or missing
+ * fails the test.
+ */
+static
+void
+payload()
+{
+  uint32_t index = val_hart_get_index_mpid(val_hart_get_mpid());
+  uint32_t status;
+
+  if (val_hart_get_imsic_base(index) == 0) {
+      val_print(ACS_PRINT_DEBUG, "\n       No IMSIC for this hart", 0);
+      val_set_status(index, RESULT_SKIP(TEST_NUM, 1));
+      return;
+  }
+
+  if (val_iic_perf_init()) {
+      val_print(ACS_PRINT_ERR, "\n       Benchmark setup failed", 0);
+      val_set_status(index, RESULT_FAIL(TEST_NUM, 1));
+      return;
+  }
+
+  status = val_iic_perf_arbitration(&arb);
+  val_iic_perf_free();
+
+  if (status) {
+      val_set_status(index, RESULT_SKIP(TEST_NUM, 2));
+      return;
+  }
+
+  val_iic_perf_report_arbitration(&arb);
+
+  if (arb.misordered || arb.unmasked)
+      val_set_status(index, RESULT_FAIL(TEST_NUM, 2));
+  else if (arb.lost)
+      val_set_status(index, RESULT_FAIL(TEST_NUM, 3));
+  else
+      val_set_status(index, RESULT_PASS(TEST_NUM, 1));
+}
+
+uint32_t
+os_i012_entry(uint32_t num_hart)
+{
+
+  uint32_t status = ACS_STATUS_FAIL;
+
+  num_hart = 1;  //This IIC test is run on single processor
+
+  status = val_initialize_test(TEST_NUM, TEST_DESC, num_hart);
+
+  if (status != ACS_STATUS_SKIP)
+      val_run_test_payload(TEST_NUM, num_hart, payload, 0);
+
+  /* get the result from all HART and check for failure */
+  status = val_check_for_error(TEST_NUM, num_hart, TEST_RULE);
+
+  val_report_status(0, BSA_ACS_END(TEST_NUM), NULL);
+
+  return status;
+}
@@ -0,0 +1,111 @@
+/** @file
+ * Copyright (c) 2016-2018, 2021, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#include "val/include/bsa_acs_val.h"
+#include "val/include/val_interface.h"
+#include "val/include/bsa_acs_memory.h"
+
+#include "val/include/bsa_acs_mem_perf.h"
+
+#define TEST_NUM   (ACS_MEM_PERF_TEST_NUM_BASE + 2)
+#define TEST_RULE  "ME_MP_010_020"
+#define TEST_DESC  "Measure load latency per hart and region         "
+
+static MEM_PERF_REGION_t g_region;
+static MEM_PERF_RESULT_t *g_result;
+
+static
+void
+latency_payload(void)
+{
+  uint32_t index = val_hart_get_index_mpid(val_hart_get_mpid());
+
+  val_mem_perf_latency(&g_region, &g_result[index]);
+  val_set_status(index, RESULT_PASS(TEST_NUM, 1));
+}
+
+/**
+ * @brief For each normal memory region in the memory info table:
+ * 1. Place a buffer of up to 4x the LLC inside the region.
+ * 2. On every hart in turn, link working sets doubling from 4KiB to the
+ *    buffer size into a random cache line cycle and time a pointer chase.
+ * 3. Report the average load to use latency per hart, region and working
+ *    set in MEMPERF,LAT lines.
+ */
+static
+void
+payload()
+{
+  uint32_t index = val_hart_get_index_mpid(val_hart_get_mpid());
+  uint32_t num_hart = val_hart_get_num();
+  uint32_t instance, i, status, tested = 0, failed = 0;
+
+  g_result = val_memory_calloc(num_hart, sizeof(MEM_PERF_RESULT_t));
+  if (g_result == NULL) {
+      val_print(ACS_PRINT_ERR, "\n       Result buffer allocation failed", 0);
+      val_set_status(index, RESULT_FAIL(TEST_NUM, 1));
+      return;
+  }
+
+  for (instance = 0; instance < MEM_PERF_MAX_REGIONS; instance++) {
+      if (val_mem_perf_region_get(instance, &g_region))
+          break;
+
+      tested++;
+      for (i = 0; i < num_hart; i++) {
+          status = val_hart_run_payload(TEST_NUM, i, latency_payload, MEM_PERF_HART_TIMEOUT_S);
+          if (status == ACS_STATUS_SKIP)
+              continue;
+          if (status)
+              failed++;
+          else
+              val_mem_perf_report_latency(i, &g_region, &g_result[i]);
+      }
+      val_mem_perf_region_put(&g_region);
+  }
+
+  val_memory_free(g_result);
+
+  if (tested == 0) {
+      val_print(ACS_PRINT_DEBUG, "\n       No memory region for the test buffer", 0);
+      val_set_status(index, RESULT_SKIP(TEST_NUM, 1));
+  } else if (failed)
+      val_set_status(index, RESULT_FAIL(TEST_NUM, 2));
+  else
+      val_set_status(index, RESULT_PASS(TEST_NUM, 1));
+}
+
+uint32_t
+os_mp002_entry(uint32_t num_hart)
+{
+
+  uint32_t status = ACS_STATUS_FAIL;
+
+  num_hart = 1;  //The primary hart drives the other harts one at a time
+
+  status = val_initialize_test(TEST_NUM, TEST_DESC, num_hart);
+
+  if (status != ACS_STATUS_SKIP)
+      val_run_test_payload(TEST_NUM, num_hart, payload, 0);
+
+  /* get the result from all HART and check for failure */
+  status = val_check_for_error(TEST_NUM, num_hart, TEST_RULE);
+
+  val_report_status(0, BSA_ACS_END(TEST_NUM), NULL);
+
+  return status;
+}
@@ -72,7 +72,7 @@ payload(void)
   uint32_t timeout;
   uint32_t status;
   addr_t config_space_addr;
-  void *func_config_space;
+  void *func_config_space = NULL;
   pcie_device_bdf_table *bdf_tbl_ptr;
 
   hart_index = val_hart_get_index_mpid(val_hart_get_mpid());
@@ -112,9 +112,10 @@ payload(void)
           if (!flr_cap)
               continue;
 
-          /* Allocate 4KB of space for saving function configuration space */
-          func_config_space = NULL;
-          func_config_space = val_aligned_alloc(MEM_ALIGN_4K, PCIE_CFG_SIZE);
+          /* Allocate 4KB of scratch space for saving function configuration space,
+           * reused for every function and released when the test completes */
+          if (func_config_space == NULL)
+              func_config_space = val_scratch_alloc(PCIE_CFG_SIZE);
 
           /* If memory allocation fail, fail the test */
           if (func_config_space == NULL)
@@ -143,7 +144,6 @@ payload(void)
           if (status)
           {
               val_print(ACS_PRINT_ERR, "\n       Failed to time delay for BDF 0x%x ", bdf);
-              val_memory_free_aligned(func_config_space);
               val_set_status(hart_index, RESULT_FAIL(TEST_NUM, 01));
               return;
           }
@@ -172,7 +172,6 @@ payload(void)
           {
               val_print(ACS_PRINT_ERR, "\n       BDF 0x%x not present", bdf);
               test_fails++;
-              val_memory_free_aligned(func_config_space);
               continue;
           }
 
@@ -183,8 +182,6 @@ payload(void)
           for (idx = 0; idx < PCIE_CFG_SIZE / 4; idx++) {
               *((uint32_t *)config_space_addr + idx) = *((uint32_t *)func_config_space + idx);
           }
-
-          val_memory_free_aligned(func_config_space);
       }
   }
 
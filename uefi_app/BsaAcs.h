@@ -36,8 +36,8 @@
    */
 
   /* Please MAKE SURE all the table sizes are 16 Bytes aligned */
-  #define PE_INFO_TBL_SZ         16384  /*Supports max 400 PEs     */
-                                        /*[24 B Each + 4 B Header] */
+  #define PE_INFO_TBL_SZ         32768  /*Supports max 590 PEs     */
+                                        /*[48 B Each + 4236 B Header and ISA pool] */
   #define IOMMU_INFO_TBL_SZ      2048
   #define GIC_INFO_TBL_SZ        240000 /*Supports max 832 IIC info (GICH,CPUIF,RD,ITS,MSI,D)*/
                                         /*[48 B Each + 32 B Header]*/
@@ -54,6 +54,14 @@
   #define PCIE_INFO_TBL_SZ       512    /*Supports max 20 RC's    */
                                         /*[24 B Each + 4 B Header]*/
   #define MNG_INFO_TBL_SZ        1024   /*Size TBD*/
+  #define NUMA_INFO_TBL_SZ       12288  /*Supports 64 memory ranges, 1024 harts, 32 initiators*/
+                                        /*[24/8/8 B Each + 272 B Header]*/
+
+  /* All info tables are carved out of one arena that is freed in one go */
+  #define INFO_TBL_ARENA_SZ      (PE_INFO_TBL_SZ + IOMMU_INFO_TBL_SZ + GIC_INFO_TBL_SZ + \
+                                  TIMER_INFO_TBL_SZ + WD_INFO_TBL_SZ + PCIE_INFO_TBL_SZ + \
+                                  MNG_INFO_TBL_SZ + NUMA_INFO_TBL_SZ)
+  #define SCRATCH_ARENA_SZ       65536  /*Per-test scratch, reset after every test*/
 
 
   #ifdef _AARCH64_BUILD_
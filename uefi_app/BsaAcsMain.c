@@ -82,15 +82,12 @@ createPeInfoTable (
 
   UINT64   *PeInfoTable;
 
-/* allowing room for growth, at present each entry is 16 bytes, so we can support upto 511 PEs with 8192 bytes*/
-  Status = gBS->AllocatePool ( EfiBootServicesData,
-                               PE_INFO_TBL_SZ,
-                               (VOID **) &PeInfoTable );
+  PeInfoTable = val_arena_alloc(PE_INFO_TBL_SZ);
 
-  if (EFI_ERROR(Status))
+  if (PeInfoTable == NULL)
   {
-    Print(L"Allocate Pool failed %x\n", Status);
-    return Status;
+    Print(L"Arena allocation failed\n");
+    return EFI_OUT_OF_RESOURCES;
   }
 
   Status = val_hart_create_info_table(PeInfoTable);
@@ -106,14 +103,12 @@ createIommuInfoTable(
   EFI_STATUS  Status;
   UINT64      *IommuInfoTable;
 
-  Status = gBS->AllocatePool ( EfiBootServicesData,
-                               IOMMU_INFO_TBL_SZ,
-                               (VOID **) &IommuInfoTable );
+  IommuInfoTable = val_arena_alloc(IOMMU_INFO_TBL_SZ);
 
-  if (EFI_ERROR(Status))
+  if (IommuInfoTable == NULL)
   {
-    Print(L"Allocate Pool failed %x\n", Status);
-    return Status;
+    Print(L"Arena allocation failed\n");
+    return EFI_OUT_OF_RESOURCES;
   }
 
   Status = val_iommu_create_info_table(IommuInfoTable);
@@ -129,14 +124,12 @@ createGicInfoTable (
   EFI_STATUS Status;
   UINT64     *GicInfoTable;
 
-  Status = gBS->AllocatePool (EfiBootServicesData,
-                               GIC_INFO_TBL_SZ,
-                               (VOID **) &GicInfoTable);
+  GicInfoTable = val_arena_alloc(GIC_INFO_TBL_SZ);
 
-  if (EFI_ERROR(Status))
+  if (GicInfoTable == NULL)
   {
-    Print(L"Allocate Pool failed %x\n", Status);
-    return Status;
+    Print(L"Arena allocation failed\n");
+    return EFI_OUT_OF_RESOURCES;
   }
 
   Status = val_gic_create_info_table(GicInfoTable);
@@ -150,22 +143,40 @@ createMngInfoTable (
 
 )
 {
-  EFI_STATUS Status;
   UINT64     *MngInfoTable;
 
-  Status = gBS->AllocatePool (EfiBootServicesData,
-                               MNG_INFO_TBL_SZ,
-                               (VOID **) &MngInfoTable);
+  MngInfoTable = val_arena_alloc(MNG_INFO_TBL_SZ);
 
-  if (EFI_ERROR(Status))
+  if (MngInfoTable == NULL)
   {
-    Print(L"Allocate Pool failed %x\n", Status);
-    return Status;
+    Print(L"Arena allocation failed\n");
+    return EFI_OUT_OF_RESOURCES;
   }
 
   val_mng_create_info_table(MngInfoTable);
 
-  return Status;
+  return EFI_SUCCESS;
+
+}
+
+EFI_STATUS
+createNumaInfoTable (
+
+)
+{
+  UINT64     *NumaInfoTable;
+
+  NumaInfoTable = val_arena_alloc(NUMA_INFO_TBL_SZ);
+
+  if (NumaInfoTable == NULL)
+  {
+    Print(L"Arena allocation failed\n");
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  val_numa_create_info_table(NumaInfoTable);
+
+  return EFI_SUCCESS;
 
 }
 
@@ -175,20 +186,17 @@ createTimerInfoTable(
 )
 {
   UINT64   *TimerInfoTable;
-  EFI_STATUS Status;
 
-  Status = gBS->AllocatePool (EfiBootServicesData,
-                              TIMER_INFO_TBL_SZ,
-                              (VOID **) &TimerInfoTable);
+  TimerInfoTable = val_arena_alloc(TIMER_INFO_TBL_SZ);
 
-  if (EFI_ERROR(Status))
+  if (TimerInfoTable == NULL)
   {
-    Print(L"Allocate Pool failed %x\n", Status);
-    return Status;
+    Print(L"Arena allocation failed\n");
+    return EFI_OUT_OF_RESOURCES;
   }
   val_timer_create_info_table(TimerInfoTable);
 
-  return Status;
+  return EFI_SUCCESS;
 }
 
 
@@ -197,20 +205,17 @@ createWatchdogInfoTable(
 )
 {
   UINT64   *WdInfoTable;
-  EFI_STATUS Status;
 
-  Status = gBS->AllocatePool (EfiBootServicesData,
-                              WD_INFO_TBL_SZ,
-                              (VOID **) &WdInfoTable);
+  WdInfoTable = val_arena_alloc(WD_INFO_TBL_SZ);
 
-  if (EFI_ERROR(Status))
+  if (WdInfoTable == NULL)
   {
-    Print(L"Allocate Pool failed %x\n", Status);
-    return Status;
+    Print(L"Arena allocation failed\n");
+    return EFI_OUT_OF_RESOURCES;
   }
   val_wd_create_info_table(WdInfoTable);
 
-  return Status;
+  return EFI_SUCCESS;
 
 }
 
@@ -221,16 +226,12 @@ createPcieVirtInfoTable(
   UINT64   *PcieInfoTable;
   // UINT64   *IoVirtInfoTable;
 
-  EFI_STATUS Status;
-
-  Status = gBS->AllocatePool (EfiBootServicesData,
-                              PCIE_INFO_TBL_SZ,
-                              (VOID **) &PcieInfoTable);
+  PcieInfoTable = val_arena_alloc(PCIE_INFO_TBL_SZ);
 
-  if (EFI_ERROR(Status))
+  if (PcieInfoTable == NULL)
   {
-    Print(L"Allocate Pool failed %x\n", Status);
-    return Status;
+    Print(L"Arena allocation failed\n");
+    return EFI_OUT_OF_RESOURCES;
   }
   val_pcie_create_info_table(PcieInfoTable);
 
@@ -245,7 +246,7 @@ createPcieVirtInfoTable(
   // }
   // val_iovirt_create_info_table(IoVirtInfoTable);
 
-  return Status;
+  return EFI_SUCCESS;
 }
 
 /**** Reduced BSA
@@ -290,14 +291,20 @@ VOID
 freeBsaAcsMem()
 {
 
+  /* Drop the table pointers and the primary HART binding first, the
+     tables themselves go with the VAL arena */
   val_hart_free_info_table();
   val_iommu_free_info_table();
   val_gic_free_info_table();
   val_timer_free_info_table();
   val_wd_free_info_table();
   val_pcie_free_info_table();
+  val_mng_free_info_table();
+  val_numa_free_info_table();
   // val_iovirt_free_info_table();
   // val_peripheral_free_info_table();
+
+  val_arena_free();
   val_free_shared_mem();
 }
 
@@ -621,6 +628,10 @@ ShellAppMain (
   val_print(ACS_PRINT_TEST, "\n Starting tests with print level : %2d\n\n", g_print_level);
   val_print(ACS_PRINT_TEST, "\n Creating Platform Information Tables\n", 0);
 
+  Status = val_arena_create(INFO_TBL_ARENA_SZ, SCRATCH_ARENA_SZ);
+  if (Status)
+    return EFI_OUT_OF_RESOURCES;
+
 
 
 
@@ -641,6 +652,10 @@ ShellAppMain (
   if (Status)
     return Status;
 
+  Status = createNumaInfoTable();
+  if (Status)
+    return Status;
+
   val_print(ACS_PRINT_TEST, "\n Allocate shared mem and flush image\n", 0);
   val_allocate_shared_mem();
 
@@ -658,11 +673,14 @@ ShellAppMain (
   createPcieVirtInfoTable();
  // createPeripheralInfoTable();
 
+  /* Map all IMSIC, IOMMU and ECAM windows up front in merged ranges */
+  val_memory_map_mmio_windows();
+
 
   FlushImage();
 
   /***  Starting HART tests             ***/
-  // Status = val_hart_execute_tests(val_hart_get_num(), g_sw_view);
+  Status = val_hart_execute_tests(val_hart_get_num(), g_sw_view);
 
   /***  Starting Memory Map tests     ***/
   // Status |= val_memory_execute_tests(val_hart_get_num(), g_sw_view);
@@ -700,6 +718,9 @@ ShellAppMain (
   /***  Starting IOMMU tests            ***/
   Status |= val_iommu_execute_tests(val_hart_get_num(), g_sw_view);
 
+  /***  Starting Memory performance tests ***/
+  Status |= val_mem_perf_execute_tests(val_hart_get_num(), g_sw_view);
+
 print_test_status:
   val_print(ACS_PRINT_TEST, "\n     -------------------------------------------------------", 0);
   val_print(ACS_PRINT_TEST, "\n     Total Tests run  = %4d", g_bsa_tests_total);
@@ -48,6 +48,7 @@
 #define ACS_QOS_TEST_NUM_BASE        1000
 #define ACS_MNG_TEST_NUM_BASE        1100
 #define ACS_IOMMU_TEST_NUM_BASE      1200
+#define ACS_MEM_PERF_TEST_NUM_BASE   1300
 #define STATE_BIT   28
 #define STATE_MASK 0xF
 
@@ -134,6 +135,9 @@ val_run_test_payload(uint32_t test_num, uint32_t num_hart, void (*payload)(void)
 void
 val_data_cache_ops_by_va(addr_t addr, uint32_t type);
 
+void
+val_data_cache_ops_by_range(addr_t addr, uint64_t length, uint32_t type);
+
 void
 val_test_entry(void);
 
@@ -151,6 +155,7 @@ typedef enum {
     PCIE_MODULE,
     EXERCISER_MODULE,
     IOMMU_MODULE,
+    MEM_PERF_MODULE,
 } MODULE_ID_e;
 
 #endif
@@ -20,6 +20,15 @@
 
 #define MPIDR_AFF_MASK           (0xFF00FFFFFF)
 
+/* Fields read on every hart lookup, kept dense apart from the HART info table.
+   The array position is the hart index. */
+typedef struct {
+  uint64_t hart_id;
+  uint64_t imsic_base;
+} HART_HOT_ENTRY;
+
+extern HART_HOT_ENTRY *g_hart_hot_table;
+
 //
 //  AARCH64 processor exception types.
 //
@@ -57,6 +66,16 @@
 #define EXCEPT_RISCV_STORE_GUEST_PAGE_FAULT        23
 #define EXCEPT_RISCV_MAX_EXCEPTIONS                (EXCEPT_RISCV_STORE_GUEST_PAGE_FAULT)
 
+///
+/// RISC-V S-mode interrupt types, bit 31 set as in the UEFI CPU architecture protocol.
+///
+#define EXCEPT_RISCV_IRQ_0                         0x80000000
+#define EXCEPT_RISCV_IRQ_SOFT_FROM_SMODE           0x80000001
+#define EXCEPT_RISCV_IRQ_TIMER_FROM_SMODE          0x80000005
+#define EXCEPT_RISCV_IRQ_EXT_FROM_SMODE            0x80000009
+#define EXCEPT_RISCV_IRQ_GUEST_EXT                 0x8000000C
+#define EXCEPT_RISCV_MAX_IRQS                      (EXCEPT_RISCV_IRQ_GUEST_EXT)
+
 // AArch64 Exception Level
 #define AARCH64_EL2  0x8
 #define AARCH64_EL1  0x4
@@ -25,6 +25,43 @@
 #define IMSIC_MMIO_PAGE_LE             0x00
 #define IMSIC_MMIO_PAGE_BE             0x04
 
+/* 2047 identities plus identity 0, 64 per word */
+#define IMSIC_MAX_EIX_WORDS            32
+
+/* Snapshot of one S-level interrupt file */
+typedef struct {
+  uint32_t num_words;                   ///< Words of eie[] and eip[] in use
+  uint64_t eidelivery;
+  uint64_t eithreshold;
+  uint64_t eie[IMSIC_MAX_EIX_WORDS];
+  uint64_t eip[IMSIC_MAX_EIX_WORDS];
+} IMSIC_FILE_STATE;
+
+/* eidelivery value taking interrupts from an APLIC in direct mode, optional */
+#define IMSIC_EIDELIVERY_APLIC         0x40000000
+
+/* APLIC source modes */
+#define APLIC_SM_INACTIVE              0
+#define APLIC_SM_DETACHED              1
+#define APLIC_SM_EDGE_RISE             4
+#define APLIC_SM_EDGE_FALL             5
+#define APLIC_SM_LEVEL_HIGH            6
+#define APLIC_SM_LEVEL_LOW             7
+
+#define APLIC_MAX_SOURCES              1023
+#define APLIC_IE_WORDS                 32
+#define APLIC_IDC_NONE                 0xFFFFFFFF
+
+/* Registers of an APLIC domain a test changes */
+typedef struct {
+  uint32_t domaincfg;
+  uint32_t setie[APLIC_IE_WORDS];
+  uint32_t target[APLIC_MAX_SOURCES + 1];  ///< Indexed by source, the format follows domaincfg.DM
+  uint32_t idc;                           ///< IDC saved with the domain, APLIC_IDC_NONE for none
+  uint32_t idelivery;
+  uint32_t ithreshold;
+} APLIC_DOMAIN_STATE;
+
 uint32_t
 os_i001_entry(uint32_t num_hart);
 uint32_t
@@ -35,11 +72,52 @@ uint32_t
 os_i004_entry(uint32_t num_hart);
 uint32_t
 os_i005_entry(uint32_t num_hart);
+uint32_t
+os_i006_entry(uint32_t num_hart);
+uint32_t
+os_i007_entry(uint32_t num_hart);
+uint32_t
+os_i008_entry(uint32_t num_hart);
+uint32_t
+os_i009_entry(uint32_t num_hart);
+uint32_t
+os_i010_entry(uint32_t num_hart);
+uint32_t
+os_i011_entry(uint32_t num_hart);
+uint32_t
+os_i012_entry(uint32_t num_hart);
 
 void val_iic_imsic_eix_array_update (uint32_t base_id, uint32_t num_id, bool pend, bool val);
 void val_iic_imsic_eix_update (uint32_t id, bool pend, bool val);
 uint64_t val_iic_imsic_eix_read (uint32_t id, bool pend);
 uint32_t val_iic_imsic_eidelivery_update (uint32_t val);
 uint32_t val_iic_imsic_eithreshold_update (uint32_t val);
+uint32_t val_iic_imsic_eix_num_words (void);
+uint64_t val_iic_imsic_eix_word_read (uint32_t word, bool pend);
+void val_iic_imsic_eix_word_write (uint32_t word, bool pend, uint64_t val);
+void val_iic_imsic_file_save (IMSIC_FILE_STATE *state);
+void val_iic_imsic_file_restore (IMSIC_FILE_STATE *state);
+uint32_t val_iic_imsic_claim (void);
+void val_iic_ext_intr_enable (bool enable);
+void val_iic_aplic_domain_save (uint64_t base, uint32_t idc, APLIC_DOMAIN_STATE *state);
+void val_iic_aplic_domain_restore (uint64_t base, APLIC_DOMAIN_STATE *state);
+uint32_t val_iic_aplic_set_mode (uint64_t base, bool msi);
+uint32_t val_iic_aplic_source_config (uint64_t base, uint32_t source, uint32_t sm);
+uint32_t val_iic_aplic_find_free_source (uint64_t base, uint32_t num_sources);
+void val_iic_aplic_target_msi (uint64_t base, uint32_t source, uint32_t hart_index, uint32_t eiid);
+void val_iic_aplic_target_direct (uint64_t base, uint32_t source, uint32_t idc, uint32_t prio);
+void val_iic_aplic_source_enable (uint64_t base, uint32_t source, bool enable);
+void val_iic_aplic_source_pend (uint64_t base, uint32_t source, bool pend);
+void val_iic_aplic_idc_config (uint64_t base, uint32_t idc, bool deliver, uint32_t threshold);
+uint32_t val_iic_aplic_idc_claim (uint64_t base, uint32_t idc);
+uint64_t val_iic_guest_files (void);
+uint32_t val_iic_guest_file_select (uint32_t vgein);
+void val_iic_guest_file_save (IMSIC_FILE_STATE *state);
+void val_iic_guest_file_restore (IMSIC_FILE_STATE *state);
+void val_iic_guest_file_arm (uint32_t id);
+void val_iic_guest_eip_clear (uint32_t id);
+uint32_t val_iic_guest_claim (void);
+uint64_t val_iic_guest_pending (void);
+uint64_t val_iic_guest_intr_enable (uint64_t files);
 
 #endif
@@ -0,0 +1,182 @@
+/** @file
+ * Copyright (c) 2016-2018, 2021, 2023, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#ifndef __BSA_ACS_IIC_PERF_H__
+#define __BSA_ACS_IIC_PERF_H__
+
+#define IIC_PERF_SAMPLES            64      /* Deliveries timed per identity */
+#define IIC_PERF_MAX_IDS            4       /* Identities timed per hart */
+#define IIC_PERF_MAX_SAMPLES        (IIC_PERF_SAMPLES * IIC_PERF_MAX_IDS)
+#define IIC_PERF_BUCKETS            16      /* log2 of the latency in counter ticks */
+
+#define IIC_PERF_SAMPLE_TIMEOUT_US  1000    /* An MSI not taken by then counts as lost */
+#define IIC_PERF_HART_TIMEOUT_S     10      /* Per hart run time limit in seconds */
+
+#define IIC_PERF_IPI_MAX_HARTS      64      /* Harts covered by the IPI matrix */
+#define IIC_PERF_IPI_PING_ID        2       /* Identity sent to the receiver */
+#define IIC_PERF_IPI_PONG_ID        3       /* Identity the receiver's handler answers with */
+
+#define IIC_PERF_WIRED_EIID         4       /* Identity an APLIC in MSI mode forwards the source to */
+#define IIC_PERF_WIRED_PRIO         1       /* Source priority in direct mode */
+
+#define IIC_PERF_STORM_EIID         5       /* Identity the storm MSIs carry */
+#define IIC_PERF_STORM_MSIS         1024    /* MSIs sent per rate step */
+#define IIC_PERF_STORM_STEP_US      100000  /* Rate step time limit */
+#define IIC_PERF_STORM_STEPS        6       /* 1k, 10k, 100k, 500k, 1M MSIs/s and back to back */
+#define IIC_PERF_STORM_LOSS_PPM     10000   /* Loss above which a step counts as saturated */
+#define IIC_PERF_STORM_SELF         0xFFFFFFFF  /* Storm source is the hart itself, not an exerciser */
+#define IIC_PERF_OVERHEAD_BATCH     256     /* Operations timed together in the overhead loops */
+
+#define IIC_PERF_ARB_STEPS          6       /* Pending populations, 1 to 2047 identities */
+#define IIC_PERF_ARB_ROUNDS         16      /* Random identity sets per population */
+#define IIC_PERF_ARB_SEED           0x2545F4914F6CDD1DULL
+
+#define IIC_PERF_GUEST_EIID         6       /* Identity delivered to the guest files */
+#define IIC_PERF_GUEST_MAX_FILES    64      /* hstatus.VGEIN is 6 bits, file 0 is the S-level one */
+
+/* Delivery paths timed by the wired interrupt benchmark */
+typedef enum {
+  IIC_PERF_WIRED_DIRECT = 0,  ///< APLIC source, direct mode, claimed through the IDC
+  IIC_PERF_WIRED_MSI,         ///< APLIC source, MSI mode, forwarded to the interrupt file
+  IIC_PERF_WIRED_IMSIC,       ///< Same identity written straight to the interrupt file
+  IIC_PERF_WIRED_PATHS
+} IIC_PERF_WIRED_PATH_e;
+
+/* Nearest rank summary of a set of latencies, in counter ticks */
+typedef struct {
+  uint32_t count;
+  uint64_t min;
+  uint64_t median;
+  uint64_t p99;
+  uint64_t max;
+} IIC_PERF_STATS_t;
+
+/* Handshake between a hart's measurement loop and its interrupt handler,
+   one cache line per hart */
+typedef struct {
+  volatile uint64_t entry;    ///< Counter value on handler entry
+  volatile uint32_t claimed;  ///< Identity claimed through stopei
+  volatile uint32_t done;     ///< Set by the handler
+  volatile uint32_t *reply;   ///< seteipnum_le the handler answers to, NULL for none
+  volatile uint32_t reply_id; ///< Identity written to reply
+  volatile uint32_t armed;    ///< Interrupt file is set up to take interrupts
+  volatile uint64_t aplic;    ///< APLIC to claim from through the IDC, 0 to claim through stopei
+  volatile uint32_t idc;      ///< IDC of the hart in that APLIC
+  volatile uint32_t count;    ///< Interrupts taken, counted by the handler
+  uint8_t  pad[16];
+} IIC_PERF_SLOT_t;
+
+/* MSI write to handler entry latency of one hart */
+typedef struct {
+  uint32_t num_ids;
+  uint32_t id[IIC_PERF_MAX_IDS];
+  IIC_PERF_STATS_t stats[IIC_PERF_MAX_IDS];
+  IIC_PERF_STATS_t total;
+  uint32_t hist[IIC_PERF_BUCKETS];
+  uint32_t lost;              ///< MSIs not taken within IIC_PERF_SAMPLE_TIMEOUT_US
+  uint32_t misclaimed;        ///< stopei reported a different identity
+} IIC_PERF_MSI_RESULT_t;
+
+/* Source trigger to handler entry latency of one APLIC, per delivery path */
+typedef struct {
+  uint32_t aplic_id;
+  uint32_t source;
+  uint32_t supported[IIC_PERF_WIRED_PATHS];
+  IIC_PERF_STATS_t stats[IIC_PERF_WIRED_PATHS];
+  uint32_t lost[IIC_PERF_WIRED_PATHS];
+  uint32_t misclaimed[IIC_PERF_WIRED_PATHS];
+} IIC_PERF_WIRED_RESULT_t;
+
+/* One rate step of an interrupt storm */
+typedef struct {
+  uint32_t rate;              ///< Requested MSIs per second, 0 for back to back
+  uint32_t generated;
+  uint32_t delivered;         ///< Handler entries, MSIs merged while pending are not counted
+  uint64_t elapsed;           ///< Ticks from the first MSI to the last handler entry
+} IIC_PERF_STORM_STEP_t;
+
+/* Interrupt storm from one source at increasing rates */
+typedef struct {
+  uint32_t source;            ///< Exerciser instance or IIC_PERF_STORM_SELF
+  uint32_t num_steps;
+  uint32_t saturation;        ///< First step losing more than IIC_PERF_STORM_LOSS_PPM, num_steps if none
+  IIC_PERF_STORM_STEP_t step[IIC_PERF_STORM_STEPS];
+} IIC_PERF_STORM_RESULT_t;
+
+/* Cost of the IMSIC claim and complete operations, per batch of
+   IIC_PERF_OVERHEAD_BATCH operations, in counter ticks */
+typedef struct {
+  IIC_PERF_STATS_t pend;      ///< Setting the pending bit, the loop overhead of the others
+  IIC_PERF_STATS_t claim;     ///< stopei claim, pend subtracted
+  IIC_PERF_STATS_t complete;  ///< End of interrupt through val_gic_end_of_interrupt, pend subtracted
+} IIC_PERF_OVERHEAD_RESULT_t;
+
+/* Claim and complete cost at one pending population */
+typedef struct {
+  uint32_t pending;           ///< Identities pended at the start of each round
+  IIC_PERF_STATS_t drain;     ///< Ticks to claim and complete all of them
+} IIC_PERF_ARB_STEP_t;
+
+/* Priority and threshold arbitration of the S-level interrupt file against
+   a reference model, and its claim rate as the pending population grows */
+typedef struct {
+  uint32_t max_id;            ///< Highest implemented identity
+  uint32_t num_steps;
+  IIC_PERF_ARB_STEP_t step[IIC_PERF_ARB_STEPS];
+  uint32_t misordered;        ///< Claims other than the lowest pending identity below eithreshold
+  uint32_t unmasked;          ///< Claims at or above eithreshold
+  uint32_t lost;              ///< Pended identities the timed drain did not claim
+} IIC_PERF_ARB_RESULT_t;
+
+/* MSI to handler latency of every guest interrupt file of one hart,
+   against the S-level file of the same hart */
+typedef struct {
+  uint64_t files;             ///< Implemented guest files, bit VGEIN set for each
+  IIC_PERF_STATS_t s_level;
+  IIC_PERF_STATS_t file[IIC_PERF_GUEST_MAX_FILES];  ///< Indexed by VGEIN
+  uint32_t lost;
+  uint32_t misclaimed;
+} IIC_PERF_GUEST_RESULT_t;
+
+/* Round trip latency of every ordered hart pair, row is the sender */
+typedef struct {
+  uint32_t num_hart;
+  uint32_t lost;
+  IIC_PERF_STATS_t *pair;     ///< num_hart x num_hart, diagonal unused
+} IIC_PERF_IPI_RESULT_t;
+
+uint32_t val_iic_perf_init(void);
+void     val_iic_perf_free(void);
+IIC_PERF_SLOT_t *val_iic_perf_slot(uint32_t index);
+void     val_iic_perf_stats(uint64_t *samples, uint32_t count, IIC_PERF_STATS_t *stats);
+uint64_t val_iic_perf_ticks_to_ns(uint64_t ticks);
+uint32_t val_iic_perf_msi_latency(IIC_PERF_MSI_RESULT_t *result);
+void     val_iic_perf_report_msi(uint32_t index, IIC_PERF_MSI_RESULT_t *result);
+uint32_t val_iic_perf_ipi_matrix(uint32_t test_num, IIC_PERF_IPI_RESULT_t *result);
+void     val_iic_perf_report_ipi(IIC_PERF_IPI_RESULT_t *result);
+uint32_t val_iic_perf_wired_latency(uint32_t aplic, IIC_PERF_WIRED_RESULT_t *result);
+void     val_iic_perf_report_wired(IIC_PERF_WIRED_RESULT_t *result);
+uint32_t val_iic_perf_storm(uint32_t source, IIC_PERF_STORM_RESULT_t *result);
+void     val_iic_perf_report_storm(IIC_PERF_STORM_RESULT_t *result);
+uint32_t val_iic_perf_overhead(IIC_PERF_OVERHEAD_RESULT_t *result);
+void     val_iic_perf_report_overhead(IIC_PERF_OVERHEAD_RESULT_t *result);
+uint32_t val_iic_perf_arbitration(IIC_PERF_ARB_RESULT_t *result);
+void     val_iic_perf_report_arbitration(IIC_PERF_ARB_RESULT_t *result);
+uint32_t val_iic_perf_guest_latency(IIC_PERF_GUEST_RESULT_t *result);
+void     val_iic_perf_report_guest(uint32_t index, IIC_PERF_GUEST_RESULT_t *result);
+
+#endif
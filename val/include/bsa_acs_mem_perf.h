@@ -0,0 +1,79 @@
+/** @file
+ * Copyright (c) 2016-2018, 2021, 2023, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#ifndef __BSA_ACS_MEM_PERF_H__
+#define __BSA_ACS_MEM_PERF_H__
+
+/* Last level cache size used to size the working sets, when not known from firmware */
+#ifndef MEM_PERF_LLC_SIZE
+#define MEM_PERF_LLC_SIZE           (32 * 1024 * 1024)
+#endif
+
+#define MEM_PERF_MAX_REGIONS        4         /* Normal memory regions characterised */
+#define MEM_PERF_BUF_ALIGN          0x200000  /* Buffers are placed on 2MiB boundaries */
+#define MEM_PERF_LINE_SIZE          64        /* Pointer chase stride */
+
+#define MEM_PERF_STREAM_NTIMES      10        /* Best of N, as in STREAM */
+#define MEM_PERF_STREAM_SCALAR      3
+
+#define MEM_PERF_CHASE_MIN          0x1000    /* 4KiB */
+#define MEM_PERF_CHASE_LOADS        (1 << 20) /* Dependent loads timed per working set */
+#define MEM_PERF_CHASE_SEED         0x2545F4914F6CDD1DULL
+#define MEM_PERF_MAX_POINTS         24
+
+#define MEM_PERF_HART_TIMEOUT_S     120       /* Per hart run time limit in seconds */
+
+typedef enum {
+  MEM_PERF_COPY = 0,
+  MEM_PERF_SCALE,
+  MEM_PERF_ADD,
+  MEM_PERF_TRIAD,
+  MEM_PERF_STREAM_KERNELS
+} MEM_PERF_KERNEL_e;
+
+/* Test buffer placed inside one normal memory region */
+typedef struct {
+  uint32_t instance;          ///< Normal memory region instance
+  uint64_t region_base;       ///< Base address of the region from the memory info table
+  uint32_t node;              ///< Proximity domain of the buffer, NUMA_NODE_ANY if unknown
+  uint64_t base;              ///< Buffer base address
+  uint64_t size;              ///< Buffer size in bytes
+  uint64_t stream_elems;      ///< 64-bit elements in each of the three STREAM arrays
+  uint64_t chase_max;         ///< Largest pointer chase working set in bytes
+} MEM_PERF_REGION_t;
+
+/* Measurements taken by one hart on one region */
+typedef struct {
+  uint64_t stream_mbps[MEM_PERF_STREAM_KERNELS];
+  uint32_t num_points;
+  uint64_t chase_size[MEM_PERF_MAX_POINTS];
+  uint64_t chase_ps[MEM_PERF_MAX_POINTS];   ///< Average load to use latency in picoseconds
+} MEM_PERF_RESULT_t;
+
+uint32_t val_mem_perf_region_get(uint32_t instance, MEM_PERF_REGION_t *region);
+void     val_mem_perf_region_put(MEM_PERF_REGION_t *region);
+void     val_mem_perf_stream(MEM_PERF_REGION_t *region, MEM_PERF_RESULT_t *result);
+void     val_mem_perf_latency(MEM_PERF_REGION_t *region, MEM_PERF_RESULT_t *result);
+void     val_mem_perf_report_stream(uint32_t index, MEM_PERF_REGION_t *region,
+                                    MEM_PERF_RESULT_t *result);
+void     val_mem_perf_report_latency(uint32_t index, MEM_PERF_REGION_t *region,
+                                     MEM_PERF_RESULT_t *result);
+
+uint32_t os_mp001_entry(uint32_t num_hart);
+uint32_t os_mp002_entry(uint32_t num_hart);
+
+#endif
@@ -27,6 +27,7 @@ void val_memory_unmap(void *ptr);
 void *val_memory_alloc(uint32_t size);
 void *val_memory_calloc(uint32_t num, uint32_t size);
 void *val_memory_alloc_cacheable(uint32_t bdf, uint32_t size, void **pa);
+void *val_memory_alloc_cacheable_node(uint32_t bdf, uint32_t size, void **pa, uint32_t node);
 void val_memory_free(void *addr);
 int val_memory_compare(void *src, void *dest, uint32_t len);
 void val_memory_set(void *buf, uint32_t size, uint8_t value);
@@ -35,8 +36,11 @@ void *val_memory_virt_to_phys(void *va);
 void *val_memory_phys_to_virt(uint64_t pa);
 uint32_t val_memory_page_size(void);
 void *val_memory_alloc_pages(uint32_t num_pages);
+void *val_memory_alloc_pages_in_range(uint64_t base, uint64_t size, uint32_t num_pages);
+void *val_memory_alloc_pages_node(uint32_t num_pages, uint32_t node);
 void val_memory_free_pages(void *page_base, uint32_t num_pages);
 addr_t val_memory_get_addr(MEMORY_INFO_e mem_type, uint32_t instance, uint64_t *attr);
+uint64_t val_memory_get_size(MEMORY_INFO_e mem_type, uint32_t instance);
 void *val_aligned_alloc(uint32_t alignment, uint32_t size);
 void val_memory_free_aligned(void *addr);
 
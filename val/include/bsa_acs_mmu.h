@@ -18,13 +18,9 @@
 #ifndef __BSA_AVS_MMU_H__
 #define __BSA_AVS_MMU_H__
 
-extern void val_mair_write(uint64_t value, uint64_t el_num);
-extern void val_tcr_write(uint64_t value, uint64_t el_num);
-extern void val_ttbr0_write(uint64_t value, uint64_t el_num);
-extern void val_sctlr_write(uint64_t value, uint64_t el_num);
-extern uint64_t val_sctlr_read(uint64_t el_num);
-extern uint64_t val_ttbr0_read(uint64_t el_num);
-extern uint64_t val_read_current_el(void);
+/* satp fields, the MODE values are PGT_MODE_* from bsa_acs_pgt.h */
+#define SATP_MODE_SHIFT  60
+#define SATP_PPN_MASK    ((0x1ull << 44) - 1)
 
 extern uint64_t tt_l0_base[];
 
@@ -21,38 +21,73 @@
 #define PGT_STAGE1 1
 #define PGT_STAGE2 2
 
-#define PGT_ENTRY_TABLE_MASK (0x1 << 1)
-#define PGT_ENTRY_VALID_MASK  0x1
-#define PGT_ENTRY_PAGE_MASK  (0x1 << 1)
-#define PGT_ENTRY_BLOCK_MASK (0x0 << 1)
+/* RISC-V page table entry fields, common to Sv39/Sv48/Sv57 and their x4 G-stage forms */
+#define PGT_PTE_V             (0x1ull << 0)
+#define PGT_PTE_R             (0x1ull << 1)
+#define PGT_PTE_W             (0x1ull << 2)
+#define PGT_PTE_X             (0x1ull << 3)
+#define PGT_PTE_U             (0x1ull << 4)
+#define PGT_PTE_G             (0x1ull << 5)
+#define PGT_PTE_A             (0x1ull << 6)
+#define PGT_PTE_D             (0x1ull << 7)
+#define PGT_PTE_N             (0x1ull << 63)
 
-#define PGT_ENTRY_TYPE_MASK   0x3ULL
-#define PGT_ENTRY_TYPE_TABLE  0x3
-#define PGT_ENTRY_TYPE_BLOCK  0x1
-#define PGT_ENTRY_TYPE_PAGE   0x3
+#define PGT_PTE_PPN_SHIFT     10
+#define PGT_PTE_PPN_MASK      (((0x1ull << 44) - 1) << PGT_PTE_PPN_SHIFT)
+#define PGT_PTE_LEAF_MASK     (PGT_PTE_R | PGT_PTE_W | PGT_PTE_X)
 
-#define IS_PGT_ENTRY_PAGE(val)  ((val & PGT_ENTRY_TYPE_MASK) == PGT_ENTRY_TYPE_PAGE)
-#define IS_PGT_ENTRY_BLOCK(val) ((val & PGT_ENTRY_TYPE_MASK) == PGT_ENTRY_TYPE_BLOCK)
-#define IS_PGT_ENTRY_TABLE(val) ((val & PGT_ENTRY_TYPE_MASK) == PGT_ENTRY_TYPE_TABLE)
-#define IS_PGT_ENTRY_INVALID(val) !(val & PGT_ENTRY_VALID_MASK)
+/* Svpbmt page based memory types */
+#define PGT_PTE_PBMT_SHIFT    61
+#define PGT_PTE_PBMT_MASK     (0x3ull << PGT_PTE_PBMT_SHIFT)
+#define PGT_PTE_PBMT_PMA      (0x0ull << PGT_PTE_PBMT_SHIFT)
+#define PGT_PTE_PBMT_NC       (0x1ull << PGT_PTE_PBMT_SHIFT)
+#define PGT_PTE_PBMT_IO       (0x2ull << PGT_PTE_PBMT_SHIFT)
+
+#define PGT_PTE_TO_PA(val)    ((((val) & PGT_PTE_PPN_MASK) >> PGT_PTE_PPN_SHIFT) << 12)
+#define PGT_PA_TO_PTE(pa)     ((((uint64_t)(pa)) >> 12) << PGT_PTE_PPN_SHIFT)
+
+#define IS_PGT_ENTRY_INVALID(val) !((val) & PGT_PTE_V)
+#define IS_PGT_ENTRY_LEAF(val)    (((val) & PGT_PTE_V) && ((val) & PGT_PTE_LEAF_MASK))
+#define IS_PGT_ENTRY_TABLE(val)   (((val) & (PGT_PTE_V | PGT_PTE_LEAF_MASK)) == PGT_PTE_V)
 
 #define PGT_DESC_SIZE 8
-#define PGT_DESC_ATTR_UPPER_MASK ((0x1ull << 12) - 1) << 52
-#define PGT_DESC_ATTR_LOWER_MASK ((0x1ull << 10) - 1) << 2
+#define PGT_DESC_ATTR_UPPER_MASK (PGT_PTE_N | PGT_PTE_PBMT_MASK)
+#define PGT_DESC_ATTR_LOWER_MASK ((0x1ull << PGT_PTE_PPN_SHIFT) - 1)
 #define PGT_DESC_ATTRIBUTES_MASK (PGT_DESC_ATTR_UPPER_MASK | PGT_DESC_ATTR_LOWER_MASK)
 #define PGT_DESC_ATTRIBUTES(val) (val & PGT_DESC_ATTRIBUTES_MASK)
 
-#define PGT_STAGE1_AP_RO (0x3ull << 6)
-#define PGT_STAGE1_AP_RW (0x1ull << 6)
-#define PGT_STAGE2_AP_RO (0x1ull << 6)
-#define PGT_STAGE2_AP_RW (0x3ull << 6)
+/* Leaf permissions. G-stage leaves must have U set to be usable by the guest. */
+#define PGT_STAGE1_AP_RO (PGT_PTE_R | PGT_PTE_A)
+#define PGT_STAGE1_AP_RW (PGT_PTE_R | PGT_PTE_W | PGT_PTE_A | PGT_PTE_D)
+#define PGT_STAGE2_AP_RO (PGT_STAGE1_AP_RO | PGT_PTE_U)
+#define PGT_STAGE2_AP_RW (PGT_STAGE1_AP_RW | PGT_PTE_U)
+
+/* satp.MODE / hgatp.MODE encodings */
+#define PGT_MODE_BARE 0
+#define PGT_MODE_SV39 8
+#define PGT_MODE_SV48 9
+#define PGT_MODE_SV57 10
 
-#define PGT_LEVEL_MAX 4
+/* Input address sizes, G-stage adds two bits of root table index */
+#define PGT_IAS_SV39        39
+#define PGT_IAS_SV48        48
+#define PGT_IAS_SV57        57
+#define PGT_GSTAGE_EXTRA_BITS 2
+#define PGT_GSTAGE_ROOT_PAGES 4
 
+#define PGT_LEVEL_MAX 5
+
+/* RISC-V level numbering, level 0 maps 4KiB pages */
 #define PGT_LEVEL_0   0
 #define PGT_LEVEL_1   1
 #define PGT_LEVEL_2   2
 #define PGT_LEVEL_3   3
+#define PGT_LEVEL_4   4
+
+#define PGT_PAGE_SHIFT      12
+#define PGT_BITS_PER_LEVEL  9
+#define PGT_MEGAPAGE_SIZE   (0x1ull << 21)
+#define PGT_GIGAPAGE_SIZE   (0x1ull << 30)
 
 #define MAX_ENTRIES_4K      512L
 #define MAX_ENTRIES_16K     2048L
@@ -65,5 +100,6 @@
 uint32_t val_pgt_create(memory_region_descriptor_t *mem_desc, pgt_descriptor_t *pgt_desc);
 void val_pgt_destroy(pgt_descriptor_t pgt_desc);
 uint64_t val_pgt_get_attributes(pgt_descriptor_t pgt_desc, uint64_t virtual_address, uint64_t *attributes);
+uint32_t val_pgt_get_mode(pgt_descriptor_t pgt_desc);
 
 #endif
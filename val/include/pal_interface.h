@@ -188,8 +188,23 @@ int32_t pal_psci_get_conduit(void);
 **/
 typedef struct {
   uint32_t num_of_hart;
+  uint32_t num_of_isa;        ///< Distinct ISA strings in isa_pool
+  uint32_t isa_pool_used;     ///< Bytes of isa_pool in use
 }HART_INFO_HDR;
 
+#define HART_MAX_ISA_STRINGS   16
+#define HART_ISA_POOL_SIZE     4096
+#define HART_ISA_NONE          0xFFFFFFFF
+#define HART_ID_INVALID        0xFFFFFFFFFFFFFFFFULL
+
+/**
+  @brief  ISA string shared by all HARTs that reference the same RHCT ISA node
+**/
+typedef struct {
+  uint32_t rhct_offset;      ///< Offset of the ISA string node in the RHCT
+  uint32_t pool_offset;      ///< Offset of the null-terminated string in isa_pool
+}HART_ISA_ENTRY;
+
 /**
   @brief  structure instance for HART entry
 **/
@@ -200,11 +215,14 @@ typedef struct {
   uint32_t   ext_intc_id;     ///< The unique ID of the external interrupts connected to this hart.
   uint64_t   imsic_base;      ///< Physical base address of the Incoming MSI Controller (IMSIC) MMIO region of this hart.
   uint32_t   imsic_size;      ///< Size in bytes of the IMSIC MMIO region of this hart.
-  char8_t    isa_string[512]; ///< Null-terminated ASCII Instruction Set Architecture (ISA) string for this hart.
+  uint32_t   cbom_block_size; ///< Zicbom cache block size in bytes from the RHCT CMO node, 0 if absent.
+  uint32_t   isa_index;       ///< Index into isa[] of the HART_INFO_TABLE, HART_ISA_NONE if absent.
 }HART_INFO_ENTRY;
 
 typedef struct {
   HART_INFO_HDR    header;
+  HART_ISA_ENTRY   isa[HART_MAX_ISA_STRINGS];
+  char8_t          isa_pool[HART_ISA_POOL_SIZE];
   HART_INFO_ENTRY  hart_info[];
 }HART_INFO_TABLE;
 
@@ -220,6 +238,7 @@ typedef struct {
 }PE_TCR_BF;
 
 void pal_hart_create_info_table(HART_INFO_TABLE *hart_info_table);
+uint64_t pal_hart_get_boot_hart_id(void);
 
 /**
   @brief  Structure to Pass SMC arguments. Return data is also filled into
@@ -295,6 +314,11 @@ typedef struct {
   /* RV porting */
   UINT16   supervisor_intr_num;
   UINT16   guest_intr_num;
+  UINT8    guest_index_bits;    ///< IMSIC layout from the MADT, used to form APLIC MSI targets
+  UINT8    hart_index_bits;
+  UINT8    group_index_bits;
+  UINT8    group_index_shift;
+  uint32_t num_aplic;
 } GIC_INFO_HDR;
 
 typedef enum {
@@ -304,7 +328,12 @@ typedef enum {
   ENTRY_TYPE_GICR_GICRD,
   ENTRY_TYPE_GICITS,
   ENTRY_TYPE_GIC_MSI_FRAME,
-  ENTRY_TYPE_GICH
+  ENTRY_TYPE_GICH,
+
+  /* RV porting */
+  ENTRY_TYPE_RINTC,
+  ENTRY_TYPE_PLIC,
+  ENTRY_TYPE_APLIC
 } GIC_INFO_TYPE_e;
 
 /* Interrupt Trigger Type */
@@ -326,6 +355,9 @@ typedef struct {
   uint32_t flags;
   uint32_t spi_count;
   uint32_t spi_base;
+
+  /* RV porting */
+  uint32_t num_idc;   /* APLIC interrupt delivery controls, 0 in MSI-only domains */
 }GIC_INFO_ENTRY;
 
 /**
@@ -352,8 +384,10 @@ typedef struct {
 } GIC_ITS_INFO;
 
 void     pal_gic_create_info_table(GIC_INFO_TABLE *gic_info_table);
+/* isr is called with (Source, Context), Source being the interrupt ID */
 uint32_t pal_gic_install_isr(uint32_t int_id, void (*isr)(void));
 void pal_gic_end_of_interrupt(uint32_t int_id);
+uint32_t pal_gic_claim_interrupt(void);
 uint32_t pal_gic_request_irq(unsigned int irq_num, unsigned int mapped_irq_num, void *isr);
 void pal_gic_free_irq(unsigned int irq_num, unsigned int mapped_irq_num);
 uint32_t pal_gic_set_intr_trigger(uint32_t int_id, INTR_TRIGGER_INFO_TYPE_e trigger_type);
@@ -408,6 +442,7 @@ typedef struct {
 
 void pal_timer_create_info_table(TIMER_INFO_TABLE *timer_info_table);
 uint64_t pal_timer_get_counter_frequency(void);
+uint64_t pal_timer_get_counter(void);
 
 /** Watchdog tests related definitions **/
 
@@ -796,6 +831,7 @@ void    *pal_mem_alloc_cacheable(uint32_t bdf, uint32_t size, void **pa);
 void     pal_mem_free(void *buffer);
 int      pal_mem_compare(void *src, void *dest, uint32_t len);
 void     pal_mem_set(void *buf, uint32_t size, uint8_t value);
+void     pal_mem_enable_vector(uint32_t enable);
 void     pal_mem_free_cacheable(uint32_t bdf, unsigned int size, void *va, void *pa);
 void    *pal_mem_virt_to_phys(void *va);
 void    *pal_mem_phys_to_virt(uint64_t pa);
@@ -811,11 +847,12 @@ uint16_t pal_mmio_read16(uint64_t addr);
 
 uint32_t pal_mem_page_size(void);
 void    *pal_mem_alloc_pages(uint32_t num_pages);
+void    *pal_mem_alloc_pages_in_range(uint64_t base, uint64_t size, uint32_t num_pages);
 void     pal_mem_free_pages(void *page_base, uint32_t num_pages);
 void    *pal_aligned_alloc(uint32_t alignment, uint32_t size);
 void     pal_mem_free_aligned(void *buffer);
 
-void     pal_mem_map_add_mmio(uint64_t  Address, uint64_t  Length);
+uint32_t pal_mem_map_add_mmio(uint64_t  Address, uint64_t  Length);
 
 uint32_t pal_mmio_read(uint64_t addr);
 uint64_t pal_mmio_read64(uint64_t addr);
@@ -830,6 +867,8 @@ uint64_t pal_hart_get_far(void *context);
 uint64_t pal_hart_get_hstatus (void);
 void     pal_hart_set_hstatus (uint64_t val);
 void     pal_hart_data_cache_ops_by_va(uint64_t addr, uint32_t type);
+void     pal_hart_data_cache_ops_by_range(uint64_t addr, uint64_t length, uint32_t type,
+                                          uint32_t block_size);
 
 #define CLEAN_AND_INVALIDATE  0x1
 #define CLEAN                 0x2
@@ -985,5 +1024,43 @@ typedef struct {
 
 void pal_mng_create_info_table(MNG_INFO_TABLE *mng_info_table);
 
+/**  NUMA related Definitions **/
+#define NUMA_MAX_DOMAINS      16    /* SLIT distances kept for the first 16 domains */
+#define NUMA_MAX_MEM_RANGES   64
+#define NUMA_MAX_HARTS        1024
+#define NUMA_MAX_INITIATORS   32
+#define NUMA_NODE_ANY         0xFFFFFFFF
+#define NUMA_DISTANCE_LOCAL   10
+
+typedef struct {
+  uint32_t    prox_domain;
+  uint32_t    flags;                  ///< SRAT memory affinity flags
+  uint64_t    base;
+  uint64_t    length;
+}NUMA_MEM_ENTRY;
+
+typedef struct {
+  uint32_t    prox_domain;
+  uint32_t    acpi_processor_uid;     ///< From the SRAT RINTC affinity structure
+}NUMA_HART_ENTRY;
+
+typedef struct {
+  uint32_t    prox_domain;
+  uint32_t    bdf;                    ///< PCI generic initiator, PCIE_CREATE_BDF format
+}NUMA_INITIATOR_ENTRY;
+
+typedef struct {
+  uint32_t              num_domains;  ///< 0 when the platform has no SRAT
+  uint32_t              num_mem;
+  uint32_t              num_hart;
+  uint32_t              num_initiator;
+  uint8_t               distance[NUMA_MAX_DOMAINS][NUMA_MAX_DOMAINS]; ///< SLIT, 0 if absent
+  NUMA_MEM_ENTRY        mem[NUMA_MAX_MEM_RANGES];
+  NUMA_HART_ENTRY       hart[NUMA_MAX_HARTS];
+  NUMA_INITIATOR_ENTRY  initiator[NUMA_MAX_INITIATORS];
+}NUMA_INFO_TABLE;
+
+void pal_numa_create_info_table(NUMA_INFO_TABLE *numa_info_table);
+
 #endif
 
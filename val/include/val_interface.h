@@ -68,12 +68,117 @@ void val_dump_dtb(void);
 uint64_t val_time_delay_ms(uint64_t time_ms);
 
 /* VAL HART APIs */
+typedef enum {
+  /* single letter extensions, bit n is letter 'a' + n */
+  EXT_A = 0,
+  EXT_B,
+  EXT_C,
+  EXT_D,
+  EXT_E,
+  EXT_F,
+  EXT_G,
+  EXT_H,
+  EXT_I,
+  EXT_J,
+  EXT_K,
+  EXT_L,
+  EXT_M,
+  EXT_N,
+  EXT_O,
+  EXT_P,
+  EXT_Q,
+  EXT_R,
+  EXT_S,
+  EXT_T,
+  EXT_U,
+  EXT_V,
+  EXT_W,
+  EXT_X,
+  EXT_Y,
+  EXT_Z,
+  /* multi-letter extensions */
+  EXT_ZICSR,
+  EXT_ZIFENCEI,
+  EXT_ZICNTR,
+  EXT_ZIHPM,
+  EXT_ZICBOM,
+  EXT_ZICBOZ,
+  EXT_ZICBOP,
+  EXT_ZIHINTPAUSE,
+  EXT_ZIHINTNTL,
+  EXT_ZICOND,
+  EXT_ZIMOP,
+  EXT_ZICCAMOA,
+  EXT_ZICCIF,
+  EXT_ZICCLSM,
+  EXT_ZICCRSE,
+  EXT_ZIC64B,
+  EXT_ZAWRS,
+  EXT_ZACAS,
+  EXT_ZAAMO,
+  EXT_ZALRSC,
+  EXT_ZFA,
+  EXT_ZFH,
+  EXT_ZFHMIN,
+  EXT_ZBA,
+  EXT_ZBB,
+  EXT_ZBC,
+  EXT_ZBS,
+  EXT_ZKT,
+  EXT_ZCB,
+  EXT_ZCMOP,
+  EXT_ZVFHMIN,
+  EXT_ZVBB,
+  EXT_ZVKT,
+  EXT_SSAIA,
+  EXT_SMAIA,
+  EXT_SSQOSID,
+  EXT_SSCOFPMF,
+  EXT_SSTC,
+  EXT_SSCCPTR,
+  EXT_SSTVECD,
+  EXT_SSTVALA,
+  EXT_SSU64XL,
+  EXT_SSNPM,
+  EXT_SSCOUNTERENW,
+  EXT_SSSTATEEN,
+  EXT_SMSTATEEN,
+  EXT_SSCSRIND,
+  EXT_SMCSRIND,
+  EXT_SVINVAL,
+  EXT_SVNAPOT,
+  EXT_SVPBMT,
+  EXT_SVADU,
+  EXT_SVADE,
+  EXT_SHCOUNTERENW,
+  EXT_SHVSTVALA,
+  EXT_SHTVALA,
+  EXT_SHVSTVECD,
+  EXT_SHVSATPA,
+  EXT_SHGATPA,
+  EXT_SDTRIG,
+  EXT_MAX
+} HART_ISA_EXT_e;
+
+#define HART_ISA_EXT_WORDS  ((EXT_MAX + 63) / 64)
+
 uint32_t val_hart_execute_tests(uint32_t num_hart, uint32_t *g_sw_view);
 uint32_t val_hart_create_info_table(uint64_t *hart_info_table);
 void     val_hart_free_info_table(void);
 uint32_t val_hart_get_num(void);
 char8_t *val_hart_get_isa_string (uint32_t index);
+uint32_t val_hart_get_isa_index (uint32_t index);
+void     val_hart_isa_parse_all (void);
+uint32_t val_hart_has_ext (uint32_t index, HART_ISA_EXT_e ext);
+uint32_t val_hart_all_have_ext (HART_ISA_EXT_e ext);
+uint32_t val_hart_get_ext_version (uint32_t index, HART_ISA_EXT_e ext);
+void     val_hart_get_ext_mask (uint32_t index, uint64_t *mask);
+void     val_hart_get_common_ext_mask (uint64_t *mask);
+char8_t *val_hart_get_ext_name (HART_ISA_EXT_e ext);
 uint64_t val_hart_get_imsic_base (int32_t index);
+uint32_t val_hart_get_ext_intc_id (uint32_t index);
+uint32_t val_hart_get_acpi_uid (uint32_t index);
+uint32_t val_hart_get_cbom_block_size (void);
 uint64_t val_hart_get_mpid(void);
 uint32_t val_hart_get_index_mpid(uint64_t hart_id);
 uint32_t val_hart_install_esr(uint32_t exception_type, void (*esr)(uint64_t, void *));
@@ -81,6 +186,9 @@ uint32_t val_hart_get_primary_index(void);
 uint64_t val_get_primary_mpidr(void);
 
 void     val_execute_on_pe(uint32_t index, void (*payload)(void), uint64_t args);
+uint32_t val_hart_start_payload(uint32_t test_num, uint32_t index, void (*payload)(void));
+uint32_t val_hart_run_payload(uint32_t test_num, uint32_t index, void (*payload)(void),
+                              uint32_t timeout_s);
 int      val_suspend_pe(uint64_t entry, uint32_t context_id);
 
 /* IOMMU HART APIs */
@@ -94,6 +202,9 @@ void     val_iommu_free_info_table(void);
 uint32_t val_iommu_get_num(void);
 uint64_t val_iommu_get_info(int32_t index, IOMMU_INFO_e info_type);
 
+/* Memory performance VAL APIs */
+uint32_t val_mem_perf_execute_tests(uint32_t num_hart, uint32_t *g_sw_view);
+
 /* IIC VAL APIs */
 uint32_t    val_gic_create_info_table(uint64_t *gic_info_table);
 
@@ -119,6 +230,7 @@ void     val_gic_free_info_table(void);
 uint32_t val_iic_execute_tests(uint32_t num_hart, uint32_t *g_sw_view);
 uint32_t val_gic_install_isr(uint32_t int_id, void (*isr)(void));
 uint32_t val_gic_end_of_interrupt(uint32_t int_id);
+uint32_t val_gic_claim_interrupt(void);
 uint32_t val_gic_route_interrupt_to_pe(uint32_t int_id, uint64_t mpidr);
 uint32_t val_gic_get_interrupt_state(uint32_t int_id);
 void val_gic_clear_interrupt(uint32_t int_id);
@@ -139,6 +251,22 @@ void val_gic_free_msi(uint32_t bdf, uint32_t device_id, uint32_t its_id,
 uint32_t val_gic_max_supervisor_intr_num(void);
 uint32_t val_gic_max_guest_intr_num(void);
 
+void     val_gic_isr_report(void);
+
+/* APLIC APIs */
+typedef enum {
+  APLIC_INFO_ID = 1,
+  APLIC_INFO_BASE,
+  APLIC_INFO_LENGTH,
+  APLIC_INFO_NUM_IDC,
+  APLIC_INFO_NUM_SOURCES,
+  APLIC_INFO_GSI_BASE
+} APLIC_INFO_e;
+
+uint32_t val_iic_aplic_get_num(void);
+uint64_t val_iic_aplic_get_info(uint32_t index, APLIC_INFO_e type);
+uint32_t val_iic_imsic_msi_hart_index(uint32_t index);
+
 /* GICv2m APIs */
 typedef enum {
   V2M_MSI_FRAME_ID = 1,
@@ -187,6 +315,7 @@ uint32_t val_timer_skip_if_cntbase_access_not_allowed(uint64_t index);
 void val_platform_timer_get_entry_index(uint64_t instance, uint32_t *block, uint32_t *index);
 uint64_t val_get_phy_el2_timer_count(void);
 uint64_t val_get_phy_el1_timer_count(void);
+uint64_t val_timer_get_counter(void);
 
 /* Watchdog VAL APIs */
 typedef enum {
@@ -412,6 +541,15 @@ uint64_t val_memory_get_info(addr_t addr, uint64_t *attr);
 uint64_t val_memory_get_unpopulated_addr(addr_t *addr, uint32_t instance);
 uint64_t val_get_max_memory(void);
 
+/* VAL arena APIs */
+uint32_t val_arena_create(uint32_t table_size, uint32_t scratch_size);
+void    *val_arena_alloc(uint32_t size);
+void    *val_scratch_alloc(uint32_t size);
+void     val_scratch_reset(void);
+void     val_arena_free(void);
+void     val_info_table_free(void *table);
+void     val_memory_map_mmio_windows(void);
+
 /* PCIe Exerciser tests */
 uint32_t val_exerciser_execute_tests(uint32_t *g_sw_view);
 
@@ -427,7 +565,18 @@ typedef enum {
 } MNG_INFO_e;
 
 void val_mng_create_info_table(uint64_t *mng_info_table);
+void val_mng_free_info_table(void);
 uint32_t val_mng_execute_tests(uint32_t num_hart, uint32_t *g_sw_view);
 uint32_t val_mng_get_info(MNG_INFO_e type);
 
+/* NUMA VAL APIs */
+void     val_numa_create_info_table(uint64_t *numa_info_table);
+void     val_numa_free_info_table(void);
+uint32_t val_numa_get_num_domains(void);
+uint32_t val_numa_get_hart_node(uint32_t index);
+uint32_t val_numa_get_bdf_node(uint32_t bdf);
+uint32_t val_numa_get_addr_node(uint64_t addr);
+uint32_t val_numa_get_mem_range(uint32_t node, uint32_t instance, uint64_t *base, uint64_t *size);
+uint32_t val_numa_get_distance(uint32_t from, uint32_t to);
+
 #endif
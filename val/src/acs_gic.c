@@ -63,6 +63,13 @@ val_iic_execute_tests(uint32_t num_hart, uint32_t *g_sw_view)
       status |= os_i003_entry(num_hart);
       status |= os_i004_entry(num_hart);
       status |= os_i005_entry(num_hart);
+      status |= os_i006_entry(num_hart);
+      status |= os_i007_entry(num_hart);
+      status |= os_i008_entry(num_hart);
+      status |= os_i009_entry(num_hart);
+      status |= os_i010_entry(num_hart);
+      status |= os_i011_entry(num_hart);
+      status |= os_i012_entry(num_hart);
       // status |= os_v2m001_entry(num_hart);
       // status |= os_v2m002_entry(num_hart);
       // status |= os_v2m003_entry(num_hart);
@@ -99,7 +106,8 @@ val_gic_create_info_table(uint64_t *gic_info_table)
   pal_gic_create_info_table(g_gic_info_table);
 
   /* print IIC version */
-  val_print(ACS_PRINT_INFO, " RV porting: INTC info print to be added\n", 0);
+  val_print(ACS_PRINT_TEST, " IIC_INFO: Number of APLIC            : %4d\n",
+                                                             g_gic_info_table->header.num_aplic);
   // gic_version = val_gic_get_info(GIC_INFO_VERSION);
   // num_msi_frame = val_gic_get_info(GIC_INFO_NUM_MSI_FRAME);
   // if ((gic_version != 2) || (num_msi_frame == 0)) /* check if not a GICv2m system */
@@ -142,7 +150,8 @@ val_gic_create_info_table(uint64_t *gic_info_table)
 void
 val_gic_free_info_table(void)
 {
-  pal_mem_free((void *)g_gic_info_table);
+  val_info_table_free((void *)g_gic_info_table);
+  g_gic_info_table = NULL;
 }
 
 /**
@@ -658,3 +667,114 @@ val_gic_max_guest_intr_num(void)
 {
   return g_gic_info_table->header.guest_intr_num;
 }
+
+/**
+  @brief   Return the APLIC entry with the given index, in MADT order.
+**/
+static
+GIC_INFO_ENTRY *
+val_iic_aplic_entry(uint32_t index)
+{
+  GIC_INFO_ENTRY *gic_entry;
+
+  if (g_gic_info_table == NULL)
+      return NULL;
+
+  gic_entry = g_gic_info_table->gic_info;
+  while (gic_entry->type != 0xFF) {
+    if (gic_entry->type == ENTRY_TYPE_APLIC) {
+        if (index == 0)
+            return gic_entry;
+        index--;
+    }
+    gic_entry++;
+  }
+
+  return NULL;
+}
+
+/**
+  @brief   This API returns the number of S-level APLIC domains in the MADT
+           1. Caller       -  Test Suite
+           2. Prerequisite -  val_gic_create_info_table
+  @param   None
+  @return  Number of APLICs
+**/
+uint32_t
+val_iic_aplic_get_num(void)
+{
+  if (g_gic_info_table == NULL)
+      return 0;
+
+  return g_gic_info_table->header.num_aplic;
+}
+
+/**
+  @brief   This API returns one field of an APLIC entry
+           1. Caller       -  Test Suite
+           2. Prerequisite -  val_gic_create_info_table
+  @param   index - APLIC index, 0 to val_iic_aplic_get_num() - 1
+  @param   type  - field to return
+  @return  Field value, 0 for an unknown APLIC
+**/
+uint64_t
+val_iic_aplic_get_info(uint32_t index, APLIC_INFO_e type)
+{
+  GIC_INFO_ENTRY *entry = val_iic_aplic_entry(index);
+
+  if (entry == NULL) {
+      val_print(ACS_PRINT_ERR, "\n   Invalid APLIC index %d ", index);
+      return 0;
+  }
+
+  switch (type) {
+      case APLIC_INFO_ID:
+          return entry->entry_id;
+      case APLIC_INFO_BASE:
+          return entry->base;
+      case APLIC_INFO_LENGTH:
+          return entry->length;
+      case APLIC_INFO_NUM_IDC:
+          return entry->num_idc;
+      case APLIC_INFO_NUM_SOURCES:
+          return entry->spi_count;
+      case APLIC_INFO_GSI_BASE:
+          return entry->spi_base;
+      default:
+          val_print(ACS_PRINT_ERR, "\n    APLIC Info - TYPE not recognized %d  ", type);
+          break;
+  }
+
+  return 0;
+}
+
+/**
+  @brief   This API returns the hart index an APLIC in MSI delivery mode uses
+           to reach the S-level interrupt file of a hart. It is the group and
+           hart number encoded in the file address, per the IMSIC layout in
+           the MADT. When the MADT leaves the hart index width at 0 it is
+           derived from the hart count, as operating systems do.
+           1. Caller       -  Test Suite
+           2. Prerequisite -  val_gic_create_info_table, val_hart_create_info_table
+  @param   index - hart index
+  @return  Hart index for the APLIC target register
+**/
+uint32_t
+val_iic_imsic_msi_hart_index(uint32_t index)
+{
+  uint64_t addr = val_hart_get_imsic_base(index);
+  uint32_t hart_bits = g_gic_info_table->header.hart_index_bits;
+  uint32_t group_bits = g_gic_info_table->header.group_index_bits;
+  uint32_t hart, group = 0;
+
+  if (hart_bits == 0) {
+      while ((1U << hart_bits) < val_hart_get_num())
+          hart_bits++;
+  }
+
+  hart = (addr >> (12 + g_gic_info_table->header.guest_index_bits)) & ((1ULL << hart_bits) - 1);
+  if (group_bits)
+      group = (addr >> g_gic_info_table->header.group_index_shift) & ((1ULL << group_bits) - 1);
+
+  return (group << hart_bits) | hart;
+}
@@ -116,11 +116,103 @@ val_gic_is_valid_lpi(uint32_t int_id)
   return 1; /* Valid LPI */
 }
 
+/* Interrupt identities the VAL dispatch table covers, IMSIC files implement up to 2047 */
+#define GIC_ISR_TABLE_SIZE  2048
+
+/* One entry of the VAL interrupt dispatch table */
+typedef struct {
+  void (*volatile isr)(void);   ///< Handler of the current test, NULL when none
+  volatile uint32_t delivered;
+  volatile uint32_t spurious;   ///< Taken with no handler installed
+  uint32_t hooked;              ///< The dispatcher is registered with the PAL for it
+} GIC_ISR_ENTRY_t;
+
+static GIC_ISR_ENTRY_t g_gic_isr_table[GIC_ISR_TABLE_SIZE];
+
+/* Identities beyond the table that reached the dispatcher */
+static volatile uint32_t g_gic_isr_out_of_range;
+
+/**
+  @brief   Single interrupt handler registered with the PAL for every
+           identity in the dispatch table. Counts the interrupt and calls the
+           handler the current test installed; with none installed the
+           interrupt is counted as spurious and completed here so it cannot
+           fire again. It is handed to the PAL cast to void (*)(void), see
+           pal_gic_install_isr for the arguments it is called with.
+  @param   int_id  - interrupt identity, passed by the PAL as the source
+  @param   context - unused
+**/
+static
+void
+val_gic_isr_dispatch(uint64_t int_id, void *context)
+{
+  GIC_ISR_ENTRY_t *entry;
+  void (*isr)(void);
+
+  (void)context;
+
+  if (int_id >= GIC_ISR_TABLE_SIZE) {
+      __atomic_fetch_add(&g_gic_isr_out_of_range, 1, __ATOMIC_RELAXED);
+      val_gic_end_of_interrupt((uint32_t)int_id);
+      return;
+  }
+
+  entry = &g_gic_isr_table[int_id];
+  isr = entry->isr;
+  if (isr == NULL) {
+      __atomic_fetch_add(&entry->spurious, 1, __ATOMIC_RELAXED);
+      val_gic_end_of_interrupt((uint32_t)int_id);
+      return;
+  }
+
+  __atomic_fetch_add(&entry->delivered, 1, __ATOMIC_RELAXED);
+
+  isr();
+}
+
+/**
+  @brief   Print the interrupt traffic of the test that just ran, one line
+           per identity taken, then drop every handler and clear the
+           counters. An interrupt arriving after its test has ended is then
+           reported as spurious in the next one.
+           1. Caller       -  val_check_for_error, at the end of every test
+           2. Prerequisite -  None
+  @return  None
+**/
+void
+val_gic_isr_report(void)
+{
+  GIC_ISR_ENTRY_t *entry;
+  uint32_t i;
+
+  for (i = 0; i < GIC_ISR_TABLE_SIZE; i++) {
+      entry = &g_gic_isr_table[i];
+      entry->isr = NULL;
+      if (entry->delivered == 0 && entry->spurious == 0)
+          continue;
+
+      val_print(entry->spurious ? ACS_PRINT_WARN : ACS_PRINT_INFO, "\n       IRQ 0x%x", i);
+      val_print(entry->spurious ? ACS_PRINT_WARN : ACS_PRINT_INFO, ": delivered %d", entry->delivered);
+      val_print(entry->spurious ? ACS_PRINT_WARN : ACS_PRINT_INFO, ", spurious %d", entry->spurious);
+
+      entry->delivered = 0;
+      entry->spurious = 0;
+  }
+
+  if (g_gic_isr_out_of_range) {
+      val_print(ACS_PRINT_WARN, "\n       %d interrupts beyond the dispatch table", g_gic_isr_out_of_range);
+      g_gic_isr_out_of_range = 0;
+  }
+}
+
 /**
   @brief   This function is installs the ISR pointed by the function pointer
            the input Interrupt ID.
            1. Caller       -  Test Suite
            2. Prerequisite -  val_gic_create_info_table
+           Identities in the VAL dispatch table have the dispatcher
+           registered with the PAL on first use only; later installs just
+           swap the table entry.
   @param   int_id Interrupt ID to install the ISR
   @param   isr    Function pointer of the ISR
   @return  status
@@ -143,7 +235,19 @@ val_gic_install_isr(uint32_t int_id, void (*isr)(void))
   if (pal_target_is_dt() || pal_target_is_bm())
       return val_gic_bsa_install_isr(int_id, isr);
   else {
+#ifndef TARGET_LINUX
+      if (int_id < GIC_ISR_TABLE_SIZE) {
+          g_gic_isr_table[int_id].isr = isr;
+          if (g_gic_isr_table[int_id].hooked)
+              return 0;
+          ret_val = pal_gic_install_isr(int_id, (void (*)(void))val_gic_isr_dispatch);
+          if (ret_val == 0)
+              g_gic_isr_table[int_id].hooked = 1;
+      } else
+          ret_val = pal_gic_install_isr(int_id, isr);
+#else
       ret_val = pal_gic_install_isr(int_id, isr);
+#endif
 #ifndef TARGET_LINUX
       if (int_id > 31 && int_id < 1024) {
           /**** UEFI IIC code is not enabling interrupt in the Distributor ***/
@@ -198,6 +302,23 @@ uint32_t val_gic_end_of_interrupt(uint32_t int_id)
   return 0;
 }
 
+/**
+  @brief   This function claims the highest priority pending interrupt directly
+           from the interrupt controller, for handlers that want to skip the
+           firmware dispatch. Only UEFI ACPI with an IMSIC provides it.
+           1. Caller       -  Test Suite
+           2. Prerequisite -  val_gic_create_info_table
+  @param   None
+  @return  Claimed interrupt ID, 0 if none is pending or claiming is not supported
+**/
+uint32_t val_gic_claim_interrupt(void)
+{
+  if (pal_target_is_dt() || pal_target_is_bm())
+      return 0;
+
+  return pal_gic_claim_interrupt();
+}
+
 /**
   @brief   This function gets list of ITS in the system and ITS initialization
            1. Caller       -  Application Layer
@@ -377,16 +377,36 @@ val_is_el2_enabled()
 char8_t *
 val_hart_get_isa_string (uint32_t index)
 {
-  HART_INFO_ENTRY *entry;
+  static char8_t no_isa[] = "";
+  uint32_t isa_index;
 
-  if (index > g_hart_info_table->header.num_of_hart) {
+  if (index >= g_hart_info_table->header.num_of_hart) {
         val_report_status(index, RESULT_FAIL(0, 0xFF), NULL);
         return NULL;
   }
 
-  entry = g_hart_info_table->hart_info;
+  isa_index = g_hart_info_table->hart_info[index].isa_index;
+  if (isa_index >= g_hart_info_table->header.num_of_isa)
+        return no_isa;
+
+  return &g_hart_info_table->isa_pool[g_hart_info_table->isa[isa_index].pool_offset];
+}
+
+/**
+ * @brief This API returns the index of the interned ISA string of a HART.
+          HARTs with equal indices have identical ISA strings.
+           1. Caller       -  VAL
+           2. Prerequisite -  val_create_peinfo_table
+ * @param index - the index of HART
+ * @return Index of the ISA string, HART_ISA_NONE if the HART has none
+ */
+uint32_t
+val_hart_get_isa_index (uint32_t index)
+{
+  if (index >= g_hart_info_table->header.num_of_hart)
+        return HART_ISA_NONE;
 
-  return entry[index].isa_string;
+  return g_hart_info_table->hart_info[index].isa_index;
 }
 
 /**
@@ -401,16 +421,91 @@ val_hart_get_isa_string (uint32_t index)
 uint64_t
 val_hart_get_imsic_base (int32_t index)
 {
-  HART_INFO_ENTRY *entry;
+  if ((uint32_t)index >= g_hart_info_table->header.num_of_hart) {
+        val_report_status(index, RESULT_FAIL(0, 0xFF), NULL);
+        return 0;
+  }
 
-  if (index > g_hart_info_table->header.num_of_hart) {
+  return g_hart_hot_table[index].imsic_base;
+}
+
+/**
+ * @brief  This API returns the external interrupt controller ID of a given
+           HART index. For an APLIC in direct mode bits [31:24] are the
+           APLIC ID and bits [15:0] the IDC of the hart.
+           1. Caller       -  Test Suite
+           2. Prerequisite -  val_create_peinfo_table
+ *
+ * @param index
+ * @return External interrupt controller ID
+ */
+uint32_t
+val_hart_get_ext_intc_id (uint32_t index)
+{
+  if (index >= g_hart_info_table->header.num_of_hart) {
         val_report_status(index, RESULT_FAIL(0, 0xFF), NULL);
         return 0;
   }
 
+  return g_hart_info_table->hart_info[index].ext_intc_id;
+}
+
+/**
+ * @brief  This API returns the ACPI processor UID of a given HART index
+           1. Caller       -  VAL
+           2. Prerequisite -  val_create_peinfo_table
+ *
+ * @param index
+ * @return ACPI processor UID from the RINTC structure
+ */
+uint32_t
+val_hart_get_acpi_uid (uint32_t index)
+{
+  HART_INFO_ENTRY *entry;
+
+  if (index >= g_hart_info_table->header.num_of_hart)
+        return 0xFFFFFFFF;
+
+  entry = g_hart_info_table->hart_info;
+
+  return entry[index].acpi_processor_uid;
+}
+
+/**
+ * @brief  This API returns the Zicbom cache block size usable on every HART,
+           i.e. the smallest block size reported in the RHCT CMO nodes.
+           1. Caller       -  VAL
+           2. Prerequisite -  val_create_peinfo_table
+ *
+ * @return Block size in bytes, 0 if any HART does not report Zicbom
+ */
+uint32_t
+val_hart_get_cbom_block_size (void)
+{
+  static uint32_t cbom_block_size;
+  static uint32_t cbom_valid;
+  HART_INFO_ENTRY *entry;
+  uint32_t index, size = 0;
+
+  if (cbom_valid)
+      return cbom_block_size;
+
+  if (g_hart_info_table == NULL)
+      return 0;
+
   entry = g_hart_info_table->hart_info;
+  for (index = 0; index < g_hart_info_table->header.num_of_hart; index++) {
+      if (entry[index].cbom_block_size == 0) {
+          size = 0;
+          break;
+      }
+      if ((size == 0) || (entry[index].cbom_block_size < size))
+          size = entry[index].cbom_block_size;
+  }
 
-  return entry[index].imsic_base;
+  cbom_block_size = size;
+  cbom_valid = 1;
+  return cbom_block_size;
 }
 
 /**
@@ -18,6 +18,7 @@
 #include "include/bsa_acs_val.h"
 #include "include/bsa_acs_hart.h"
 #include "include/bsa_acs_common.h"
+#include "include/bsa_acs_memory.h"
 #include "include/bsa_std_smc.h"
 #include "sys_arch_src/gic/bsa_exception.h"
 #include "include/val_interface.h"
@@ -31,6 +32,11 @@ uint64_t g_primary_mpidr = PAL_INVALID_MPID;
   @brief   Pointer to the memory location of the HART Information table
 **/
 HART_INFO_TABLE *g_hart_info_table;
+
+/**
+  @brief   Dense copy of the per hart lookup fields, see HART_HOT_ENTRY
+**/
+HART_HOT_ENTRY *g_hart_hot_table;
 /**
   @brief   global structure to pass and retrieve arguments for the SMC call
 **/
@@ -39,6 +45,105 @@ ARM_SMC_ARGS g_smc_args;
 /* global variable to store primary HART index */
 uint32_t g_primary_hart_index = 0;
 
+/* Open addressed Hart ID to index map. Slots hold index + 1, 0 marks an empty slot */
+static uint32_t *g_hart_id_hash;
+static uint32_t g_hart_id_hash_mask;
+
+/* tp of the primary HART on entry, restored when the info table is freed */
+static uint64_t g_primary_saved_tp;
+
+/* Each HART keeps a pointer to its own HART_HOT_ENTRY in tp. Nothing in the
+   firmware environment uses tp, the Linux application leaves it to libc. */
+static inline uint64_t
+val_hart_tp_read(void)
+{
+  uint64_t tp = 0;
+#if defined(__riscv) && !defined(TARGET_LINUX)
+  __asm__ volatile ("mv %0, tp" : "=r" (tp));
+#endif
+  return tp;
+}
+
+static inline void
+val_hart_tp_write(uint64_t tp)
+{
+#if defined(__riscv) && !defined(TARGET_LINUX)
+  __asm__ volatile ("mv tp, %0" : : "r" (tp) : "memory");
+#else
+  (void)tp;
+#endif
+}
+
+/**
+  @brief   Return the HART_HOT_ENTRY of the calling HART, or NULL when the
+           HART has not been bound by val_hart_bind_self
+**/
+static inline HART_HOT_ENTRY *
+val_hart_self(void)
+{
+  HART_HOT_ENTRY *self = (HART_HOT_ENTRY *)val_hart_tp_read();
+
+  if (g_hart_hot_table == NULL || self < g_hart_hot_table ||
+      self >= g_hart_hot_table + g_hart_info_table->header.num_of_hart)
+      return NULL;
+
+  return self;
+}
+
+/**
+  @brief   Record the index of the calling HART in tp. Called once at HART entry.
+  @param   index - index of the calling HART
+  @return  None
+**/
+static void
+val_hart_bind_self(uint32_t index)
+{
+  val_hart_tp_write((uint64_t)&g_hart_hot_table[index]);
+}
+
+static inline uint32_t
+val_hart_id_hash(uint64_t hart_id)
+{
+  return (uint32_t)((hart_id * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+
+/**
+  @brief   Build the Hart ID to index map, sized to at least twice the number
+           of HARTs so probe sequences stay short.
+  @return  ACS_STATUS_PASS, or ACS_STATUS_ERR if the map cannot be allocated
+**/
+static uint32_t
+val_hart_id_hash_build(void)
+{
+  uint32_t num = val_hart_get_num();
+  uint32_t size = 16;
+  uint32_t i, slot;
+
+  while (size < 2 * num)
+      size <<= 1;
+
+  g_hart_id_hash = val_memory_alloc(size * sizeof(uint32_t));
+  if (g_hart_id_hash == NULL)
+      return ACS_STATUS_ERR;
+
+  val_memory_set(g_hart_id_hash, size * sizeof(uint32_t), 0);
+  g_hart_id_hash_mask = size - 1;
+
+  for (i = 0; i < num; i++) {
+      slot = val_hart_id_hash(g_hart_hot_table[i].hart_id) & g_hart_id_hash_mask;
+      while (g_hart_id_hash[slot] != 0)
+          slot = (slot + 1) & g_hart_id_hash_mask;
+      g_hart_id_hash[slot] = i + 1;
+  }
+
+  val_data_cache_ops_by_range((addr_t)g_hart_id_hash, size * sizeof(uint32_t),
+                              CLEAN_AND_INVALIDATE);
+  val_data_cache_ops_by_va((addr_t)&g_hart_id_hash, CLEAN_AND_INVALIDATE);
+  val_data_cache_ops_by_va((addr_t)&g_hart_id_hash_mask, CLEAN_AND_INVALIDATE);
+
+  return ACS_STATUS_PASS;
+}
+
 /**
   @brief   This API will call PAL layer to fill in the HART information
            into the g_hart_info_table pointer.
@@ -50,6 +155,8 @@ uint32_t g_primary_hart_index = 0;
 uint32_t
 val_hart_create_info_table(uint64_t *hart_info_table)
 {
+  uint32_t i;
+
   gPsciConduit = pal_psci_get_conduit();
   if (gPsciConduit == CONDUIT_UNKNOWN) {
       // val_print(ACS_PRINT_WARN, " FADT not found, assuming SMC as PSCI conduit\n", 0);
@@ -79,18 +186,58 @@ val_hart_create_info_table(uint64_t *hart_info_table)
   val_data_cache_ops_by_va((addr_t)&g_hart_info_table, CLEAN_AND_INVALIDATE);
 
   val_print(ACS_PRINT_TEST, " HART_INFO: Number of HART detected       : %4d\n", val_hart_get_num());
+  val_print(ACS_PRINT_DEBUG, " HART_INFO: Distinct ISA strings     : %4d\n",
+            g_hart_info_table->header.num_of_isa);
 
   if (val_hart_get_num() == 0) {
       val_print(ACS_PRINT_ERR, "\n *** CRITICAL ERROR: Num HART is 0x0 ***\n", 0);
       return ACS_STATUS_ERR;
   }
 
-  /* store primary HART index for debug message printing purposes on
-     multi HART tests */
-  g_primary_hart_index = val_hart_get_index_mpid(val_hart_get_mpid());
+  g_hart_hot_table = val_memory_alloc(val_hart_get_num() * sizeof(HART_HOT_ENTRY));
+  if (g_hart_hot_table == NULL) {
+      val_print(ACS_PRINT_ERR, "\n *** CRITICAL ERROR: HART lookup table allocation failed ***\n", 0);
+      return ACS_STATUS_ERR;
+  }
+
+  for (i = 0; i < val_hart_get_num(); i++) {
+      g_hart_hot_table[i].hart_id    = g_hart_info_table->hart_info[i].hart_id;
+      g_hart_hot_table[i].imsic_base = g_hart_info_table->hart_info[i].imsic_base;
+  }
+  val_data_cache_ops_by_range((addr_t)g_hart_hot_table,
+                              val_hart_get_num() * sizeof(HART_HOT_ENTRY), CLEAN_AND_INVALIDATE);
+  val_data_cache_ops_by_va((addr_t)&g_hart_hot_table, CLEAN_AND_INVALIDATE);
+
+  if (val_hart_id_hash_build()) {
+      val_print(ACS_PRINT_ERR, "\n *** CRITICAL ERROR: HART ID map allocation failed ***\n", 0);
+      return ACS_STATUS_ERR;
+  }
+
+  /* resolve the primary HART index once and keep it in tp, the tp it
+     came in with is put back by val_hart_free_info_table */
+  g_primary_saved_tp = val_hart_tp_read();
+  val_hart_tp_write(0);
+  g_primary_mpidr = pal_hart_get_boot_hart_id();
+  g_primary_hart_index = val_hart_get_index_mpid(g_primary_mpidr);
+
+  /* the lookup falls back to index 0, never bind a HART that is not the boot HART */
+  if (g_primary_mpidr == HART_ID_INVALID ||
+      g_hart_hot_table[g_primary_hart_index].hart_id != g_primary_mpidr) {
+      val_hart_tp_write(g_primary_saved_tp);
+      val_print(ACS_PRINT_ERR, "\n *** CRITICAL ERROR: Boot HART ID 0x%llx not in HART info table ***\n",
+                g_primary_mpidr);
+      return ACS_STATUS_ERR;
+  }
+  val_hart_bind_self(g_primary_hart_index);
   val_print(ACS_PRINT_DEBUG, " HART_INFO: Primary HART index       : %4d\n",
             g_primary_hart_index);
 
+  /* decode every distinct ISA string once for the extension queries */
+  val_hart_isa_parse_all();
+
+  /* let the PAL memory primitives use RVV when every HART has it */
+  pal_mem_enable_vector(val_hart_all_have_ext(EXT_V));
+
   return ACS_STATUS_PASS;
 }
 
@@ -104,7 +251,17 @@ val_hart_create_info_table(uint64_t *hart_info_table)
 void
 val_hart_free_info_table()
 {
-  pal_mem_free((void *)g_hart_info_table);
+  if (g_hart_hot_table != NULL) {
+      val_hart_tp_write(g_primary_saved_tp);
+      val_memory_free(g_hart_hot_table);
+      g_hart_hot_table = NULL;
+  }
+  if (g_hart_id_hash != NULL) {
+      val_memory_free(g_hart_id_hash);
+      g_hart_id_hash = NULL;
+  }
+  val_info_table_free((void *)g_hart_info_table);
+  g_hart_info_table = NULL;
 }
 
 /**
@@ -125,17 +282,23 @@ val_hart_get_num()
 
 
 /**
-  @brief   This API reads MPIDR system regiser and return the Affinity bits
+  @brief   This API returns the Hart ID of the calling HART. Once the HART is
+           bound at entry this is a load through tp, before that it falls
+           back to the system register read.
            1. Caller       -  Test Suite, VAL
            2. Prerequisite -  None
   @param   None
-  @return  Affinity Bits of MPIDR
+  @return  Hart ID of the calling HART
 **/
 uint64_t
 val_hart_get_mpid()
 {
+  HART_HOT_ENTRY *self = val_hart_self();
   uint64_t data;
 
+  if (self != NULL)
+      return self->hart_id;
+
   #ifdef TARGET_LINUX
     data = 0;
   #else
@@ -158,16 +321,12 @@ uint64_t
 val_hart_get_mpid_index(uint32_t index)
 {
 
-  HART_INFO_ENTRY *entry;
-
-  if (index > g_hart_info_table->header.num_of_hart) {
+  if (index >= g_hart_info_table->header.num_of_hart) {
         val_report_status(index, RESULT_FAIL(0, 0xFF), NULL);
         return 0xFFFFFF;
   }
 
-  entry = g_hart_info_table->hart_info;
-
-  return entry[index].hart_id;
+  return g_hart_hot_table[index].hart_id;
 
 }
 
@@ -182,20 +341,22 @@ uint32_t
 val_hart_get_index_mpid(uint64_t hart_id)
 {
 
-  HART_INFO_ENTRY *entry;
-  uint32_t i = g_hart_info_table->header.num_of_hart;
-
-  entry = g_hart_info_table->hart_info;
-
-  while (i > 0) {
-    val_data_cache_ops_by_va((addr_t)&entry->hart_id, INVALIDATE);
-    val_data_cache_ops_by_va((addr_t)&entry->hart_num, INVALIDATE);
-
-    if (entry->hart_id == hart_id) {
-      return entry->hart_num;
+  HART_HOT_ENTRY *self = val_hart_self();
+  uint32_t slot, entry;
+
+  /* the common case is a HART asking for its own index */
+  if (self != NULL && self->hart_id == hart_id)
+    return (uint32_t)(self - g_hart_hot_table);
+
+  /* The map is written once by the primary hart and cleaned to the
+     point of coherency, so no per entry maintenance is needed here */
+  if (g_hart_id_hash != NULL) {
+    slot = val_hart_id_hash(hart_id) & g_hart_id_hash_mask;
+    while ((entry = g_hart_id_hash[slot]) != 0) {
+      if (g_hart_hot_table[entry - 1].hart_id == hart_id)
+        return entry - 1;
+      slot = (slot + 1) & g_hart_id_hash_mask;
     }
-    entry++;
-    i--;
   }
 
   return 0x0;  //Return index 0 as a safe failsafe value
@@ -217,6 +378,13 @@ val_test_entry(void)
   ARM_SMC_ARGS smc_args;
   void (*vector)(uint64_t args);
 
+  /* no entry path hands over the Hart ID yet, so this HART stays unbound
+     and its lookups take the slow path */
+  val_hart_tp_write(0);
+
+  /* sstatus.VS is per hart, turn it on here before any vector memory op */
+  pal_mem_enable_vector(val_hart_all_have_ext(EXT_V));
+
   val_get_test_data(val_hart_get_index_mpid(val_hart_get_mpid()), (uint64_t *)&vector, &test_arg);
   vector(test_arg);
 
@@ -271,7 +439,88 @@ val_execute_on_pe(uint32_t index, void (*payload)(void), uint64_t test_input)
           val_print(ACS_PRINT_ERR, "\n       PSCI_CPU_ON: failure[%d]", g_smc_args.Arg0);
 
   }
-  val_set_status(index, RESULT_FAIL(0, 0x120 - (int)g_smc_args.Arg0));
+  /* keep the checkpoint inside its field, an SBI or unported conduit can
+     leave any value in Arg0 */
+  val_set_status(index, RESULT_FAIL(0, (0x120 - (int)g_smc_args.Arg0) & STATUS_MASK));
+}
+
+/**
+  @brief   Start a payload on another HART without waiting for it. The status
+           of the HART is set pending first, so the caller can wait on it.
+           1. Caller       -  Test Suite, on the primary HART
+           2. Prerequisite -  val_create_peinfo_table
+  @param   test_num  - test whose status is used for the handshake
+  @param   index     - HART index to run on
+  @param   payload   - function to run
+  @return  ACS_STATUS_PASS once started, ACS_STATUS_SKIP if the HART could
+           not be started
+**/
+uint32_t
+val_hart_start_payload(uint32_t test_num, uint32_t index, void (*payload)(void))
+{
+  uint32_t status;
+
+  val_set_status(index, RESULT_PENDING(test_num));
+  val_execute_on_pe(index, payload, 0);
+
+  /* a HART that could not be started is reported by val_execute_on_pe
+     as a failure of test 0, it never ran the payload */
+  status = val_get_status(index);
+  if (IS_TEST_FAIL(status) && ((status >> TEST_NUM_BIT) & TEST_NUM_MASK) == 0) {
+      val_print(ACS_PRINT_WARN, "\n       HART %d could not be started", index);
+      val_set_status(index, RESULT_SKIP(test_num, status & STATUS_MASK));
+      return ACS_STATUS_SKIP;
+  }
+
+  return ACS_STATUS_PASS;
+}
+
+/**
+  @brief   Run a payload on one HART and wait for it to finish. The payload
+           signals completion through val_set_status, the calling HART runs
+           it directly when it is the target.
+           1. Caller       -  Test Suite, on the primary HART
+           2. Prerequisite -  val_create_peinfo_table, val_timer_create_info_table
+  @param   test_num  - test whose status is used for the handshake
+  @param   index     - HART index to run on
+  @param   payload   - function to run
+  @param   timeout_s - time limit in seconds
+  @return  ACS_STATUS_PASS or ACS_STATUS_SKIP as reported by the payload,
+           ACS_STATUS_SKIP if the HART could not be started, else
+           ACS_STATUS_FAIL, including when the HART did not respond in time
+**/
+uint32_t
+val_hart_run_payload(uint32_t test_num, uint32_t index, void (*payload)(void), uint32_t timeout_s)
+{
+  uint64_t freq, start;
+  uint32_t status;
+
+  if (index == val_hart_get_index_mpid(val_hart_get_mpid())) {
+      val_set_status(index, RESULT_PENDING(test_num));
+      payload();
+  } else {
+      if (val_hart_start_payload(test_num, index, payload))
+          return ACS_STATUS_SKIP;
+
+      freq  = val_timer_get_info(TIMER_INFO_CNTFREQ, 0);
+      start = val_timer_get_counter();
+      while (IS_RESULT_PENDING(val_get_status(index))) {
+          if (freq && (val_timer_get_counter() - start) > freq * timeout_s) {
+              val_print(ACS_PRINT_ERR, "\n       HART %d timed out", index);
+              return ACS_STATUS_FAIL;
+          }
+      }
+  }
+
+  /* a HART whose payload failed, or never reported, ends in FAIL */
+  status = val_get_status(index);
+  if (IS_TEST_PASS(status))
+      return ACS_STATUS_PASS;
+  if (IS_TEST_SKIP(status))
+      return ACS_STATUS_SKIP;
+
+  val_print(ACS_PRINT_ERR, "\n       HART %d did not pass", index);
+  return ACS_STATUS_FAIL;
 }
 
 /**
@@ -286,7 +535,8 @@ val_execute_on_pe(uint32_t index, void (*payload)(void), uint64_t test_input)
 uint32_t
 val_hart_install_esr(uint32_t exception_type, void (*esr)(uint64_t, void *))
 {
-  if (exception_type > EXCEPT_RISCV_MAX_EXCEPTIONS) {
+  if (exception_type > EXCEPT_RISCV_MAX_EXCEPTIONS &&
+      (exception_type < EXCEPT_RISCV_IRQ_0 || exception_type > EXCEPT_RISCV_MAX_IRQS)) {
       val_print(ACS_PRINT_ERR, "Invalid Exception type %x\n", exception_type);
       return ACS_STATUS_ERR;
   }
@@ -388,16 +638,7 @@ void
 val_hart_cache_clean_range(uint64_t start_addr, uint64_t length)
 {
 #ifndef TARGET_LINUX
-  uint64_t aligned_addr, end_addr, line_length;
-
-  line_length = 2 << ((val_hart_reg_read(CTR_EL0) >> 16) & 0xf);
-  aligned_addr = start_addr - (start_addr & (line_length-1));
-  end_addr = start_addr + length;
-
-  while(aligned_addr < end_addr){
-      val_data_cache_ops_by_va(aligned_addr, CLEAN);
-      aligned_addr += line_length;
-  }
+  val_data_cache_ops_by_range(start_addr, length, CLEAN);
 #endif
 }
 
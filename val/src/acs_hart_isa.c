@@ -0,0 +1,403 @@
+/** @file
+ * Copyright (c) 2016-2018, 2020-2021, 2023, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#include "include/bsa_acs_val.h"
+#include "include/bsa_acs_hart.h"
+#include "include/bsa_acs_common.h"
+#include "include/val_interface.h"
+#include "include/bsa_acs_memory.h"
+
+extern HART_INFO_TABLE *g_hart_info_table;
+
+/* Extensions and versions of one interned ISA string */
+typedef struct {
+  uint64_t ext[HART_ISA_EXT_WORDS];
+  uint8_t  major[EXT_MAX];
+  uint8_t  minor[EXT_MAX];
+} HART_ISA_EXT_INFO;
+
+static HART_ISA_EXT_INFO g_hart_isa_ext[HART_MAX_ISA_STRINGS];
+static uint64_t g_hart_common_ext[HART_ISA_EXT_WORDS];
+
+/* Canonical lower case names of the multi-letter extensions */
+static char8_t *g_hart_ext_names[EXT_MAX] = {
+  [EXT_ZICSR]         = "zicsr",
+  [EXT_ZIFENCEI]      = "zifencei",
+  [EXT_ZICNTR]        = "zicntr",
+  [EXT_ZIHPM]         = "zihpm",
+  [EXT_ZICBOM]        = "zicbom",
+  [EXT_ZICBOZ]        = "zicboz",
+  [EXT_ZICBOP]        = "zicbop",
+  [EXT_ZIHINTPAUSE]   = "zihintpause",
+  [EXT_ZIHINTNTL]     = "zihintntl",
+  [EXT_ZICOND]        = "zicond",
+  [EXT_ZIMOP]         = "zimop",
+  [EXT_ZICCAMOA]      = "ziccamoa",
+  [EXT_ZICCIF]        = "ziccif",
+  [EXT_ZICCLSM]       = "zicclsm",
+  [EXT_ZICCRSE]       = "ziccrse",
+  [EXT_ZIC64B]        = "zic64b",
+  [EXT_ZAWRS]         = "zawrs",
+  [EXT_ZACAS]         = "zacas",
+  [EXT_ZAAMO]         = "zaamo",
+  [EXT_ZALRSC]        = "zalrsc",
+  [EXT_ZFA]           = "zfa",
+  [EXT_ZFH]           = "zfh",
+  [EXT_ZFHMIN]        = "zfhmin",
+  [EXT_ZBA]           = "zba",
+  [EXT_ZBB]           = "zbb",
+  [EXT_ZBC]           = "zbc",
+  [EXT_ZBS]           = "zbs",
+  [EXT_ZKT]           = "zkt",
+  [EXT_ZCB]           = "zcb",
+  [EXT_ZCMOP]         = "zcmop",
+  [EXT_ZVFHMIN]       = "zvfhmin",
+  [EXT_ZVBB]          = "zvbb",
+  [EXT_ZVKT]          = "zvkt",
+  [EXT_SSAIA]         = "ssaia",
+  [EXT_SMAIA]         = "smaia",
+  [EXT_SSQOSID]       = "ssqosid",
+  [EXT_SSCOFPMF]      = "sscofpmf",
+  [EXT_SSTC]          = "sstc",
+  [EXT_SSCCPTR]       = "ssccptr",
+  [EXT_SSTVECD]       = "sstvecd",
+  [EXT_SSTVALA]       = "sstvala",
+  [EXT_SSU64XL]       = "ssu64xl",
+  [EXT_SSNPM]         = "ssnpm",
+  [EXT_SSCOUNTERENW]  = "sscounterenw",
+  [EXT_SSSTATEEN]     = "ssstateen",
+  [EXT_SMSTATEEN]     = "smstateen",
+  [EXT_SSCSRIND]      = "sscsrind",
+  [EXT_SMCSRIND]      = "smcsrind",
+  [EXT_SVINVAL]       = "svinval",
+  [EXT_SVNAPOT]       = "svnapot",
+  [EXT_SVPBMT]        = "svpbmt",
+  [EXT_SVADU]         = "svadu",
+  [EXT_SVADE]         = "svade",
+  [EXT_SHCOUNTERENW]  = "shcounterenw",
+  [EXT_SHVSTVALA]     = "shvstvala",
+  [EXT_SHTVALA]       = "shtvala",
+  [EXT_SHVSTVECD]     = "shvstvecd",
+  [EXT_SHVSATPA]      = "shvsatpa",
+  [EXT_SHGATPA]       = "shgatpa",
+  [EXT_SDTRIG]        = "sdtrig",
+};
+
+#define ISA_LOWER(c)  (((c) >= 'A' && (c) <= 'Z') ? ((c) - 'A' + 'a') : (c))
+#define ISA_DIGIT(c)  ((c) >= '0' && (c) <= '9')
+
+static void
+hart_isa_set(HART_ISA_EXT_INFO *info, uint32_t ext, uint32_t major, uint32_t minor)
+{
+  info->ext[ext / 64] |= 1ULL << (ext % 64);
+  info->major[ext] = major;
+  info->minor[ext] = minor;
+}
+
+/* Parse an optional "<major>[p<minor>]" version at *p */
+static void
+hart_isa_version(char8_t **p, uint32_t *major, uint32_t *minor)
+{
+  char8_t *s = *p;
+
+  *major = 0;
+  *minor = 0;
+  if (!ISA_DIGIT(*s))
+      return;
+
+  while (ISA_DIGIT(*s))
+      *major = *major * 10 + (*s++ - '0');
+
+  if (ISA_LOWER(*s) == 'p' && ISA_DIGIT(s[1])) {
+      s++;
+      while (ISA_DIGIT(*s))
+          *minor = *minor * 10 + (*s++ - '0');
+  }
+  *p = s;
+}
+
+/* Record a single letter extension, 'g' stands for imafd_zicsr_zifencei */
+static void
+hart_isa_set_letter(HART_ISA_EXT_INFO *info, char8_t c, uint32_t major, uint32_t minor)
+{
+  if (c == 'g') {
+      hart_isa_set(info, EXT_I, 0, 0);
+      hart_isa_set(info, EXT_M, 0, 0);
+      hart_isa_set(info, EXT_A, 0, 0);
+      hart_isa_set(info, EXT_F, 0, 0);
+      hart_isa_set(info, EXT_D, 0, 0);
+      hart_isa_set(info, EXT_ZICSR, 0, 0);
+      hart_isa_set(info, EXT_ZIFENCEI, 0, 0);
+  } else if (c >= 'a' && c <= 'z') {
+      hart_isa_set(info, EXT_A + (c - 'a'), major, minor);
+  }
+}
+
+static uint32_t
+hart_isa_lookup(char8_t *name, uint32_t len)
+{
+  uint32_t ext, i;
+
+  for (ext = EXT_ZICSR; ext < EXT_MAX; ext++) {
+      for (i = 0; i < len; i++) {
+          if (g_hart_ext_names[ext][i] != ISA_LOWER(name[i]))
+              break;
+      }
+      if (i == len && g_hart_ext_names[ext][len] == '\0')
+          return ext;
+  }
+
+  return EXT_MAX;
+}
+
+/* Record a multi-letter extension token, with or without a version suffix */
+static void
+hart_isa_set_token(HART_ISA_EXT_INFO *info, char8_t *tok, uint32_t len)
+{
+  uint32_t name_len, ver, major = 0, minor = 0, ext;
+  char8_t *v;
+
+  /* Split "<name><major>[p<minor>]". Names may contain digits (zic64b), so
+     fall back to the whole token if the shortened name is unknown. */
+  name_len = len;
+  while (name_len > 0 && ISA_DIGIT(tok[name_len - 1]))
+      name_len--;
+  if (name_len < len && name_len > 1 && ISA_LOWER(tok[name_len - 1]) == 'p' &&
+      ISA_DIGIT(tok[name_len - 2])) {
+      ver = name_len - 1;
+      while (ver > 0 && ISA_DIGIT(tok[ver - 1]))
+          ver--;
+      name_len = ver;
+  }
+
+  ext = EXT_MAX;
+  if (name_len > 0 && name_len < len) {
+      ext = hart_isa_lookup(tok, name_len);
+      if (ext != EXT_MAX) {
+          v = tok + name_len;
+          hart_isa_version(&v, &major, &minor);
+      }
+  }
+  if (ext == EXT_MAX)
+      ext = hart_isa_lookup(tok, len);
+
+  if (ext != EXT_MAX)
+      hart_isa_set(info, ext, major, minor);
+  else
+      val_print(ACS_PRINT_DEBUG, "\n       Unknown ISA extension token of length %d", len);
+}
+
+/**
+  @brief   Parse an RHCT ISA string (e.g. rv64imafdc_zicsr_ssaia1p0) into an
+           extension bitmap with versions. Single letter extensions follow the
+           base, multi-letter extensions (s, x, z prefixes) are separated by
+           underscores. Unversioned extensions record version 0.0.
+**/
+static void
+hart_isa_parse(char8_t *isa, HART_ISA_EXT_INFO *info)
+{
+  uint32_t major, minor;
+  char8_t *p = isa, *tok, c;
+
+  val_memory_set(info, sizeof(HART_ISA_EXT_INFO), 0);
+
+  if (ISA_LOWER(p[0]) != 'r' || ISA_LOWER(p[1]) != 'v')
+      return;
+
+  p += 2;
+  while (ISA_DIGIT(*p))
+      p++;
+
+  while (*p != '\0') {
+      if (*p == '_') {
+          p++;
+          continue;
+      }
+
+      c = ISA_LOWER(*p);
+      if (c == 's' || c == 'x' || c == 'z') {
+          tok = p;
+          while (*p != '\0' && *p != '_')
+              p++;
+          hart_isa_set_token(info, tok, p - tok);
+          continue;
+      }
+
+      p++;
+      hart_isa_version(&p, &major, &minor);
+      hart_isa_set_letter(info, c, major, minor);
+  }
+}
+
+/**
+  @brief   Parse every distinct ISA string of the HART info table once and
+           compute the set of extensions implemented by all HARTs.
+           1. Caller       -  VAL
+           2. Prerequisite -  val_hart_create_info_table
+  @param   None
+  @return  None
+**/
+void
+val_hart_isa_parse_all(void)
+{
+  uint32_t index, isa, w, num_isa;
+
+  /* never trust the PAL count beyond the size of g_hart_isa_ext */
+  num_isa = g_hart_info_table->header.num_of_isa;
+  if (num_isa > HART_MAX_ISA_STRINGS)
+      num_isa = HART_MAX_ISA_STRINGS;
+
+  for (isa = 0; isa < num_isa; isa++)
+      hart_isa_parse(&g_hart_info_table->isa_pool[g_hart_info_table->isa[isa].pool_offset],
+                     &g_hart_isa_ext[isa]);
+
+  for (w = 0; w < HART_ISA_EXT_WORDS; w++)
+      g_hart_common_ext[w] = ~0ULL;
+
+  for (index = 0; index < g_hart_info_table->header.num_of_hart; index++) {
+      isa = g_hart_info_table->hart_info[index].isa_index;
+      for (w = 0; w < HART_ISA_EXT_WORDS; w++) {
+          if (isa >= num_isa)
+              g_hart_common_ext[w] = 0;
+          else
+              g_hart_common_ext[w] &= g_hart_isa_ext[isa].ext[w];
+      }
+  }
+
+  if (g_hart_info_table->header.num_of_hart == 0)
+      val_memory_set(g_hart_common_ext, sizeof(g_hart_common_ext), 0);
+}
+
+static HART_ISA_EXT_INFO *
+hart_isa_info(uint32_t index)
+{
+  uint32_t isa;
+
+  if (g_hart_info_table == NULL || index >= g_hart_info_table->header.num_of_hart)
+      return NULL;
+
+  isa = g_hart_info_table->hart_info[index].isa_index;
+  if (isa >= g_hart_info_table->header.num_of_isa || isa >= HART_MAX_ISA_STRINGS)
+      return NULL;
+
+  return &g_hart_isa_ext[isa];
+}
+
+/**
+  @brief   This API checks whether a HART implements an ISA extension.
+           1. Caller       -  Test Suite, VAL
+           2. Prerequisite -  val_hart_create_info_table
+  @param   index - HART index
+  @param   ext   - extension
+  @return  1 if implemented, else 0.
+**/
+uint32_t
+val_hart_has_ext(uint32_t index, HART_ISA_EXT_e ext)
+{
+  HART_ISA_EXT_INFO *info = hart_isa_info(index);
+
+  if (info == NULL || ext >= EXT_MAX)
+      return 0;
+
+  return (info->ext[ext / 64] >> (ext % 64)) & 1;
+}
+
+/**
+  @brief   This API checks whether every HART implements an ISA extension.
+           1. Caller       -  Test Suite, VAL
+           2. Prerequisite -  val_hart_create_info_table
+  @param   ext   - extension
+  @return  1 if implemented by all HARTs, else 0.
+**/
+uint32_t
+val_hart_all_have_ext(HART_ISA_EXT_e ext)
+{
+  if (ext >= EXT_MAX)
+      return 0;
+
+  return (g_hart_common_ext[ext / 64] >> (ext % 64)) & 1;
+}
+
+/**
+  @brief   This API returns the version of an ISA extension of a HART.
+           1. Caller       -  Test Suite
+           2. Prerequisite -  val_hart_create_info_table
+  @param   index - HART index
+  @param   ext   - extension
+  @return  (major << 16) | minor, 0 if absent or not versioned.
+**/
+uint32_t
+val_hart_get_ext_version(uint32_t index, HART_ISA_EXT_e ext)
+{
+  HART_ISA_EXT_INFO *info = hart_isa_info(index);
+
+  if (info == NULL || !val_hart_has_ext(index, ext))
+      return 0;
+
+  return ((uint32_t)info->major[ext] << 16) | info->minor[ext];
+}
+
+/**
+  @brief   This API copies the extension bitmap of a HART.
+  @param   index - HART index
+  @param   mask  - HART_ISA_EXT_WORDS words, bit n set if extension n is implemented
+  @return  None
+**/
+void
+val_hart_get_ext_mask(uint32_t index, uint64_t *mask)
+{
+  HART_ISA_EXT_INFO *info = hart_isa_info(index);
+  uint32_t w;
+
+  for (w = 0; w < HART_ISA_EXT_WORDS; w++)
+      mask[w] = info ? info->ext[w] : 0;
+}
+
+/**
+  @brief   This API copies the bitmap of extensions implemented by all HARTs.
+  @param   mask  - HART_ISA_EXT_WORDS words
+  @return  None
+**/
+void
+val_hart_get_common_ext_mask(uint64_t *mask)
+{
+  uint32_t w;
+
+  for (w = 0; w < HART_ISA_EXT_WORDS; w++)
+      mask[w] = g_hart_common_ext[w];
+}
+
+/**
+  @brief   This API returns the canonical name of an extension for reports.
+  @param   ext   - extension
+  @return  Name string, single letter extensions share one buffer per call.
+**/
+char8_t *
+val_hart_get_ext_name(HART_ISA_EXT_e ext)
+{
+  static char8_t letter[2];
+
+  if (ext < EXT_ZICSR) {
+      letter[0] = 'a' + ext;
+      letter[1] = '\0';
+      return letter;
+  }
+  if (ext < EXT_MAX)
+      return g_hart_ext_names[ext];
+
+  return "unknown";
+}
@@ -0,0 +1,1460 @@
+/** @file
+ * Copyright (c) 2016-2018, 2020-2021, 2023, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#include "include/bsa_acs_val.h"
+#include "include/bsa_acs_common.h"
+#include "include/bsa_acs_hart.h"
+#include "include/bsa_acs_memory.h"
+#include "include/bsa_acs_iic.h"
+#include "include/bsa_acs_iic_perf.h"
+
+static IIC_PERF_SLOT_t *g_iic_perf_slot;
+static uint64_t *g_iic_perf_samples;
+
+/* APLIC domain saved around the wired interrupt benchmark, too large for the stack */
+static APLIC_DOMAIN_STATE g_iic_perf_aplic_state;
+
+static char8_t *iic_perf_wired_path[IIC_PERF_WIRED_PATHS] = { "direct", "msi", "imsic" };
+
+/* Storm rate steps in MSIs per second, 0 is back to back */
+static const uint32_t iic_perf_storm_rates[IIC_PERF_STORM_STEPS] = {
+  1000, 10000, 100000, 500000, 1000000, 0
+};
+
+/* Pending populations of the arbitration benchmark, capped at the identity count */
+static const uint32_t iic_perf_arb_pending[IIC_PERF_ARB_STEPS] = {
+  1, 8, 32, 128, 512, 2047
+};
+
+/* Identities timed on each hart, those not below the identity count are dropped */
+static const uint32_t iic_perf_ids[IIC_PERF_MAX_IDS] = { 1, 63, 64, 255 };
+
+/* Pair under test in the IPI matrix, written by the primary hart */
+static struct {
+  volatile uint32_t test_num;
+  volatile uint32_t src;
+  volatile uint32_t dst;
+  volatile uint32_t stop;       ///< Receiver leaves its wait loop
+  volatile uint32_t stop_after; ///< Sender sets stop when done, the receiver is the primary
+  IIC_PERF_IPI_RESULT_t *result;
+} g_iic_perf_ipi;
+
+/**
+  @brief   S-level external interrupt handler used by the IIC benchmarks.
+           Timestamps entry first, then claims through stopei, or through
+           the IDC when the slot names an APLIC in direct mode, and, when the
+           slot names a reply, answers with one MSI.
+**/
+static
+void
+iic_perf_isr(uint64_t type, void *context)
+{
+  uint64_t now = val_timer_get_counter();
+  IIC_PERF_SLOT_t *slot = &g_iic_perf_slot[val_hart_get_index_mpid(val_hart_get_mpid())];
+
+  (void)type;
+  (void)context;
+
+  if (slot->aplic)
+      slot->claimed = val_iic_aplic_idc_claim(slot->aplic, slot->idc);
+  else
+      slot->claimed = val_iic_imsic_claim();
+  if (slot->reply != NULL)
+      *slot->reply = slot->reply_id;
+  slot->entry   = now;
+  slot->count++;
+  slot->done    = 1;
+}
+
+/**
+  @brief   Supervisor guest external interrupt handler. Claims from the guest
+           interrupt file selected by hstatus.VGEIN through vstopei, which
+           also drops the hgeip bit that raised the interrupt.
+**/
+static
+void
+iic_perf_sgei_isr(uint64_t type, void *context)
+{
+  uint64_t now = val_timer_get_counter();
+  IIC_PERF_SLOT_t *slot = &g_iic_perf_slot[val_hart_get_index_mpid(val_hart_get_mpid())];
+
+  (void)type;
+  (void)context;
+
+  slot->claimed = val_iic_guest_claim();
+  slot->entry   = now;
+  slot->count++;
+  slot->done    = 1;
+}
+
+/**
+  @brief   Allocate the per hart handshake slots and sample buffers, map every
+           hart's S-level interrupt file and install the benchmark handler.
+           1. Caller       -  Test Suite, on the primary hart
+           2. Prerequisite -  val_hart_create_info_table, val_gic_create_info_table
+  @return  ACS_STATUS_PASS, or ACS_STATUS_ERR on allocation or install failure
+**/
+uint32_t
+val_iic_perf_init(void)
+{
+  uint32_t num_hart = val_hart_get_num();
+  uint32_t i;
+  uint64_t imsic_base;
+
+  g_iic_perf_slot = val_aligned_alloc(sizeof(IIC_PERF_SLOT_t), num_hart * sizeof(IIC_PERF_SLOT_t));
+  g_iic_perf_samples = val_memory_alloc(num_hart * IIC_PERF_MAX_SAMPLES * sizeof(uint64_t));
+  if (g_iic_perf_slot == NULL || g_iic_perf_samples == NULL) {
+      val_print(ACS_PRINT_ERR, "\n       IIC perf buffer allocation failed", 0);
+      val_iic_perf_free();
+      return ACS_STATUS_ERR;
+  }
+  val_memory_set(g_iic_perf_slot, num_hart * sizeof(IIC_PERF_SLOT_t), 0);
+
+  for (i = 0; i < num_hart; i++) {
+      imsic_base = val_hart_get_imsic_base(i);
+      if (imsic_base)
+          val_memory_map_add_mmio(imsic_base, 0x1000);
+  }
+
+  if (val_hart_install_esr(EXCEPT_RISCV_IRQ_EXT_FROM_SMODE, iic_perf_isr)) {
+      val_print(ACS_PRINT_ERR, "\n       External interrupt handler install failed", 0);
+      val_iic_perf_free();
+      return ACS_STATUS_ERR;
+  }
+
+  return ACS_STATUS_PASS;
+}
+
+/**
+  @brief   Release the buffers allocated by val_iic_perf_init.
+**/
+void
+val_iic_perf_free(void)
+{
+  if (g_iic_perf_slot != NULL) {
+      val_memory_free_aligned(g_iic_perf_slot);
+      g_iic_perf_slot = NULL;
+  }
+  if (g_iic_perf_samples != NULL) {
+      val_memory_free(g_iic_perf_samples);
+      g_iic_perf_samples = NULL;
+  }
+}
+
+/**
+  @brief   Return the handshake slot of a hart.
+  @param   index - hart index
+**/
+IIC_PERF_SLOT_t *
+val_iic_perf_slot(uint32_t index)
+{
+  return &g_iic_perf_slot[index];
+}
+
+/**
+  @brief   Sort the samples in place and summarise them with nearest rank
+           percentiles.
+  @param   samples - latencies in counter ticks
+  @param   count   - number of samples
+  @param   stats   - summary, all zero when count is 0
+  @return  None
+**/
+void
+val_iic_perf_stats(uint64_t *samples, uint32_t count, IIC_PERF_STATS_t *stats)
+{
+  uint32_t i, j;
+  uint64_t v;
+
+  val_memory_set(stats, sizeof(IIC_PERF_STATS_t), 0);
+  if (count == 0)
+      return;
+
+  for (i = 1; i < count; i++) {
+      v = samples[i];
+      for (j = i; j > 0 && samples[j - 1] > v; j--)
+          samples[j] = samples[j - 1];
+      samples[j] = v;
+  }
+
+  stats->count  = count;
+  stats->min    = samples[0];
+  stats->median = samples[(count - 1) / 2];
+  stats->p99    = samples[(count * 99 + 99) / 100 - 1];
+  stats->max    = samples[count - 1];
+}
+
+/**
+  @brief   Convert counter ticks to nanoseconds.
+**/
+uint64_t
+val_iic_perf_ticks_to_ns(uint64_t ticks)
+{
+  uint64_t freq = val_timer_get_info(TIMER_INFO_CNTFREQ, 0);
+
+  if (freq == 0)
+      return 0;
+
+  return (ticks * 1000000000ULL) / freq;
+}
+
+/**
+  @brief   Time one MSI from the write to the hart's seteipnum_le register to
+           entry of its handler.
+  @return  Latency in counter ticks, or ~0 if the MSI was lost or misclaimed
+**/
+static
+uint64_t
+iic_perf_msi_sample(volatile uint32_t *seteipnum, IIC_PERF_SLOT_t *slot, uint32_t id,
+                    uint64_t timeout, IIC_PERF_MSI_RESULT_t *result)
+{
+  uint64_t start;
+
+  slot->done = 0;
+  start = val_timer_get_counter();
+
+  /* direct store, pal_mmio_write may print */
+  *seteipnum = id;
+
+  while (!slot->done) {
+      if (val_timer_get_counter() - start > timeout) {
+          val_iic_imsic_eix_update(id, true, 0);
+          result->lost++;
+          return ~0ULL;
+      }
+  }
+
+  if (slot->claimed != id) {
+      result->misclaimed++;
+      return ~0ULL;
+  }
+
+  return slot->entry - start;
+}
+
+/**
+  @brief   Measure MSI to handler latency on the calling hart for a set of
+           identities, with eithreshold off. The S-level interrupt file is
+           saved before and restored after.
+           1. Caller       -  Test Suite, on the hart being measured
+           2. Prerequisite -  val_iic_perf_init
+  @param   result - per identity summaries, overall summary and log2 histogram
+  @return  ACS_STATUS_PASS, ACS_STATUS_SKIP without an interrupt file
+**/
+uint32_t
+val_iic_perf_msi_latency(IIC_PERF_MSI_RESULT_t *result)
+{
+  uint32_t index = val_hart_get_index_mpid(val_hart_get_mpid());
+  uint32_t intr_num = val_gic_max_supervisor_intr_num();
+  IIC_PERF_SLOT_t *slot = &g_iic_perf_slot[index];
+  uint64_t *samples = &g_iic_perf_samples[(uint64_t)index * IIC_PERF_MAX_SAMPLES];
+  IMSIC_FILE_STATE state;
+  volatile uint32_t *seteipnum;
+  uint64_t imsic_base, timeout, ticks;
+  uint32_t i, s, n = 0, first, b;
+
+  val_memory_set(result, sizeof(IIC_PERF_MSI_RESULT_t), 0);
+
+  imsic_base = val_hart_get_imsic_base(index);
+  if (imsic_base == 0)
+      return ACS_STATUS_SKIP;
+  seteipnum = (volatile uint32_t *)(imsic_base + IMSIC_MMIO_PAGE_LE);
+
+  for (i = 0; i < IIC_PERF_MAX_IDS; i++) {
+      if (iic_perf_ids[i] < intr_num)
+          result->id[result->num_ids++] = iic_perf_ids[i];
+  }
+
+  timeout = val_timer_get_info(TIMER_INFO_CNTFREQ, 0) * IIC_PERF_SAMPLE_TIMEOUT_US / 1000000;
+  if (timeout == 0)
+      timeout = 1;
+
+  /* eithreshold masking is checked by the arbitration test, not timed here */
+  val_iic_imsic_file_save(&state);
+  val_iic_imsic_eithreshold_update(0);
+  val_iic_imsic_eidelivery_update(1);
+  for (i = 0; i < result->num_ids; i++)
+      val_iic_imsic_eix_update(result->id[i], false, 1);
+  val_iic_ext_intr_enable(true);
+
+  for (i = 0; i < result->num_ids; i++) {
+      first = n;
+      for (s = 0; s < IIC_PERF_SAMPLES; s++) {
+          ticks = iic_perf_msi_sample(seteipnum, slot, result->id[i], timeout, result);
+          if (ticks != ~0ULL)
+              samples[n++] = ticks;
+      }
+      val_iic_perf_stats(&samples[first], n - first, &result->stats[i]);
+  }
+
+  val_iic_ext_intr_enable(false);
+  val_iic_imsic_file_restore(&state);
+
+  for (s = 0; s < n; s++) {
+      for (b = 0; b < IIC_PERF_BUCKETS - 1 && (samples[s] >> (b + 1)); b++)
+          ;
+      result->hist[b]++;
+  }
+  val_iic_perf_stats(samples, n, &result->total);
+
+  return ACS_STATUS_PASS;
+}
+
+/**
+  @brief   Print one latency summary in nanoseconds:
+           ,<count>,<min>,<median>,<p99>,<max>
+**/
+static
+void
+iic_perf_report_stats(IIC_PERF_STATS_t *stats)
+{
+  val_print(ACS_PRINT_TEST, ",%d", stats->count);
+  val_print(ACS_PRINT_TEST, ",%ld", val_iic_perf_ticks_to_ns(stats->min));
+  val_print(ACS_PRINT_TEST, ",%ld", val_iic_perf_ticks_to_ns(stats->median));
+  val_print(ACS_PRINT_TEST, ",%ld", val_iic_perf_ticks_to_ns(stats->p99));
+  val_print(ACS_PRINT_TEST, ",%ld", val_iic_perf_ticks_to_ns(stats->max));
+}
+
+/**
+  @brief   Print the MSI latency of one hart:
+           IICPERF,RES,<hart>,<time counter Hz>,<ns per tick>
+           IICPERF,MSI,<hart>,<id>,<count>,<min>,<median>,<p99>,<max>
+           IICPERF,MSI,<hart>,all,<count>,<min>,<median>,<p99>,<max>
+           IICPERF,HIST,<hart>,<samples below 2 ticks>,<2..3>,<4..7>,...
+           with latencies in nanoseconds. Samples are taken with the time
+           counter, so latencies are only resolved to one tick.
+**/
+void
+val_iic_perf_report_msi(uint32_t index, IIC_PERF_MSI_RESULT_t *result)
+{
+  uint64_t freq = val_timer_get_info(TIMER_INFO_CNTFREQ, 0);
+  uint32_t i;
+
+  val_print(ACS_PRINT_TEST, "\n       IICPERF,RES,%d", index);
+  val_print(ACS_PRINT_TEST, ",%ld", freq);
+  val_print(ACS_PRINT_TEST, ",%ld", freq ? (1000000000ULL + freq - 1) / freq : 0);
+
+  for (i = 0; i < result->num_ids; i++) {
+      val_print(ACS_PRINT_TEST, "\n       IICPERF,MSI,%d", index);
+      val_print(ACS_PRINT_TEST, ",%d", result->id[i]);
+      iic_perf_report_stats(&result->stats[i]);
+  }
+
+  val_print(ACS_PRINT_TEST, "\n       IICPERF,MSI,%d,all", index);
+  iic_perf_report_stats(&result->total);
+
+  val_print(ACS_PRINT_TEST, "\n       IICPERF,HIST,%d", index);
+  for (i = 0; i < IIC_PERF_BUCKETS; i++)
+      val_print(ACS_PRINT_TEST, ",%d", result->hist[i]);
+
+  if (result->lost || result->misclaimed) {
+      val_print(ACS_PRINT_ERR, "\n       Hart %d", index);
+      val_print(ACS_PRINT_ERR, " lost %d MSIs", result->lost);
+      val_print(ACS_PRINT_ERR, ", %d claimed with another identity", result->misclaimed);
+  }
+}
+
+/**
+  @brief   Save the calling hart's interrupt file and set it up to take one
+           identity with no threshold.
+**/
+static
+void
+iic_perf_file_arm(IMSIC_FILE_STATE *state, IIC_PERF_SLOT_t *slot, uint32_t id)
+{
+  val_iic_imsic_file_save(state);
+  val_iic_imsic_eithreshold_update(0);
+  val_iic_imsic_eidelivery_update(1);
+  val_iic_imsic_eix_update(id, false, 1);
+  slot->done = 0;
+  val_iic_ext_intr_enable(true);
+  slot->armed = 1;
+}
+
+static
+void
+iic_perf_file_disarm(IMSIC_FILE_STATE *state, IIC_PERF_SLOT_t *slot)
+{
+  slot->armed = 0;
+  val_iic_ext_intr_enable(false);
+  val_iic_imsic_file_restore(state);
+}
+
+static
+volatile uint32_t *
+iic_perf_seteipnum(uint32_t index)
+{
+  return (volatile uint32_t *)(val_hart_get_imsic_base(index) + IMSIC_MMIO_PAGE_LE);
+}
+
+/**
+  @brief   IPI receiver. Parks with its interrupt file armed for the ping
+           identity; the handler answers every ping with a pong to the
+           sender named in the slot, so the loop only waits to be stopped.
+           A sender that never stops it fails the receiver after
+           IIC_PERF_HART_TIMEOUT_S.
+**/
+static
+void
+iic_perf_ipi_receiver(void)
+{
+  uint32_t index = val_hart_get_index_mpid(val_hart_get_mpid());
+  IIC_PERF_SLOT_t *slot = &g_iic_perf_slot[index];
+  uint64_t freq = val_timer_get_info(TIMER_INFO_CNTFREQ, 0);
+  uint64_t start;
+  IMSIC_FILE_STATE state;
+
+  iic_perf_file_arm(&state, slot, IIC_PERF_IPI_PING_ID);
+  start = val_timer_get_counter();
+  while (!g_iic_perf_ipi.stop) {
+      if (freq && (val_timer_get_counter() - start) > freq * IIC_PERF_HART_TIMEOUT_S)
+          break;
+  }
+  iic_perf_file_disarm(&state, slot);
+  slot->reply = NULL;
+
+  if (!g_iic_perf_ipi.stop) {
+      val_print(ACS_PRINT_ERR, "\n       HART %d was never stopped", index);
+      val_set_status(index, RESULT_FAIL(g_iic_perf_ipi.test_num, 1));
+      return;
+  }
+
+  val_set_status(index, RESULT_PASS(g_iic_perf_ipi.test_num, 1));
+}
+
+/**
+  @brief   IPI sender. Pings the receiver IIC_PERF_SAMPLES times and times
+           each round trip up to entry of its own pong handler.
+**/
+static
+void
+iic_perf_ipi_sender(void)
+{
+  uint32_t index = val_hart_get_index_mpid(val_hart_get_mpid());
+  uint32_t dst = g_iic_perf_ipi.dst;
+  uint32_t num = g_iic_perf_ipi.result->num_hart;
+  IIC_PERF_SLOT_t *slot = &g_iic_perf_slot[index];
+  IIC_PERF_SLOT_t *peer = &g_iic_perf_slot[dst];
+  uint64_t *samples = &g_iic_perf_samples[(uint64_t)index * IIC_PERF_MAX_SAMPLES];
+  volatile uint32_t *ping = iic_perf_seteipnum(dst);
+  IMSIC_FILE_STATE state;
+  uint64_t timeout, start;
+  uint32_t s, n = 0;
+
+  timeout = val_timer_get_info(TIMER_INFO_CNTFREQ, 0) * IIC_PERF_SAMPLE_TIMEOUT_US / 1000000;
+  if (timeout == 0)
+      timeout = 1;
+
+  iic_perf_file_arm(&state, slot, IIC_PERF_IPI_PONG_ID);
+
+  start = val_timer_get_counter();
+  while (!peer->armed) {
+      if (val_timer_get_counter() - start > timeout * IIC_PERF_SAMPLES)
+          break;
+  }
+
+  for (s = 0; peer->armed && s < IIC_PERF_SAMPLES; s++) {
+      slot->done = 0;
+      start = val_timer_get_counter();
+      *ping = IIC_PERF_IPI_PING_ID;
+      while (!slot->done && val_timer_get_counter() - start <= timeout)
+          ;
+      if (slot->done && slot->claimed == IIC_PERF_IPI_PONG_ID)
+          samples[n++] = slot->entry - start;
+  }
+
+  iic_perf_file_disarm(&state, slot);
+
+  g_iic_perf_ipi.result->lost += IIC_PERF_SAMPLES - n;
+  val_iic_perf_stats(samples, n, &g_iic_perf_ipi.result->pair[index * num + dst]);
+
+  if (g_iic_perf_ipi.stop_after)
+      g_iic_perf_ipi.stop = 1;
+
+  val_set_status(index, RESULT_PASS(g_iic_perf_ipi.test_num, 1));
+}
+
+/**
+  @brief   Wait for a hart started with val_execute_on_pe to report back.
+**/
+static
+uint32_t
+iic_perf_wait_hart(uint32_t index)
+{
+  uint64_t freq = val_timer_get_info(TIMER_INFO_CNTFREQ, 0);
+  uint64_t start = val_timer_get_counter();
+
+  while (IS_RESULT_PENDING(val_get_status(index))) {
+      if (freq && (val_timer_get_counter() - start) > freq * IIC_PERF_HART_TIMEOUT_S) {
+          val_print(ACS_PRINT_ERR, "\n       HART %d timed out", index);
+          return ACS_STATUS_FAIL;
+      }
+  }
+
+  return ACS_STATUS_PASS;
+}
+
+/**
+  @brief   Measure IPI round trip latency between every ordered pair of the
+           first IIC_PERF_IPI_MAX_HARTS harts. For each receiver the primary
+           parks it in an armed wait loop with val_execute_on_pe, then runs
+           the sender on every other hart in turn. A primary receiver runs
+           the wait loop itself while the sender is started remotely.
+           1. Caller       -  Test Suite, on the primary hart
+           2. Prerequisite -  val_iic_perf_init
+  @param   test_num - test whose status is used for the handshakes
+  @param   result   - pair matrix, allocated here and freed by the caller
+  @return  ACS_STATUS_PASS, ACS_STATUS_SKIP with fewer than two harts or
+           when a hart could not be started, ACS_STATUS_FAIL if a hart did
+           not respond
+**/
+uint32_t
+val_iic_perf_ipi_matrix(uint32_t test_num, IIC_PERF_IPI_RESULT_t *result)
+{
+  uint32_t primary = val_hart_get_index_mpid(val_hart_get_mpid());
+  uint32_t num = val_hart_get_num();
+  uint32_t src, dst, status = ACS_STATUS_PASS;
+
+  if (num > IIC_PERF_IPI_MAX_HARTS)
+      num = IIC_PERF_IPI_MAX_HARTS;
+
+  result->num_hart = num;
+  result->lost = 0;
+  result->pair = NULL;
+  if (num < 2)
+      return ACS_STATUS_SKIP;
+
+  result->pair = val_memory_calloc(num * num, sizeof(IIC_PERF_STATS_t));
+  if (result->pair == NULL)
+      return ACS_STATUS_ERR;
+
+  g_iic_perf_ipi.test_num = test_num;
+  g_iic_perf_ipi.result = result;
+
+  for (dst = 0; dst < num && status == ACS_STATUS_PASS; dst++) {
+      if (val_hart_get_imsic_base(dst) == 0)
+          continue;
+
+      g_iic_perf_ipi.dst = dst;
+      g_iic_perf_ipi.stop = 0;
+      if (dst != primary) {
+          g_iic_perf_ipi.stop_after = 0;
+          if (val_hart_start_payload(test_num, dst, iic_perf_ipi_receiver)) {
+              status = ACS_STATUS_SKIP;
+              break;
+          }
+      }
+
+      for (src = 0; src < num; src++) {
+          if (src == dst || val_hart_get_imsic_base(src) == 0)
+              continue;
+
+          g_iic_perf_ipi.src = src;
+          g_iic_perf_slot[dst].reply_id = IIC_PERF_IPI_PONG_ID;
+          g_iic_perf_slot[dst].reply = iic_perf_seteipnum(src);
+
+          if (dst == primary) {
+              /* the primary is the receiver, start the sender and wait here */
+              g_iic_perf_ipi.stop = 0;
+              g_iic_perf_ipi.stop_after = 1;
+              if (val_hart_start_payload(test_num, src, iic_perf_ipi_sender)) {
+                  status = ACS_STATUS_SKIP;
+                  break;
+              }
+              iic_perf_ipi_receiver();
+              if (!IS_TEST_PASS(val_get_status(primary)) || iic_perf_wait_hart(src))
+                  status = ACS_STATUS_FAIL;
+          } else {
+              status = val_hart_run_payload(test_num, src, iic_perf_ipi_sender,
+                                            IIC_PERF_HART_TIMEOUT_S);
+              if (status)
+                  break;
+          }
+      }
+
+      if (dst != primary) {
+          g_iic_perf_ipi.stop = 1;
+          if ((iic_perf_wait_hart(dst) || !IS_TEST_PASS(val_get_status(dst))) &&
+              status == ACS_STATUS_PASS)
+              status = ACS_STATUS_FAIL;
+      }
+  }
+
+  return status;
+}
+
+/**
+  @brief   Print the IPI matrix:
+           IICPERF,IPIROW,<sender>,<median to hart 0>,<median to hart 1>,...
+           with - on the diagonal and for pairs that were not measured, and
+           at debug verbosity one line per pair:
+           IICPERF,IPI,<sender>,<receiver>,<count>,<min>,<median>,<p99>,<max>
+           Latencies are round trips in nanoseconds.
+**/
+void
+val_iic_perf_report_ipi(IIC_PERF_IPI_RESULT_t *result)
+{
+  IIC_PERF_STATS_t *stats;
+  uint32_t src, dst, num = result->num_hart;
+
+  if (val_hart_get_num() > num)
+      val_print(ACS_PRINT_TEST, "\n       IPI matrix limited to the first %d harts", num);
+
+  for (src = 0; src < num; src++) {
+      val_print(ACS_PRINT_TEST, "\n       IICPERF,IPIROW,%d", src);
+      for (dst = 0; dst < num; dst++) {
+          stats = &result->pair[src * num + dst];
+          if (stats->count == 0)
+              val_print(ACS_PRINT_TEST, ",-", 0);
+          else
+              val_print(ACS_PRINT_TEST, ",%ld", val_iic_perf_ticks_to_ns(stats->median));
+      }
+  }
+
+  for (src = 0; src < num; src++) {
+      for (dst = 0; dst < num; dst++) {
+          stats = &result->pair[src * num + dst];
+          if (stats->count == 0)
+              continue;
+          val_print(ACS_PRINT_DEBUG, "\n       IICPERF,IPI,%d", src);
+          val_print(ACS_PRINT_DEBUG, ",%d", dst);
+          val_print(ACS_PRINT_DEBUG, ",%d", stats->count);
+          val_print(ACS_PRINT_DEBUG, ",%ld", val_iic_perf_ticks_to_ns(stats->min));
+          val_print(ACS_PRINT_DEBUG, ",%ld", val_iic_perf_ticks_to_ns(stats->median));
+          val_print(ACS_PRINT_DEBUG, ",%ld", val_iic_perf_ticks_to_ns(stats->p99));
+          val_print(ACS_PRINT_DEBUG, ",%ld", val_iic_perf_ticks_to_ns(stats->max));
+      }
+  }
+
+  if (result->lost)
+      val_print(ACS_PRINT_ERR, "\n       %d IPIs were not answered", result->lost);
+}
+
+/**
+  @brief   Set up one delivery path of the wired interrupt benchmark on the
+           calling hart.
+  @return  0 if the path is available, 1 otherwise
+**/
+static
+uint32_t
+iic_perf_wired_setup(uint32_t path, uint64_t base, uint32_t source, uint32_t index,
+                     uint32_t idc, IIC_PERF_SLOT_t *slot)
+{
+  uint64_t imsic_base = val_hart_get_imsic_base(index);
+
+  slot->aplic = 0;
+
+  switch (path) {
+  case IIC_PERF_WIRED_DIRECT:
+      if (idc == APLIC_IDC_NONE || val_iic_aplic_set_mode(base, false))
+          return 1;
+      /* with an interrupt file the hart only sees the IDC if eidelivery allows it */
+      if (imsic_base &&
+          val_iic_imsic_eidelivery_update(IMSIC_EIDELIVERY_APLIC) != IMSIC_EIDELIVERY_APLIC)
+          return 1;
+      val_iic_aplic_target_direct(base, source, idc, IIC_PERF_WIRED_PRIO);
+      val_iic_aplic_idc_config(base, idc, true, 0);
+      slot->idc = idc;
+      slot->aplic = base;
+      break;
+
+  case IIC_PERF_WIRED_MSI:
+      if (imsic_base == 0 || val_iic_aplic_set_mode(base, true))
+          return 1;
+      val_iic_aplic_target_msi(base, source, val_iic_imsic_msi_hart_index(index),
+                               IIC_PERF_WIRED_EIID);
+      /* fall through, the MSI lands in the interrupt file */
+  case IIC_PERF_WIRED_IMSIC:
+      if (imsic_base == 0)
+          return 1;
+      val_iic_imsic_eithreshold_update(0);
+      val_iic_imsic_eidelivery_update(1);
+      val_iic_imsic_eix_update(IIC_PERF_WIRED_EIID, false, 1);
+      break;
+
+  default:
+      return 1;
+  }
+
+  if (path != IIC_PERF_WIRED_IMSIC)
+      val_iic_aplic_source_enable(base, source, true);
+
+  return 0;
+}
+
+/**
+  @brief   Measure source trigger to handler entry latency of an APLIC on the
+           calling hart. A free source is put in detached mode and made
+           pending through setipnum, the software equivalent of an edge on
+           its wire, then taken:
+           1. in direct mode, claimed through the hart's IDC,
+           2. in MSI mode, forwarded to the hart's interrupt file and claimed
+              through stopei,
+           3. as a baseline, the same identity written straight to the
+              interrupt file, so 2 minus 3 is the cost of the forwarding hop.
+           Paths the domain or hart cannot take are skipped. The domain and
+           the interrupt file are restored afterwards.
+           1. Caller       -  Test Suite, on the hart being measured
+           2. Prerequisite -  val_iic_perf_init
+  @param   aplic  - APLIC index
+  @param   result - per path summaries
+  @return  ACS_STATUS_PASS, ACS_STATUS_SKIP without a free source
+**/
+uint32_t
+val_iic_perf_wired_latency(uint32_t aplic, IIC_PERF_WIRED_RESULT_t *result)
+{
+  uint32_t index = val_hart_get_index_mpid(val_hart_get_mpid());
+  IIC_PERF_SLOT_t *slot = &g_iic_perf_slot[index];
+  uint64_t *samples = &g_iic_perf_samples[(uint64_t)index * IIC_PERF_MAX_SAMPLES];
+  uint64_t base = val_iic_aplic_get_info(aplic, APLIC_INFO_BASE);
+  uint64_t imsic_base = val_hart_get_imsic_base(index);
+  volatile uint32_t *seteipnum = (volatile uint32_t *)(imsic_base + IMSIC_MMIO_PAGE_LE);
+  uint32_t ext_id = val_hart_get_ext_intc_id(index);
+  uint32_t idc = APLIC_IDC_NONE;
+  uint32_t source, path, expect, s, n;
+  IMSIC_FILE_STATE file;
+  uint64_t timeout, start;
+
+  val_memory_set(result, sizeof(IIC_PERF_WIRED_RESULT_t), 0);
+  result->aplic_id = (uint32_t)val_iic_aplic_get_info(aplic, APLIC_INFO_ID);
+  if (base == 0)
+      return ACS_STATUS_SKIP;
+
+  source = val_iic_aplic_find_free_source(base,
+                                          (uint32_t)val_iic_aplic_get_info(aplic, APLIC_INFO_NUM_SOURCES));
+  if (source == 0) {
+      val_print(ACS_PRINT_DEBUG, "\n       No free source in APLIC %d", result->aplic_id);
+      return ACS_STATUS_SKIP;
+  }
+  result->source = source;
+
+  /* the RINTC names the IDC as APLIC ID in bits [31:24] and IDC in bits [15:0] */
+  if (val_iic_aplic_get_info(aplic, APLIC_INFO_NUM_IDC) && (ext_id >> 24) == result->aplic_id)
+      idc = ext_id & 0xFFFF;
+
+  timeout = val_timer_get_info(TIMER_INFO_CNTFREQ, 0) * IIC_PERF_SAMPLE_TIMEOUT_US / 1000000;
+  if (timeout == 0)
+      timeout = 1;
+
+  val_iic_aplic_domain_save(base, idc, &g_iic_perf_aplic_state);
+  if (imsic_base)
+      val_iic_imsic_file_save(&file);
+  val_iic_aplic_source_config(base, source, APLIC_SM_DETACHED);
+
+  for (path = 0; path < IIC_PERF_WIRED_PATHS; path++) {
+      if (iic_perf_wired_setup(path, base, source, index, idc, slot)) {
+          if (imsic_base)
+              val_iic_imsic_file_restore(&file);
+          continue;
+      }
+
+      result->supported[path] = 1;
+      expect = (path == IIC_PERF_WIRED_DIRECT) ? source : IIC_PERF_WIRED_EIID;
+      val_iic_ext_intr_enable(true);
+
+      for (s = 0, n = 0; s < IIC_PERF_SAMPLES; s++) {
+          slot->done = 0;
+          start = val_timer_get_counter();
+
+          if (path == IIC_PERF_WIRED_IMSIC)
+              *seteipnum = IIC_PERF_WIRED_EIID;
+          else
+              val_iic_aplic_source_pend(base, source, true);
+
+          while (!slot->done && val_timer_get_counter() - start <= timeout)
+              ;
+
+          if (!slot->done) {
+              val_iic_aplic_source_pend(base, source, false);
+              if (imsic_base)
+                  val_iic_imsic_eix_update(IIC_PERF_WIRED_EIID, true, 0);
+              result->lost[path]++;
+          } else if (slot->claimed != expect) {
+              result->misclaimed[path]++;
+          } else {
+              samples[n++] = slot->entry - start;
+          }
+      }
+
+      val_iic_ext_intr_enable(false);
+      val_iic_aplic_source_enable(base, source, false);
+      slot->aplic = 0;
+      if (imsic_base)
+          val_iic_imsic_file_restore(&file);
+
+      val_iic_perf_stats(samples, n, &result->stats[path]);
+  }
+
+  val_iic_aplic_source_config(base, source, APLIC_SM_INACTIVE);
+  val_iic_aplic_domain_restore(base, &g_iic_perf_aplic_state);
+
+  return ACS_STATUS_PASS;
+}
+
+/**
+  @brief   Print the wired interrupt latency of one APLIC:
+           IICPERF,WIRED,<aplic>,<source>,<path>,<count>,<min>,<median>,<p99>,<max>
+           IICPERF,WIRED,<aplic>,<source>,<path>,unsupported
+           IICPERF,WIRED,<aplic>,<source>,hop,<msi median - imsic median>
+           with path direct, msi or imsic and latencies in nanoseconds.
+**/
+void
+val_iic_perf_report_wired(IIC_PERF_WIRED_RESULT_t *result)
+{
+  uint64_t msi, imsic;
+  uint32_t path;
+
+  for (path = 0; path < IIC_PERF_WIRED_PATHS; path++) {
+      val_print(ACS_PRINT_TEST, "\n       IICPERF,WIRED,%d", result->aplic_id);
+      val_print(ACS_PRINT_TEST, ",%d,", result->source);
+      val_print(ACS_PRINT_TEST, iic_perf_wired_path[path], 0);
+      if (!result->supported[path]) {
+          val_print(ACS_PRINT_TEST, ",unsupported", 0);
+          continue;
+      }
+      iic_perf_report_stats(&result->stats[path]);
+
+      if (result->lost[path] || result->misclaimed[path]) {
+          val_print(ACS_PRINT_ERR, "\n       Lost %d interrupts", result->lost[path]);
+          val_print(ACS_PRINT_ERR, ", %d claimed with another ID", result->misclaimed[path]);
+      }
+  }
+
+  if (result->stats[IIC_PERF_WIRED_MSI].count && result->stats[IIC_PERF_WIRED_IMSIC].count) {
+      msi   = val_iic_perf_ticks_to_ns(result->stats[IIC_PERF_WIRED_MSI].median);
+      imsic = val_iic_perf_ticks_to_ns(result->stats[IIC_PERF_WIRED_IMSIC].median);
+      val_print(ACS_PRINT_TEST, "\n       IICPERF,WIRED,%d", result->aplic_id);
+      val_print(ACS_PRINT_TEST, ",%d,hop", result->source);
+      val_print(ACS_PRINT_TEST, ",%ld", (msi > imsic) ? msi - imsic : 0);
+  }
+}
+
+/**
+  @brief   Send one storm MSI from the hart itself.
+**/
+static
+void
+iic_perf_storm_send(volatile uint32_t *seteipnum)
+{
+  *seteipnum = IIC_PERF_STORM_EIID;
+}
+
+/**
+  @brief   Drive MSIs at the calling hart at increasing rates and count how
+           many reach its handler. Each step sends up to IIC_PERF_STORM_MSIS
+           MSIs, paced by the time counter, for at most
+           IIC_PERF_STORM_STEP_US, then waits for the handler to go quiet.
+           An MSI that arrives while the identity is still pending merges
+           with it, so delivered falls behind generated once the hart can no
+           longer keep up; the first step losing more than
+           IIC_PERF_STORM_LOSS_PPM is the saturation point. MSIs the hart
+           sends itself are taken before the next store, which makes the
+           back to back step a measure of the full trap and claim cost.
+           1. Caller       -  Test Suite, on the hart being measured
+           2. Prerequisite -  val_iic_perf_init
+  @param   source - exerciser instance, or IIC_PERF_STORM_SELF
+  @param   result - per step counts
+  @return  ACS_STATUS_PASS, ACS_STATUS_SKIP without an interrupt file or time
+           counter, and for exerciser sources
+**/
+uint32_t
+val_iic_perf_storm(uint32_t source, IIC_PERF_STORM_RESULT_t *result)
+{
+  uint32_t index = val_hart_get_index_mpid(val_hart_get_mpid());
+  IIC_PERF_SLOT_t *slot = &g_iic_perf_slot[index];
+  uint64_t imsic_base = val_hart_get_imsic_base(index);
+  uint64_t freq = val_timer_get_info(TIMER_INFO_CNTFREQ, 0);
+  volatile uint32_t *seteipnum = (volatile uint32_t *)(imsic_base + IMSIC_MMIO_PAGE_LE);
+  uint64_t step_ticks, drain, interval, start, next, quiet;
+  uint32_t st, g, count;
+  IIC_PERF_STORM_STEP_t *step;
+  IMSIC_FILE_STATE state;
+
+  val_memory_set(result, sizeof(IIC_PERF_STORM_RESULT_t), 0);
+  result->source = source;
+
+  if (imsic_base == 0 || freq == 0)
+      return ACS_STATUS_SKIP;
+
+  /* acs_exerciser.c is not part of the RISC-V build yet, so exerciser
+     sources cannot generate MSIs */
+  if (source != IIC_PERF_STORM_SELF) {
+      val_print(ACS_PRINT_DEBUG, "\n       Exerciser %d storm not supported", source);
+      return ACS_STATUS_SKIP;
+  }
+
+  step_ticks = freq * IIC_PERF_STORM_STEP_US / 1000000;
+  drain = freq * IIC_PERF_SAMPLE_TIMEOUT_US / 1000000;
+  if (drain == 0)
+      drain = 1;
+
+  val_iic_imsic_file_save(&state);
+  val_iic_imsic_eithreshold_update(0);
+  val_iic_imsic_eidelivery_update(1);
+  val_iic_imsic_eix_update(IIC_PERF_STORM_EIID, false, 1);
+  val_iic_ext_intr_enable(true);
+
+  for (st = 0; st < IIC_PERF_STORM_STEPS; st++) {
+      step = &result->step[st];
+      step->rate = iic_perf_storm_rates[st];
+      interval = step->rate ? freq / step->rate : 0;
+
+      slot->count = 0;
+      start = val_timer_get_counter();
+      next = start;
+      for (g = 0; g < IIC_PERF_STORM_MSIS; g++) {
+          if (interval) {
+              while (val_timer_get_counter() < next)
+                  ;
+              next += interval;
+          }
+          if (val_timer_get_counter() - start > step_ticks)
+              break;
+          iic_perf_storm_send(seteipnum);
+      }
+      step->generated = g;
+
+      /* the step is over once no interrupt was taken for a whole drain period */
+      count = slot->count;
+      quiet = val_timer_get_counter();
+      while (val_timer_get_counter() - quiet <= drain) {
+          if (slot->count != count) {
+              count = slot->count;
+              quiet = val_timer_get_counter();
+          }
+      }
+
+      step->delivered = slot->count;
+      step->elapsed = step->delivered ? slot->entry - start : 0;
+      val_iic_imsic_eix_update(IIC_PERF_STORM_EIID, true, 0);
+  }
+
+  val_iic_ext_intr_enable(false);
+  val_iic_imsic_file_restore(&state);
+
+  result->num_steps = IIC_PERF_STORM_STEPS;
+  result->saturation = result->num_steps;
+  for (st = 0; st < result->num_steps; st++) {
+      step = &result->step[st];
+      if (step->generated &&
+          (uint64_t)(step->generated - step->delivered) * 1000000 / step->generated > IIC_PERF_STORM_LOSS_PPM) {
+          result->saturation = st;
+          break;
+      }
+  }
+
+  return ACS_STATUS_PASS;
+}
+
+/**
+  @brief   Print an interrupt storm:
+           IICPERF,STORM,<source>,<rate>,<generated>,<delivered>,<lost ppm>,<delivered per second>
+           IICPERF,STORM,<source>,saturation,<rate>,<peak delivered per second>
+           with source self or the exerciser instance, rate in MSIs per
+           second, max for back to back, and none when no step saturated.
+**/
+void
+val_iic_perf_report_storm(IIC_PERF_STORM_RESULT_t *result)
+{
+  uint64_t freq = val_timer_get_info(TIMER_INFO_CNTFREQ, 0);
+  uint64_t per_s, peak = 0;
+  IIC_PERF_STORM_STEP_t *step;
+  uint32_t st;
+
+  for (st = 0; st < result->num_steps; st++) {
+      step = &result->step[st];
+      per_s = step->elapsed ? (uint64_t)step->delivered * freq / step->elapsed : 0;
+      if (per_s > peak)
+          peak = per_s;
+
+      if (result->source == IIC_PERF_STORM_SELF)
+          val_print(ACS_PRINT_TEST, "\n       IICPERF,STORM,self", 0);
+      else
+          val_print(ACS_PRINT_TEST, "\n       IICPERF,STORM,%d", result->source);
+      if (step->rate)
+          val_print(ACS_PRINT_TEST, ",%d", step->rate);
+      else
+          val_print(ACS_PRINT_TEST, ",max", 0);
+      val_print(ACS_PRINT_TEST, ",%d", step->generated);
+      val_print(ACS_PRINT_TEST, ",%d", step->delivered);
+      val_print(ACS_PRINT_TEST, ",%ld", step->generated ?
+                (uint64_t)(step->generated - step->delivered) * 1000000 / step->generated : 0);
+      val_print(ACS_PRINT_TEST, ",%ld", per_s);
+  }
+
+  if (result->source == IIC_PERF_STORM_SELF)
+      val_print(ACS_PRINT_TEST, "\n       IICPERF,STORM,self,saturation", 0);
+  else
+      val_print(ACS_PRINT_TEST, "\n       IICPERF,STORM,%d,saturation", result->source);
+  if (result->saturation == result->num_steps)
+      val_print(ACS_PRINT_TEST, ",none", 0);
+  else if (result->step[result->saturation].rate)
+      val_print(ACS_PRINT_TEST, ",%d", result->step[result->saturation].rate);
+  else
+      val_print(ACS_PRINT_TEST, ",max", 0);
+  val_print(ACS_PRINT_TEST, ",%ld", peak);
+}
+
+/**
+  @brief   Time the IMSIC claim and complete operations on the calling hart
+           with its external interrupt masked in sie, so nothing traps. Each
+           sample is a batch of IIC_PERF_OVERHEAD_BATCH operations, each
+           preceded by setting the pending bit of the identity; the cost of
+           that alone is measured too and subtracted.
+           1. Caller       -  Test Suite, on the hart being measured
+           2. Prerequisite -  val_iic_perf_init
+  @param   result - per batch summaries
+  @return  ACS_STATUS_PASS, ACS_STATUS_SKIP without an interrupt file
+**/
+uint32_t
+val_iic_perf_overhead(IIC_PERF_OVERHEAD_RESULT_t *result)
+{
+  uint32_t index = val_hart_get_index_mpid(val_hart_get_mpid());
+  uint64_t *pend = &g_iic_perf_samples[(uint64_t)index * IIC_PERF_MAX_SAMPLES];
+  uint64_t *claim = pend + IIC_PERF_SAMPLES;
+  uint64_t *complete = claim + IIC_PERF_SAMPLES;
+  uint64_t start;
+  uint32_t s, b;
+  IMSIC_FILE_STATE state;
+
+  val_memory_set(result, sizeof(IIC_PERF_OVERHEAD_RESULT_t), 0);
+  if (val_hart_get_imsic_base(index) == 0)
+      return ACS_STATUS_SKIP;
+
+  val_iic_ext_intr_enable(false);
+  val_iic_imsic_file_save(&state);
+  val_iic_imsic_eithreshold_update(0);
+  val_iic_imsic_eidelivery_update(1);
+  val_iic_imsic_eix_update(IIC_PERF_STORM_EIID, false, 1);
+
+  for (s = 0; s < IIC_PERF_SAMPLES; s++) {
+      start = val_timer_get_counter();
+      for (b = 0; b < IIC_PERF_OVERHEAD_BATCH; b++)
+          val_iic_imsic_eix_update(IIC_PERF_STORM_EIID, true, 1);
+      pend[s] = val_timer_get_counter() - start;
+
+      start = val_timer_get_counter();
+      for (b = 0; b < IIC_PERF_OVERHEAD_BATCH; b++) {
+          val_iic_imsic_eix_update(IIC_PERF_STORM_EIID, true, 1);
+          val_iic_imsic_claim();
+      }
+      claim[s] = val_timer_get_counter() - start;
+
+      start = val_timer_get_counter();
+      for (b = 0; b < IIC_PERF_OVERHEAD_BATCH; b++) {
+          val_iic_imsic_eix_update(IIC_PERF_STORM_EIID, true, 1);
+          val_gic_end_of_interrupt(IIC_PERF_STORM_EIID);
+      }
+      complete[s] = val_timer_get_counter() - start;
+  }
+
+  val_iic_imsic_eix_update(IIC_PERF_STORM_EIID, true, 0);
+  val_iic_imsic_file_restore(&state);
+
+  val_iic_perf_stats(pend, IIC_PERF_SAMPLES, &result->pend);
+  for (s = 0; s < IIC_PERF_SAMPLES; s++) {
+      claim[s] = (claim[s] > result->pend.median) ? claim[s] - result->pend.median : 0;
+      complete[s] = (complete[s] > result->pend.median) ? complete[s] - result->pend.median : 0;
+  }
+  val_iic_perf_stats(claim, IIC_PERF_SAMPLES, &result->claim);
+  val_iic_perf_stats(complete, IIC_PERF_SAMPLES, &result->complete);
+
+  return ACS_STATUS_PASS;
+}
+
+/**
+  @brief   Print one overhead summary in nanoseconds per operation:
+           IICPERF,OVERHEAD,<op>,<count>,<min>,<median>,<p99>,<max>
+**/
+static
+void
+iic_perf_report_op(char8_t *op, IIC_PERF_STATS_t *stats)
+{
+  val_print(ACS_PRINT_TEST, "\n       IICPERF,OVERHEAD,", 0);
+  val_print(ACS_PRINT_TEST, op, 0);
+  val_print(ACS_PRINT_TEST, ",%d", stats->count);
+  val_print(ACS_PRINT_TEST, ",%ld", val_iic_perf_ticks_to_ns(stats->min) / IIC_PERF_OVERHEAD_BATCH);
+  val_print(ACS_PRINT_TEST, ",%ld", val_iic_perf_ticks_to_ns(stats->median) / IIC_PERF_OVERHEAD_BATCH);
+  val_print(ACS_PRINT_TEST, ",%ld", val_iic_perf_ticks_to_ns(stats->p99) / IIC_PERF_OVERHEAD_BATCH);
+  val_print(ACS_PRINT_TEST, ",%ld", val_iic_perf_ticks_to_ns(stats->max) / IIC_PERF_OVERHEAD_BATCH);
+}
+
+/**
+  @brief   Print the claim and complete overhead, op is pend, claim or eoi.
+**/
+void
+val_iic_perf_report_overhead(IIC_PERF_OVERHEAD_RESULT_t *result)
+{
+  iic_perf_report_op("pend", &result->pend);
+  iic_perf_report_op("claim", &result->claim);
+  iic_perf_report_op("eoi", &result->complete);
+}
+
+/**
+  @brief   Next value of the fixed seed generator used to pick identity sets,
+           so every run arbitrates the same sets.
+**/
+static
+uint32_t
+iic_perf_arb_rand(uint64_t *seed)
+{
+  *seed = *seed * 6364136223846793005ULL + 1442695040888963407ULL;
+  return (uint32_t)(*seed >> 33);
+}
+
+/**
+  @brief   Reference model of stopei: the lowest identity pending in the
+           model, or 0 if there is none or it is not below a non-zero
+           threshold.
+**/
+static
+uint32_t
+iic_perf_arb_lowest(uint64_t *model, uint32_t num_words, uint32_t threshold)
+{
+  uint32_t w, id;
+
+  for (w = 0; w < num_words; w++) {
+      if (model[w] == 0)
+          continue;
+      id = w * 64 + __builtin_ctzll(model[w]);
+      return (threshold == 0 || id < threshold) ? id : 0;
+  }
+
+  return 0;
+}
+
+/**
+  @brief   Claim from the interrupt file until stopei and the model agree
+           that nothing is left below the threshold, counting every claim
+           the model disagrees with. A disagreement ends the round since the
+           model no longer matches the file.
+  @return  0 when the file followed the model, 1 otherwise
+**/
+static
+uint32_t
+iic_perf_arb_check(uint64_t *model, uint32_t num_words, uint32_t threshold,
+                   IIC_PERF_ARB_RESULT_t *result)
+{
+  uint32_t expect, got;
+
+  val_iic_imsic_eithreshold_update(threshold);
+
+  do {
+      expect = iic_perf_arb_lowest(model, num_words, threshold);
+      got = val_iic_imsic_claim();
+      if (got != expect) {
+          if (threshold && got >= threshold)
+              result->unmasked++;
+          else
+              result->misordered++;
+          val_print(ACS_PRINT_DEBUG, "\n       stopei 0x%x", got);
+          val_print(ACS_PRINT_DEBUG, ", expected 0x%x", expect);
+          val_print(ACS_PRINT_DEBUG, ", eithreshold 0x%x", threshold);
+          return 1;
+      }
+      if (got)
+          model[got / 64] &= ~BIT(got % 64);
+  } while (got);
+
+  return 0;
+}
+
+/**
+  @brief   Check stopei arbitration and eithreshold masking on the calling
+           hart against a reference model, and time how fast the file can
+           be drained, with its external interrupt masked in sie. For each
+           pending population, IIC_PERF_ARB_ROUNDS times:
+           1. Pick that many distinct identities with a fixed seed and pend
+              them a whole eip word at a time, with every identity enabled.
+           2. Set eithreshold to a random identity and claim through stopei
+              until it reads 0; every claim must be the lowest identity still
+              pending below the threshold, right from the first read after
+              the threshold write.
+           3. Drop eithreshold to 0 and claim the rest in ascending order.
+           4. Pend the same set again and time claiming and completing all of
+              it through stopei and val_gic_end_of_interrupt.
+           1. Caller       -  Test Suite, on the hart being measured
+           2. Prerequisite -  val_iic_perf_init
+  @param   result - per population drain summaries and mismatch counts
+  @return  ACS_STATUS_PASS, ACS_STATUS_SKIP without an interrupt file
+**/
+uint32_t
+val_iic_perf_arbitration(IIC_PERF_ARB_RESULT_t *result)
+{
+  uint32_t index = val_hart_get_index_mpid(val_hart_get_mpid());
+  uint64_t *drain = &g_iic_perf_samples[(uint64_t)index * IIC_PERF_MAX_SAMPLES];
+  uint64_t set[IMSIC_MAX_EIX_WORDS];
+  uint64_t model[IMSIC_MAX_EIX_WORDS];
+  uint64_t seed = IIC_PERF_ARB_SEED;
+  uint64_t start;
+  uint32_t num_words, pending, step, round, i, id, w;
+  IMSIC_FILE_STATE state;
+
+  val_memory_set(result, sizeof(IIC_PERF_ARB_RESULT_t), 0);
+  if (val_hart_get_imsic_base(index) == 0)
+      return ACS_STATUS_SKIP;
+
+  num_words = val_iic_imsic_eix_num_words();
+  result->max_id = val_gic_max_supervisor_intr_num();
+  if (result->max_id > num_words * 64 - 1)
+      result->max_id = num_words * 64 - 1;
+  if (result->max_id == 0)
+      return ACS_STATUS_SKIP;
+
+  val_iic_ext_intr_enable(false);
+  val_iic_imsic_file_save(&state);
+  val_iic_imsic_eidelivery_update(1);
+  for (w = 0; w < num_words; w++) {
+      val_iic_imsic_eix_word_write(w, true, 0);
+      val_iic_imsic_eix_word_write(w, false, (w == 0) ? ~BIT(0) : ~0ULL);
+  }
+
+  for (step = 0; step < IIC_PERF_ARB_STEPS; step++) {
+      pending = iic_perf_arb_pending[step];
+      if (pending > result->max_id)
+          pending = result->max_id;
+
+      for (round = 0; round < IIC_PERF_ARB_ROUNDS; round++) {
+          val_memory_set(set, sizeof(set), 0);
+          for (i = 0; i < pending; i++) {
+              id = 1 + iic_perf_arb_rand(&seed) % result->max_id;
+              while (set[id / 64] & BIT(id % 64))
+                  id = (id == result->max_id) ? 1 : id + 1;
+              set[id / 64] |= BIT(id % 64);
+          }
+
+          for (w = 0; w < num_words; w++) {
+              model[w] = set[w];
+              val_iic_imsic_eix_word_write(w, true, model[w]);
+          }
+
+          if (iic_perf_arb_check(model, num_words,
+                                 1 + iic_perf_arb_rand(&seed) % result->max_id, result) ||
+              iic_perf_arb_check(model, num_words, 0, result)) {
+              for (w = 0; w < num_words; w++)
+                  val_iic_imsic_eix_word_write(w, true, 0);
+          }
+
+          for (w = 0; w < num_words; w++)
+              val_iic_imsic_eix_word_write(w, true, set[w]);
+
+          start = val_timer_get_counter();
+          for (i = 0; i < pending; i++) {
+              id = val_iic_imsic_claim();
+              if (id == 0)
+                  break;
+              val_gic_end_of_interrupt(id);
+          }
+          drain[round] = val_timer_get_counter() - start;
+
+          if (i < pending) {
+              result->lost += pending - i;
+              for (w = 0; w < num_words; w++)
+                  val_iic_imsic_eix_word_write(w, true, 0);
+          }
+      }
+
+      result->step[step].pending = pending;
+      val_iic_perf_stats(drain, IIC_PERF_ARB_ROUNDS, &result->step[step].drain);
+      result->num_steps++;
+
+      if (pending == result->max_id)
+          break;
+  }
+
+  val_iic_imsic_file_restore(&state);
+
+  return ACS_STATUS_PASS;
+}
+
+/**
+  @brief   Print the claim rate per pending population:
+           IICPERF,ARB,<pending>,<rounds>,<min>,<median>,<p99>,<max>,<ns per claim>,<claims per ms>
+           with the drain times in nanoseconds, and the rates taken at the
+           median.
+**/
+void
+val_iic_perf_report_arbitration(IIC_PERF_ARB_RESULT_t *result)
+{
+  uint32_t s;
+  uint64_t ns;
+
+  for (s = 0; s < result->num_steps; s++) {
+      val_print(ACS_PRINT_TEST, "\n       IICPERF,ARB,%d", result->step[s].pending);
+      iic_perf_report_stats(&result->step[s].drain);
+      ns = val_iic_perf_ticks_to_ns(result->step[s].drain.median);
+      val_print(ACS_PRINT_TEST, ",%ld", ns / result->step[s].pending);
+      val_print(ACS_PRINT_TEST, ",%ld", ns ? (result->step[s].pending * 1000000ULL) / ns : 0);
+  }
+
+  if (result->misordered || result->unmasked || result->lost) {
+      val_print(ACS_PRINT_ERR, "\n       %d claims out of priority order", result->misordered);
+      val_print(ACS_PRINT_ERR, ", %d above eithreshold", result->unmasked);
+      val_print(ACS_PRINT_ERR, ", %d pended identities not claimed", result->lost);
+  }
+}
+
+/**
+  @brief   Time IIC_PERF_SAMPLES MSIs of one identity from the write to
+           handler entry, into the S-level file or the selected guest file.
+  @return  Number of samples taken
+**/
+static
+uint32_t
+iic_perf_guest_samples(volatile uint32_t *seteipnum, IIC_PERF_SLOT_t *slot, bool guest,
+                       uint64_t timeout, uint64_t *samples, IIC_PERF_GUEST_RESULT_t *result)
+{
+  uint32_t s, n = 0;
+  uint64_t start;
+
+  for (s = 0; s < IIC_PERF_SAMPLES; s++) {
+      slot->done = 0;
+      start = val_timer_get_counter();
+      *seteipnum = IIC_PERF_GUEST_EIID;
+
+      while (!slot->done && val_timer_get_counter() - start <= timeout)
+          ;
+
+      if (!slot->done) {
+          if (guest)
+              val_iic_guest_eip_clear(IIC_PERF_GUEST_EIID);
+          else
+              val_iic_imsic_eix_update(IIC_PERF_GUEST_EIID, true, 0);
+          result->lost++;
+      } else if (slot->claimed != IIC_PERF_GUEST_EIID) {
+          result->misclaimed++;
+      } else {
+          samples[n++] = slot->entry - start;
+      }
+  }
+
+  return n;
+}
+
+/**
+  @brief   Measure MSI to handler latency through every guest interrupt file
+           of the calling hart, and through its S-level file as a baseline.
+           The guest files are found by WARL discovery on hgeie and taken as
+           the 4 KiB pages following the S-level file. Each file in turn is
+           selected with hstatus.VGEIN, set up through vsiselect, enabled
+           alone in hgeie, and its MSIs are taken as supervisor guest
+           external interrupts and claimed through vstopei. Every file and
+           hgeie is restored afterwards.
+           1. Caller       -  Test Suite, on the hart being measured
+           2. Prerequisite -  val_iic_perf_init
+  @param   result - per file summaries
+  @return  ACS_STATUS_PASS, ACS_STATUS_SKIP without the H extension, an
+           interrupt file or guest files, ACS_STATUS_ERR if the handler
+           could not be installed
+**/
+uint32_t
+val_iic_perf_guest_latency(IIC_PERF_GUEST_RESULT_t *result)
+{
+  uint32_t index = val_hart_get_index_mpid(val_hart_get_mpid());
+  IIC_PERF_SLOT_t *slot = &g_iic_perf_slot[index];
+  uint64_t *samples = &g_iic_perf_samples[(uint64_t)index * IIC_PERF_MAX_SAMPLES];
+  uint64_t imsic_base = val_hart_get_imsic_base(index);
+  uint64_t timeout, hgeie, file_base;
+  uint32_t vgein, prev, n;
+  IMSIC_FILE_STATE state;
+
+  val_memory_set(result, sizeof(IIC_PERF_GUEST_RESULT_t), 0);
+
+  if (imsic_base == 0 || !val_hart_has_ext(index, EXT_H))
+      return ACS_STATUS_SKIP;
+
+  result->files = val_iic_guest_files();
+  if (result->files == 0)
+      return ACS_STATUS_SKIP;
+
+  if (val_hart_install_esr(EXCEPT_RISCV_IRQ_GUEST_EXT, iic_perf_sgei_isr)) {
+      val_print(ACS_PRINT_ERR, "\n       Guest external interrupt handler install failed", 0);
+      return ACS_STATUS_ERR;
+  }
+
+  timeout = val_timer_get_info(TIMER_INFO_CNTFREQ, 0) * IIC_PERF_SAMPLE_TIMEOUT_US / 1000000;
+  if (timeout == 0)
+      timeout = 1;
+
+  /* S-level baseline */
+  val_iic_imsic_file_save(&state);
+  val_iic_imsic_eithreshold_update(0);
+  val_iic_imsic_eidelivery_update(1);
+  val_iic_imsic_eix_update(IIC_PERF_GUEST_EIID, false, 1);
+  val_iic_ext_intr_enable(true);
+  n = iic_perf_guest_samples((volatile uint32_t *)(imsic_base + IMSIC_MMIO_PAGE_LE), slot, false,
+                             timeout, samples, result);
+  val_iic_ext_intr_enable(false);
+  val_iic_imsic_file_restore(&state);
+  val_iic_perf_stats(samples, n, &result->s_level);
+
+  for (vgein = 1; vgein < IIC_PERF_GUEST_MAX_FILES; vgein++) {
+      if (!(result->files & (1ULL << vgein)))
+          continue;
+
+      file_base = imsic_base + (uint64_t)vgein * 0x1000;
+      val_memory_map_add_mmio(file_base, 0x1000);
+
+      prev = val_iic_guest_file_select(vgein);
+      val_iic_guest_file_save(&state);
+      val_iic_guest_file_arm(IIC_PERF_GUEST_EIID);
+      hgeie = val_iic_guest_intr_enable(1ULL << vgein);
+
+      n = iic_perf_guest_samples((volatile uint32_t *)(file_base + IMSIC_MMIO_PAGE_LE), slot, true,
+                                 timeout, samples, result);
+
+      val_iic_guest_intr_enable(hgeie);
+      val_iic_guest_file_restore(&state);
+      val_iic_guest_file_select(prev);
+      val_iic_perf_stats(samples, n, &result->file[vgein]);
+  }
+
+  return ACS_STATUS_PASS;
+}
+
+/**
+  @brief   Print the guest file latency of one hart:
+           IICPERF,GUEST,<hart>,s,<count>,<min>,<median>,<p99>,<max>
+           IICPERF,GUEST,<hart>,<vgein>,<count>,<min>,<median>,<p99>,<max>,<extra>
+           with extra the median over the S-level median, in nanoseconds.
+**/
+void
+val_iic_perf_report_guest(uint32_t index, IIC_PERF_GUEST_RESULT_t *result)
+{
+  uint64_t s_ns = val_iic_perf_ticks_to_ns(result->s_level.median);
+  uint64_t g_ns;
+  uint32_t vgein;
+
+  val_print(ACS_PRINT_TEST, "\n       IICPERF,GUEST,%d,s", index);
+  iic_perf_report_stats(&result->s_level);
+
+  for (vgein = 1; vgein < IIC_PERF_GUEST_MAX_FILES; vgein++) {
+      if (!(result->files & (1ULL << vgein)))
+          continue;
+
+      g_ns = val_iic_perf_ticks_to_ns(result->file[vgein].median);
+      val_print(ACS_PRINT_TEST, "\n       IICPERF,GUEST,%d", index);
+      val_print(ACS_PRINT_TEST, ",%d", vgein);
+      iic_perf_report_stats(&result->file[vgein]);
+      val_print(ACS_PRINT_TEST, ",%ld", (g_ns > s_ns) ? g_ns - s_ns : 0);
+  }
+
+  if (result->lost || result->misclaimed) {
+      val_print(ACS_PRINT_ERR, "\n       Hart %d", index);
+      val_print(ACS_PRINT_ERR, " lost %d MSIs", result->lost);
+      val_print(ACS_PRINT_ERR, ", %d claimed with another identity", result->misclaimed);
+  }
+}
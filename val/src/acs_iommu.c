@@ -80,7 +80,8 @@ val_iommu_create_info_table(uint64_t *iommu_info_table)
 void
 val_iommu_free_info_table(void)
 {
-  pal_mem_free((void *)g_iommu_info_table);
+  val_info_table_free((void *)g_iommu_info_table);
+  g_iommu_info_table = NULL;
 }
 
 /**
@@ -433,7 +433,8 @@ val_iovirt_check_unique_ctx_intid(uint32_t smmu_index)
 void
 val_iovirt_free_info_table()
 {
-  pal_mem_free((void *)g_iovirt_info_table);
+  val_info_table_free((void *)g_iovirt_info_table);
+  g_iovirt_info_table = NULL;
 }
 
 /**
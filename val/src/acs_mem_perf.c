@@ -0,0 +1,412 @@
+/** @file
+ * Copyright (c) 2016-2018, 2020-2021, 2023, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#include "include/bsa_acs_val.h"
+#include "include/bsa_acs_common.h"
+#include "include/bsa_acs_memory.h"
+#include "include/bsa_acs_mem_perf.h"
+
+/**
+  @brief   This API executes all the memory performance tests sequentially
+           1. Caller       -  Application layer.
+           2. Prerequisite -  val_memory_create_info_table(), val_timer_create_info_table()
+  @param   num_hart - the number of HART to run these tests on.
+  @param   g_sw_view - Keeps the information about which view tests to be run
+  @return  Consolidated status of all the tests run.
+**/
+uint32_t
+val_mem_perf_execute_tests(uint32_t num_hart, uint32_t *g_sw_view)
+{
+  uint32_t status, i;
+
+  for (i = 0; i < g_num_skip; i++) {
+      if (g_skip_test_num[i] == ACS_MEM_PERF_TEST_NUM_BASE) {
+          val_print(ACS_PRINT_INFO, "\n       USER Override - Skipping all Memory perf tests\n", 0);
+          return ACS_STATUS_SKIP;
+      }
+  }
+
+  /* Check if there are any tests to be executed in current module with user override options*/
+  status = val_check_skip_module(ACS_MEM_PERF_TEST_NUM_BASE);
+  if (status) {
+      val_print(ACS_PRINT_INFO, "\n       USER Override - Skipping all Memory perf tests\n", 0);
+      return ACS_STATUS_SKIP;
+  }
+
+  val_print_test_start("Memory Performance");
+  status      = ACS_STATUS_PASS;
+  g_curr_module = 1 << MEM_PERF_MODULE;
+
+  if (g_sw_view[G_SW_OS]) {
+      val_print(ACS_PRINT_ERR, "\nOperating System View:\n", 0);
+      status |= os_mp001_entry(num_hart);
+      status |= os_mp002_entry(num_hart);
+  }
+  val_print_test_end(status, "Memory Performance");
+
+  return status;
+}
+
+/**
+  @brief   Allocate the largest test buffer, up to the requested size, that fits
+           inside the range. An empty range means any system memory will do.
+  @param   base  - Start of the physical range
+  @param   size  - Size of the physical range, 0 for no placement constraint
+  @param   want  - Requested buffer size in bytes
+  @param   got   - Size of the buffer actually allocated
+  @return  Buffer address, NULL if not even MEM_PERF_BUF_ALIGN bytes were available
+**/
+static
+void *
+mem_perf_alloc(uint64_t base, uint64_t size, uint64_t want, uint64_t *got)
+{
+  uint32_t page_size = val_memory_page_size();
+  void *buf;
+
+  /* Leave room to round the base up to a 2MiB boundary */
+  if (size) {
+      if (size <= MEM_PERF_BUF_ALIGN)
+          return NULL;
+      if (want > size - MEM_PERF_BUF_ALIGN)
+          want = size - MEM_PERF_BUF_ALIGN;
+  }
+  want &= ~((uint64_t)MEM_PERF_BUF_ALIGN - 1);
+
+  while (want >= MEM_PERF_BUF_ALIGN) {
+      if (size)
+          buf = val_memory_alloc_pages_in_range(base, size, want / page_size);
+      else
+          buf = val_memory_alloc_pages(want / page_size);
+
+      if (buf) {
+          *got = want;
+          return buf;
+      }
+      want >>= 1;
+  }
+
+  return NULL;
+}
+
+/**
+  @brief   Place a test buffer in the Nth normal memory region of the memory
+           info table. Without a memory info table, instance N is the Nth
+           proximity domain of the SRAT, and on a uniform platform instance 0
+           is served from the default page allocator with region_base 0.
+           1. Caller       -  Test Suite
+           2. Prerequisite -  val_memory_create_info_table()
+  @param   instance - normal memory region instance, '0' based
+  @param   region   - filled in with the buffer description
+  @return  ACS_STATUS_PASS, or ACS_STATUS_SKIP if there is no such region
+**/
+uint32_t
+val_mem_perf_region_get(uint32_t instance, MEM_PERF_REGION_t *region)
+{
+  uint64_t attr;
+  uint64_t base, size, chase;
+  uint64_t want = 3 * 4 * (uint64_t)MEM_PERF_LLC_SIZE;
+  uint32_t range;
+  void *buf = NULL;
+
+  base = val_memory_get_addr(MEM_TYPE_NORMAL, instance, &attr);
+  size = val_memory_get_size(MEM_TYPE_NORMAL, instance);
+
+  /* Three STREAM arrays, each 4x the LLC so no array stays cache resident */
+  if (base && size) {
+      buf = mem_perf_alloc(base, size, want, &region->size);
+  } else if (val_numa_get_num_domains()) {
+      if (instance >= val_numa_get_num_domains())
+          return ACS_STATUS_SKIP;
+      for (range = 0; buf == NULL &&
+           val_numa_get_mem_range(instance, range, &base, &size) == 0; range++)
+          buf = mem_perf_alloc(base, size, want, &region->size);
+  } else {
+      if (instance != 0)
+          return ACS_STATUS_SKIP;
+      base = 0;
+      buf = mem_perf_alloc(0, 0, want, &region->size);
+  }
+
+  if (buf == NULL) {
+      val_print(ACS_PRINT_DEBUG, "\n       No room for test buffer in region %d", instance);
+      return ACS_STATUS_SKIP;
+  }
+
+  region->instance     = instance;
+  region->region_base  = base;
+  region->base         = (uint64_t)buf;
+  region->node         = val_numa_get_addr_node(region->base);
+  region->stream_elems = region->size / 3 / sizeof(uint64_t);
+
+  chase = MEM_PERF_CHASE_MIN;
+  while ((chase << 1) <= region->size && (chase << 1) <= 4 * (uint64_t)MEM_PERF_LLC_SIZE)
+      chase <<= 1;
+  region->chase_max = chase;
+
+  if (region->size < 3 * 4 * (uint64_t)MEM_PERF_LLC_SIZE)
+      val_print(ACS_PRINT_WARN, "\n       Region %d buffer smaller than 4x LLC", instance);
+
+  return ACS_STATUS_PASS;
+}
+
+/**
+  @brief   Release a buffer obtained from val_mem_perf_region_get
+  @param   region - buffer description
+  @return  None
+**/
+void
+val_mem_perf_region_put(MEM_PERF_REGION_t *region)
+{
+  if (region->base)
+      val_memory_free_pages((void *)region->base, region->size / val_memory_page_size());
+
+  region->base = 0;
+}
+
+/**
+  @brief   Convert a tick count over a byte count into MB/s
+**/
+static
+uint64_t
+mem_perf_mbps(uint64_t bytes, uint64_t ticks, uint64_t freq)
+{
+  if (ticks == 0)
+      return 0;
+
+  return (bytes * freq / ticks) / 1000000;
+}
+
+/**
+  @brief   Run the STREAM copy, scale, add and triad kernels on the calling
+           hart and record the best bandwidth of MEM_PERF_STREAM_NTIMES runs.
+           64-bit integer arrays are used so that no FP state is required;
+           the memory traffic is identical to the double precision kernels.
+           1. Caller       -  Test Suite, on any hart
+           2. Prerequisite -  val_mem_perf_region_get()
+  @param   region - test buffer
+  @param   result - bandwidth per kernel in MB/s
+  @return  None
+**/
+void
+val_mem_perf_stream(MEM_PERF_REGION_t *region, MEM_PERF_RESULT_t *result)
+{
+  volatile uint64_t *a, *b, *c;
+  uint64_t n = region->stream_elems;
+  uint64_t freq = val_timer_get_info(TIMER_INFO_CNTFREQ, 0);
+  uint64_t best[MEM_PERF_STREAM_KERNELS];
+  uint64_t bytes[MEM_PERF_STREAM_KERNELS];
+  uint64_t start, ticks, i;
+  uint32_t k, run;
+
+  a = (volatile uint64_t *)region->base;
+  b = a + n;
+  c = b + n;
+
+  for (i = 0; i < n; i++) {
+      a[i] = 1;
+      b[i] = 2;
+      c[i] = 0;
+  }
+
+  bytes[MEM_PERF_COPY]  = 2 * sizeof(uint64_t) * n;
+  bytes[MEM_PERF_SCALE] = 2 * sizeof(uint64_t) * n;
+  bytes[MEM_PERF_ADD]   = 3 * sizeof(uint64_t) * n;
+  bytes[MEM_PERF_TRIAD] = 3 * sizeof(uint64_t) * n;
+
+  for (k = 0; k < MEM_PERF_STREAM_KERNELS; k++)
+      best[k] = ~0ULL;
+
+  for (run = 0; run < MEM_PERF_STREAM_NTIMES; run++) {
+      start = val_timer_get_counter();
+      for (i = 0; i < n; i++)
+          c[i] = a[i];
+      ticks = val_timer_get_counter() - start;
+      if (run && ticks < best[MEM_PERF_COPY])
+          best[MEM_PERF_COPY] = ticks;
+
+      start = val_timer_get_counter();
+      for (i = 0; i < n; i++)
+          b[i] = MEM_PERF_STREAM_SCALAR * c[i];
+      ticks = val_timer_get_counter() - start;
+      if (run && ticks < best[MEM_PERF_SCALE])
+          best[MEM_PERF_SCALE] = ticks;
+
+      start = val_timer_get_counter();
+      for (i = 0; i < n; i++)
+          c[i] = a[i] + b[i];
+      ticks = val_timer_get_counter() - start;
+      if (run && ticks < best[MEM_PERF_ADD])
+          best[MEM_PERF_ADD] = ticks;
+
+      start = val_timer_get_counter();
+      for (i = 0; i < n; i++)
+          a[i] = b[i] + MEM_PERF_STREAM_SCALAR * c[i];
+      ticks = val_timer_get_counter() - start;
+      if (run && ticks < best[MEM_PERF_TRIAD])
+          best[MEM_PERF_TRIAD] = ticks;
+  }
+
+  /* The first run only warms up the TLB and page tables, as in STREAM */
+  for (k = 0; k < MEM_PERF_STREAM_KERNELS; k++)
+      result->stream_mbps[k] = mem_perf_mbps(bytes[k], best[k], freq);
+}
+
+/**
+  @brief   Link the first size bytes of the buffer into a single random cycle
+           of cache lines (Sattolo's algorithm), so every load depends on the
+           previous one and hardware prefetchers cannot follow the chain.
+           The fixed seed makes the chain identical on every hart and run.
+**/
+static
+void
+mem_perf_chase_build(uint64_t base, uint64_t size)
+{
+  uint64_t lines = size / MEM_PERF_LINE_SIZE;
+  uint64_t seed = MEM_PERF_CHASE_SEED;
+  uint64_t i, j, tmp;
+  uint64_t *slot;
+
+  for (i = 0; i < lines; i++)
+      *(uint64_t *)(base + i * MEM_PERF_LINE_SIZE) = i;
+
+  for (i = lines - 1; i > 0; i--) {
+      seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+      j = (seed >> 33) % i;
+      slot = (uint64_t *)(base + i * MEM_PERF_LINE_SIZE);
+      tmp = *slot;
+      *slot = *(uint64_t *)(base + j * MEM_PERF_LINE_SIZE);
+      *(uint64_t *)(base + j * MEM_PERF_LINE_SIZE) = tmp;
+  }
+
+  /* Turn line indices into pointers */
+  for (i = 0; i < lines; i++) {
+      slot = (uint64_t *)(base + i * MEM_PERF_LINE_SIZE);
+      *slot = base + *slot * MEM_PERF_LINE_SIZE;
+  }
+}
+
+/**
+  @brief   Measure load to use latency with a pointer chase over working sets
+           doubling from MEM_PERF_CHASE_MIN to region->chase_max.
+           1. Caller       -  Test Suite, on any hart
+           2. Prerequisite -  val_mem_perf_region_get()
+  @param   region - test buffer
+  @param   result - working set sizes and average latency in picoseconds
+  @return  None
+**/
+void
+val_mem_perf_latency(MEM_PERF_REGION_t *region, MEM_PERF_RESULT_t *result)
+{
+  uint64_t freq = val_timer_get_info(TIMER_INFO_CNTFREQ, 0);
+  uint64_t size, start, ticks;
+  void * volatile sink;
+  void **p;
+  uint32_t k, n = 0;
+
+  for (size = MEM_PERF_CHASE_MIN;
+       size <= region->chase_max && n < MEM_PERF_MAX_POINTS;
+       size <<= 1) {
+      mem_perf_chase_build(region->base, size);
+
+      /* One pass over the set to warm caches and TLB */
+      p = (void **)region->base;
+      for (k = 0; k < size / MEM_PERF_LINE_SIZE; k++)
+          p = (void **)*p;
+
+      start = val_timer_get_counter();
+      for (k = 0; k < MEM_PERF_CHASE_LOADS; k++)
+          p = (void **)*p;
+      ticks = val_timer_get_counter() - start;
+      sink = p;
+      (void)sink;
+
+      result->chase_size[n] = size;
+      result->chase_ps[n] = freq ? (ticks * 1000000000 / freq) * 1000 / MEM_PERF_CHASE_LOADS : 0;
+      n++;
+  }
+
+  result->num_points = n;
+}
+
+/**
+  @brief   Print where the hart and the buffer sit in the NUMA topology:
+           MEMPERF,NODE,<hart>,<region base>,<hart node>,<buffer node>,<SLIT distance>
+**/
+static
+void
+mem_perf_report_node(uint32_t index, MEM_PERF_REGION_t *region)
+{
+  uint32_t node = val_numa_get_hart_node(index);
+
+  val_print(ACS_PRINT_TEST, "\n       MEMPERF,NODE,%d", index);
+  val_print(ACS_PRINT_TEST, ",0x%lx", region->region_base);
+  val_print(ACS_PRINT_TEST, ",%d", (int32_t)node);
+  val_print(ACS_PRINT_TEST, ",%d", (int32_t)region->node);
+  val_print(ACS_PRINT_TEST, ",%d", val_numa_get_distance(node, region->node));
+}
+
+static char8_t *stream_fmt[MEM_PERF_STREAM_KERNELS] = {
+  ",copy,%ld",
+  ",scale,%ld",
+  ",add,%ld",
+  ",triad,%ld"
+};
+
+/**
+  @brief   Print STREAM results as one line per kernel:
+           MEMPERF,BW,<hart>,<region base>,<kernel>,<MB/s>
+  @param   index  - hart index the result was measured on
+  @param   region - test buffer
+  @param   result - measured values
+  @return  None
+**/
+void
+val_mem_perf_report_stream(uint32_t index, MEM_PERF_REGION_t *region, MEM_PERF_RESULT_t *result)
+{
+  uint32_t k;
+
+  mem_perf_report_node(index, region);
+
+  for (k = 0; k < MEM_PERF_STREAM_KERNELS; k++) {
+      val_print(ACS_PRINT_TEST, "\n       MEMPERF,BW,%d", index);
+      val_print(ACS_PRINT_TEST, ",0x%lx", region->region_base);
+      val_print(ACS_PRINT_TEST, stream_fmt[k], result->stream_mbps[k]);
+  }
+}
+
+/**
+  @brief   Print pointer chase results as one line per working set:
+           MEMPERF,LAT,<hart>,<region base>,<bytes>,<picoseconds>
+  @param   index  - hart index the result was measured on
+  @param   region - test buffer
+  @param   result - measured values
+  @return  None
+**/
+void
+val_mem_perf_report_latency(uint32_t index, MEM_PERF_REGION_t *region, MEM_PERF_RESULT_t *result)
+{
+  uint32_t k;
+
+  mem_perf_report_node(index, region);
+
+  for (k = 0; k < result->num_points; k++) {
+      val_print(ACS_PRINT_TEST, "\n       MEMPERF,LAT,%d", index);
+      val_print(ACS_PRINT_TEST, ",0x%lx", region->region_base);
+      val_print(ACS_PRINT_TEST, ",%ld", result->chase_size[k]);
+      val_print(ACS_PRINT_TEST, ",%ld", result->chase_ps[k]);
+  }
+}
@@ -21,11 +21,41 @@
 #include "include/bsa_acs_common.h"
 #include "include/bsa_acs_mmu.h"
 #include "include/val_interface.h"
+#include "include/bsa_acs_pcie.h"
+#include "include/bsa_acs_iommu.h"
 
 MEMORY_INFO_TABLE  *g_memory_info_table;
 
 #define SIZE_4KB   0x00001000
 
+/* Allocations from the arenas are aligned to this many bytes */
+#define ARENA_ALIGN  16
+
+typedef struct {
+  uint8_t  *base;
+  uint32_t size;
+  uint32_t used;
+} VAL_ARENA_t;
+
+static void        *g_arena_mem;
+static VAL_ARENA_t g_table_arena;
+static VAL_ARENA_t g_scratch_arena;
+
+/* Maximum number of disjoint ranges tracked by an MMIO map registry */
+#define VAL_MMIO_MAP_MAX  64
+
+/* Sorted, non-overlapping and non-adjacent list of page aligned [base, end) ranges */
+typedef struct {
+  uint32_t num;
+  struct {
+    uint64_t base;
+    uint64_t end;
+  } range[VAL_MMIO_MAP_MAX];
+} VAL_MMIO_MAP_t;
+
+static VAL_MMIO_MAP_t g_mmio_map;
+static uint32_t       g_mmio_map_lock;
+
 #ifdef TARGET_BM_BOOT
 /**
  *   @brief    Add regions assigned to host into its translation table data structure.
@@ -123,7 +153,8 @@ val_memory_execute_tests(uint32_t num_hart, uint32_t *g_sw_view)
 void
 val_memory_free_info_table()
 {
-  pal_mem_free((void *)g_memory_info_table);
+  val_info_table_free((void *)g_memory_info_table);
+  g_memory_info_table = NULL;
 }
 
 /**
@@ -216,6 +247,40 @@ val_memory_get_addr(MEMORY_INFO_e mem_type, uint32_t instance, uint64_t *attr)
   return 0;
 }
 
+/**
+  @brief   Returns the size of a memory info table range of the input type
+           1. Caller       - Test Suite
+           2. Prerequisite - val_memory_create_info_table
+  @param   type     - type of memory being requested
+  @param   instance - instance is '0' based, same numbering as val_memory_get_addr
+
+  @return  size of the range in bytes, 0 if not found
+**/
+uint64_t
+val_memory_get_size(MEMORY_INFO_e mem_type, uint32_t instance)
+{
+  uint32_t i;
+
+  if (g_memory_info_table == NULL)
+      return 0;
+
+  switch(mem_type) {
+      case MEM_TYPE_DEVICE:
+          i = val_memory_get_entry_index(MEMORY_TYPE_DEVICE, instance);
+          break;
+      case MEM_TYPE_NORMAL:
+          i = val_memory_get_entry_index(MEMORY_TYPE_NORMAL, instance);
+          break;
+      default:
+          i = 0xFF;
+          break;
+  }
+  if (i != 0xFF)
+      return g_memory_info_table->info[i].size;
+
+  return 0;
+}
+
 /**
   @brief   Returns the type and attributes of a given memory address
            1. Caller       - Test Suite
@@ -318,6 +383,147 @@ val_memory_alloc(uint32_t size)
   return pal_mem_alloc(size);
 }
 
+/* Lock free so that harts running tests in parallel can share an arena */
+static void *
+val_arena_bump(VAL_ARENA_t *arena, uint32_t size)
+{
+  uint32_t used;
+
+  size = (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+  if (arena->base == NULL)
+      return NULL;
+
+  used = __atomic_load_n(&arena->used, __ATOMIC_RELAXED);
+  do {
+      if (size > arena->size - used)
+          return NULL;
+  } while (!__atomic_compare_exchange_n(&arena->used, &used, used + size, 0,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+  return arena->base + used;
+}
+
+/**
+  @brief  Allocates one contiguous region backing the info table arena and
+          the per-test scratch arena.
+          1. Caller       -  Application layer.
+          2. Prerequisite -  None
+
+  @param  table_size    bytes reserved for long lived info tables
+  @param  scratch_size  bytes reserved for per-test scratch allocations
+
+  @return ACS_STATUS_PASS on success, ACS_STATUS_ERR otherwise
+**/
+uint32_t
+val_arena_create(uint32_t table_size, uint32_t scratch_size)
+{
+  table_size   = (table_size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+  scratch_size = (scratch_size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+
+  /* Extra room to align the base of the table arena */
+  g_arena_mem = pal_mem_alloc(table_size + scratch_size + ARENA_ALIGN);
+  if (g_arena_mem == NULL) {
+      val_print(ACS_PRINT_ERR, "\n       Arena allocation failed", 0);
+      return ACS_STATUS_ERR;
+  }
+
+  g_table_arena.base = (uint8_t *)(((addr_t)g_arena_mem + ARENA_ALIGN - 1) &
+                                   ~(addr_t)(ARENA_ALIGN - 1));
+  g_table_arena.size = table_size;
+  g_table_arena.used = 0;
+
+  g_scratch_arena.base = g_table_arena.base + table_size;
+  g_scratch_arena.size = scratch_size;
+  g_scratch_arena.used = 0;
+
+  return ACS_STATUS_PASS;
+}
+
+/**
+  @brief  Bump allocates from the info table arena. Memory returned here
+          must not be passed to val_memory_free, it is released as a whole
+          by val_arena_free.
+
+  @param  size  allocation size in bytes
+
+  @return pointer to allocated memory, NULL if the arena is exhausted
+**/
+void *
+val_arena_alloc(uint32_t size)
+{
+  return val_arena_bump(&g_table_arena, size);
+}
+
+/**
+  @brief  Bump allocates from the per-test scratch arena. The memory is
+          valid until the test result is checked by val_check_for_error.
+
+  @param  size  allocation size in bytes
+
+  @return pointer to allocated memory, NULL if the arena is exhausted
+**/
+void *
+val_scratch_alloc(uint32_t size)
+{
+  return val_arena_bump(&g_scratch_arena, size);
+}
+
+/**
+  @brief  Frees an info table. Tables carved out of the info table arena
+          are left to val_arena_free, any other is returned to the pool.
+          1. Caller       -  val_*_free_info_table
+          2. Prerequisite -  None
+
+  @param  table  info table, may be NULL
+
+  @return None
+**/
+void
+val_info_table_free(void *table)
+{
+  uint8_t *ptr = (uint8_t *)table;
+
+  if (ptr == NULL)
+      return;
+
+  if ((g_table_arena.base != NULL) && (ptr >= g_table_arena.base) &&
+      (ptr < g_table_arena.base + g_table_arena.size))
+      return;
+
+  pal_mem_free(table);
+}
+
+/**
+  @brief  Releases every scratch allocation at once.
+
+  @param  None
+
+  @return None
+**/
+void
+val_scratch_reset(void)
+{
+  __atomic_store_n(&g_scratch_arena.used, 0, __ATOMIC_RELAXED);
+}
+
+/**
+  @brief  Frees the info tables and the scratch arena with a single call.
+
+  @param  None
+
+  @return None
+**/
+void
+val_arena_free(void)
+{
+  if (g_arena_mem)
+      pal_mem_free(g_arena_mem);
+
+  g_arena_mem = NULL;
+  g_table_arena.base = NULL;
+  g_scratch_arena.base = NULL;
+}
+
 /**
   @brief  Allocates requested zero buffer in bytes in a contiguous memory
           and returns the base address of the range.
@@ -334,15 +540,50 @@ val_memory_calloc(uint32_t num, uint32_t size)
 
 /**
   @brief  Allocates requested buffer size in bytes in a cacheable memory
-          and returns the base address of the range.
+          and returns the base address of the range. The buffer is placed
+          in the proximity domain of the device when the SRAT describes it.
 
-  @param  Size         allocation size in bytes
+  @param  bdf          device that will access the buffer
+  @param  size         allocation size in bytes
+  @param  pa           physical address of the buffer
 
   @return pointer to allocated memory
 **/
 void *
 val_memory_alloc_cacheable(uint32_t bdf, uint32_t size, void **pa)
 {
+  return val_memory_alloc_cacheable_node(bdf, size, pa, val_numa_get_bdf_node(bdf));
+}
+
+/**
+  @brief  Allocates requested buffer size in bytes in a cacheable memory of
+          the given proximity domain. Use a remote node to measure the cost
+          of cross node accesses; NUMA_NODE_ANY leaves placement to the PAL.
+          Boot services data is write-back, so a placed buffer needs no
+          attribute change and is released by val_memory_free_cacheable.
+
+  @param  bdf          device that will access the buffer
+  @param  size         allocation size in bytes
+  @param  pa           physical address of the buffer
+  @param  node         proximity domain hint
+
+  @return pointer to allocated memory
+**/
+void *
+val_memory_alloc_cacheable_node(uint32_t bdf, uint32_t size, void **pa, uint32_t node)
+{
+  uint32_t page_size = val_memory_page_size();
+  void *va;
+
+  if (node != NUMA_NODE_ANY) {
+      va = val_memory_alloc_pages_node((size + page_size - 1) / page_size, node);
+      if (va) {
+          *pa = val_memory_virt_to_phys(va);
+          return va;
+      }
+      val_print(ACS_PRINT_DEBUG, "\n       No room in node %d, using any memory", node);
+  }
+
   return pal_mem_alloc_cacheable(bdf, size, pa);
 }
 
@@ -472,6 +713,49 @@ val_memory_alloc_pages(uint32_t num_pages)
     return pal_mem_alloc_pages(num_pages);
 }
 
+/**
+  @brief  Allocates number of pages inside the physical range [base, base + size).
+
+  @param  base       Start of the physical range
+  @param  size       Size of the physical range in bytes
+  @param  num_pages  Number of memory pages needed
+
+  @return Address of the allocated space, NULL if the range has no room.
+**/
+void *
+val_memory_alloc_pages_in_range(uint64_t base, uint64_t size, uint32_t num_pages)
+{
+    return pal_mem_alloc_pages_in_range(base, size, num_pages);
+}
+
+/**
+  @brief  Allocates number of pages from the memory ranges of one proximity
+          domain. Without NUMA information any memory is used.
+
+  @param  num_pages  Number of memory pages needed
+  @param  node       Proximity domain, NUMA_NODE_ANY for no preference
+
+  @return Address of the allocated space, NULL if the node has no room.
+**/
+void *
+val_memory_alloc_pages_node(uint32_t num_pages, uint32_t node)
+{
+    uint64_t base, size;
+    uint32_t instance;
+    void *buf;
+
+    if (node == NUMA_NODE_ANY || val_numa_get_num_domains() == 0)
+        return val_memory_alloc_pages(num_pages);
+
+    for (instance = 0; val_numa_get_mem_range(node, instance, &base, &size) == 0; instance++) {
+        buf = val_memory_alloc_pages_in_range(base, size, num_pages);
+        if (buf)
+            return buf;
+    }
+
+    return NULL;
+}
+
 /**
   @brief  Free number of pages in the memory.
 
@@ -515,8 +799,185 @@ val_memory_free_aligned(void *addr)
   pal_mem_free_aligned(addr);
 }
 
+static void
+val_mmio_map_acquire(void)
+{
+  while (__atomic_exchange_n(&g_mmio_map_lock, 1, __ATOMIC_ACQUIRE))
+    ;
+}
+
+static void
+val_mmio_map_release(void)
+{
+  __atomic_store_n(&g_mmio_map_lock, 0, __ATOMIC_RELEASE);
+}
+
+/**
+  @brief  Check whether [base, end) is fully contained in one registry range.
+
+  @param  map   MMIO map registry
+  @param  base  Page aligned start address
+  @param  end   Page aligned end address (exclusive)
+
+  @return 1 if covered, 0 otherwise
+**/
+static uint32_t
+val_mmio_map_covered(VAL_MMIO_MAP_t *map, uint64_t base, uint64_t end)
+{
+  uint32_t i;
+
+  for (i = 0; i < map->num && map->range[i].base <= base; i++) {
+      if (end <= map->range[i].end)
+          return 1;
+  }
+
+  return 0;
+}
+
+/**
+  @brief  Insert [base, end) into the registry, merging it with every range
+          it overlaps or touches so that the list stays sorted and disjoint.
+
+  @param  map   MMIO map registry
+  @param  base  Page aligned start address
+  @param  end   Page aligned end address (exclusive)
+
+  @return 0 if Success, 1 if the registry is full
+**/
+static uint32_t
+val_mmio_map_insert(VAL_MMIO_MAP_t *map, uint64_t base, uint64_t end)
+{
+  uint32_t first, last, i;
+
+  /* first range ending at or after base, then every range starting at or before end */
+  for (first = 0; first < map->num && map->range[first].end < base; first++)
+      ;
+  for (last = first; last < map->num && map->range[last].base <= end; last++) {
+      if (map->range[last].base < base)
+          base = map->range[last].base;
+      if (map->range[last].end > end)
+          end = map->range[last].end;
+  }
+
+  if (last == first) {
+      /* nothing to merge with, open a slot at first */
+      if (map->num == VAL_MMIO_MAP_MAX)
+          return 1;
+      for (i = map->num; i > first; i--)
+          map->range[i] = map->range[i - 1];
+      map->num++;
+  } else if (last - first > 1) {
+      /* collapse the merged ranges into the slot at first */
+      for (i = 0; last + i < map->num; i++)
+          map->range[first + 1 + i] = map->range[last + i];
+      map->num -= last - first - 1;
+  }
+
+  map->range[first].base = base;
+  map->range[first].end  = end;
+  return 0;
+}
+
+/**
+  @brief  Map a device memory region as uncached. Requests are widened to page
+          boundaries and recorded in a registry of merged ranges, so a region
+          already mapped by an earlier call is not handed to the PAL again.
+
+  @param  Address  Start address of the region
+  @param  Length   Length of the region in bytes
+
+  @return None
+**/
 void
 val_memory_map_add_mmio (uint64_t  Address, uint64_t  Length)
 {
-  pal_mem_map_add_mmio(Address, Length);
+  uint64_t base, end;
+  uint32_t covered, full;
+
+  if (Length == 0)
+      return;
+
+  base = Address & ~((uint64_t)SIZE_4KB - 1);
+  end  = (Address + Length + SIZE_4KB - 1) & ~((uint64_t)SIZE_4KB - 1);
+
+  val_mmio_map_acquire();
+  covered = val_mmio_map_covered(&g_mmio_map, base, end);
+  val_mmio_map_release();
+
+  if (covered)
+      return;
+
+  /* Only a range the PAL actually mapped is recorded, a failed one is retried */
+  if (pal_mem_map_add_mmio(base, end - base))
+      return;
+
+  val_mmio_map_acquire();
+  full = val_mmio_map_insert(&g_mmio_map, base, end);
+  val_mmio_map_release();
+
+  /* Still mapped, but the next request for it goes to the PAL again */
+  if (full) {
+      val_print(ACS_PRINT_WARN, "\n       MMIO map registry full, 0x%llx", base);
+      val_print(ACS_PRINT_WARN, " - 0x%llx not tracked", end - 1);
+  }
+}
+
+static void
+val_mmio_map_collect(VAL_MMIO_MAP_t *pending, uint64_t base, uint64_t length)
+{
+  uint64_t end;
+
+  if ((base == 0) || (length == 0))
+      return;
+
+  end  = (base + length + SIZE_4KB - 1) & ~((uint64_t)SIZE_4KB - 1);
+  base = base & ~((uint64_t)SIZE_4KB - 1);
+
+  /* Registry full, map this window on its own */
+  if (val_mmio_map_insert(pending, base, end))
+      val_memory_map_add_mmio(base, end - base);
+}
+
+/**
+  @brief  Pre-map every IMSIC interrupt file, APLIC domain and IOMMU register
+          page found in the info tables. The windows are merged first, so
+          contiguous per-hart IMSIC files are mapped by a single PAL call.
+          PCIe ECAM is not mapped here, the config accessors map it one bus
+          at a time on first use. Call once all info tables are created.
+
+  @param  None
+
+  @return None
+**/
+void
+val_memory_map_mmio_windows(void)
+{
+  VAL_MMIO_MAP_t pending;
+  uint32_t i, num;
+
+  pending.num = 0;
+
+  num = val_hart_get_num();
+  for (i = 0; i < num; i++)
+      val_mmio_map_collect(&pending, val_hart_get_imsic_base(i), SIZE_4KB);
+
+  num = val_iic_aplic_get_num();
+  for (i = 0; i < num; i++)
+      val_mmio_map_collect(&pending, val_iic_aplic_get_info(i, APLIC_INFO_BASE),
+                           val_iic_aplic_get_info(i, APLIC_INFO_LENGTH));
+
+  num = val_iommu_get_num();
+  for (i = 0; i < num; i++) {
+      if (val_iommu_get_info(i, IOMMU_INFO_TYPE) == EFI_ACPI_6_5_RIMT_DEVICE_TYPE_IOMMU)
+          val_mmio_map_collect(&pending, val_iommu_get_info(i, IOMMU_INFO_BASE_ADDRESS),
+                               SIZE_4KB);
+  }
+
+
+  for (i = 0; i < pending.num; i++) {
+      val_print(ACS_PRINT_INFO, "\n       Pre-mapping MMIO 0x%llx", pending.range[i].base);
+      val_print(ACS_PRINT_INFO, " - 0x%llx", pending.range[i].end - 1);
+      val_memory_map_add_mmio(pending.range[i].base,
+                              pending.range[i].end - pending.range[i].base);
+  }
 }
\ No newline at end of file
@@ -76,53 +76,61 @@ uint32_t val_setup_mmu(void)
     return ACS_STATUS_PASS;
 }
 
+static inline uint64_t val_satp_read(void)
+{
+    uint64_t satp;
+
+    __asm__ volatile ("csrr %0, satp" : "=r" (satp));
+    return satp;
+}
+
+static inline void val_satp_write(uint64_t satp)
+{
+    /* Order the page table stores before the switch and drop stale entries */
+    __asm__ volatile ("sfence.vma\n\t"
+                      "csrw satp, %0\n\t"
+                      "sfence.vma" : : "r" (satp) : "memory");
+}
+
 /**
- * @brief Enable mmu through configuring mmu registers
+ * @brief Enable mmu by pointing satp at the tables built by val_setup_mmu.
+ *        Only S-mode and U-mode accesses are translated, the image must run
+ *        in S-mode. Cacheability comes from the PMAs and the Svpbmt bits of
+ *        each leaf, there is no separate cache enable.
  * @param void
  * @return status
 **/
 uint32_t val_enable_mmu(void)
 {
-    uint64_t tcr;
-    uint32_t currentEL;
-    currentEL = (val_read_current_el() & 0xc) >> 2;
-
-    /*
-     * Setup Memory Attribute Indirection Register
-     * Attr0 = b01000100 = Normal, Inner/Outer Non-Cacheable
-     * Attr1 = b11111111 = Normal, Inner/Outer WB/WA/RA
-     * Attr2 = b00000000 = Device-nGnRnE
-     */
-    val_mair_write(0x00FF44, currentEL);
-
-    /* Setup ttbr0 */
-    val_ttbr0_write((uint64_t)tt_l0_base, currentEL);
-
-    if (currentEL == 0x02)
+    pgt_descriptor_t pgt_desc;
+    uint64_t satp;
+    uint32_t mode;
+
+    pgt_desc.ias = MMU_PGT_IAS;
+    pgt_desc.stage = PGT_STAGE1;
+
+    /* Same mode val_pgt_create picked for the tables in val_setup_mmu */
+    mode = val_pgt_get_mode(pgt_desc);
+    if (mode == PGT_MODE_BARE)
     {
-        tcr = ((1ull << 20)    |           /* TBI, top byte ignored. */
-               (5ull << 16)    |           /* Physical Address Size - 48 Bits*/
-               (TCR_TG0 << 14) |           /* TG0, granule size */
-               (3ull << 12)    |           /* SH0, inner shareable. */
-               (1ull << 10)    |           /* ORGN0, normal mem, WB RA WA Cacheable */
-               (1ull << 8)     |           /* IRGN0, normal mem, WB RA WA Cacheable */
-               (64 - MMU_PGT_IAS));        /* T0SZ, input address is 2^40 bytes. */
+        val_print(ACS_PRINT_ERR, "\n       val_enable_mmu: no Sv mode for ias %d", MMU_PGT_IAS);
+        return ACS_STATUS_ERR;
     }
 
-    val_tcr_write(tcr, currentEL);
+    satp = ((uint64_t)mode << SATP_MODE_SHIFT) |
+           (((uint64_t)tt_l0_base >> PGT_PAGE_SHIFT) & SATP_PPN_MASK);
 
-    val_print(ACS_PRINT_DEBUG, "       val_setup_mmu: TG0=0x%x\n", TCR_TG0);
-    val_print(ACS_PRINT_DEBUG, "       val_setup_mmu: tcr=0x%lx\n", tcr);
+    val_satp_write(satp);
 
-/* Enable MMU */
-    val_sctlr_write((1 << 0) |  // M=1 Enable the stage 1 MMU
-                    (1 << 2) |  // C=1 Enable data and unified caches
-                    (1 << 12) | // I=1 Enable instruction caches
-                    val_sctlr_read(currentEL),
-                    currentEL);
+    /* A MODE the hart does not implement leaves satp unchanged */
+    if (val_satp_read() != satp)
+    {
+        val_print(ACS_PRINT_ERR, "\n       val_enable_mmu: Sv mode %d not supported", mode);
+        return ACS_STATUS_ERR;
+    }
 
+    val_print(ACS_PRINT_DEBUG, "       val_enable_mmu: satp=0x%lx\n", satp);
     val_print(ACS_PRINT_DEBUG, "       val_enable_mmu: successful\n", 0);
-    val_print(ACS_PRINT_DEBUG, "       System Control EL2 is %llx", val_sctlr_read(currentEL));
 
     return ACS_STATUS_PASS;
 }
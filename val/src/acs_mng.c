@@ -50,6 +50,20 @@ val_mng_create_info_table(uint64_t *mng_info_table)
 
 }
 
+/**
+  @brief  Free the memory allocated for the MNG Info table
+
+  @param  None
+
+  @return None
+**/
+void
+val_mng_free_info_table(void)
+{
+  val_info_table_free((void *)g_mng_info_table);
+  g_mng_info_table = NULL;
+}
+
 /**
   @brief   This API will execute all MNG tests designated for a given compliance level
            1. Caller       -  Application layer.
@@ -0,0 +1,214 @@
+/** @file
+ * Copyright (c) 2016-2018, 2020-2021, 2023, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#include "include/bsa_acs_val.h"
+#include "include/bsa_acs_common.h"
+#include "include/bsa_acs_pcie.h"
+
+/**
+  @brief   Pointer to the memory location of the NUMA Information table
+**/
+NUMA_INFO_TABLE *g_numa_info_table;
+
+/**
+  @brief   This API will call PAL layer to fill in the SRAT and SLIT information
+           into the g_numa_info_table pointer.
+           1. Caller       -  Application layer.
+           2. Prerequisite -  Memory allocated and passed as argument.
+  @param   numa_info_table  pre-allocated memory pointer for numa_info
+  @return  None
+**/
+void
+val_numa_create_info_table(uint64_t *numa_info_table)
+{
+  if (numa_info_table == NULL) {
+      val_print(ACS_PRINT_ERR, "Input for Create Info table cannot be NULL\n", 0);
+      return;
+  }
+  val_print(ACS_PRINT_INFO, "\n Creating NUMA INFO table\n", 0);
+
+  g_numa_info_table = (NUMA_INFO_TABLE *)numa_info_table;
+
+  pal_numa_create_info_table(g_numa_info_table);
+
+  val_print(ACS_PRINT_TEST, " NUMA_INFO: Number of domains        : %4d\n",
+            g_numa_info_table->num_domains);
+}
+
+/**
+  @brief  Free the memory allocated for the NUMA Info table
+
+  @param  None
+
+  @return None
+**/
+void
+val_numa_free_info_table(void)
+{
+  val_info_table_free((void *)g_numa_info_table);
+  g_numa_info_table = NULL;
+}
+
+/**
+  @brief   This API returns the number of proximity domains.
+           1. Caller       -  Test Suite, VAL
+           2. Prerequisite -  val_numa_create_info_table
+  @return  Number of domains, 0 when the platform does not describe any.
+**/
+uint32_t
+val_numa_get_num_domains(void)
+{
+  if (g_numa_info_table == NULL)
+      return 0;
+
+  return g_numa_info_table->num_domains;
+}
+
+/**
+  @brief   This API returns the proximity domain of a hart.
+           1. Caller       -  Test Suite, VAL
+           2. Prerequisite -  val_numa_create_info_table, val_hart_create_info_table
+  @param   index - hart index
+  @return  Proximity domain, NUMA_NODE_ANY if not described.
+**/
+uint32_t
+val_numa_get_hart_node(uint32_t index)
+{
+  uint32_t uid, i;
+
+  if (g_numa_info_table == NULL || g_numa_info_table->num_hart == 0)
+      return NUMA_NODE_ANY;
+
+  uid = val_hart_get_acpi_uid(index);
+  for (i = 0; i < g_numa_info_table->num_hart; i++) {
+      if (g_numa_info_table->hart[i].acpi_processor_uid == uid)
+          return g_numa_info_table->hart[i].prox_domain;
+  }
+
+  return NUMA_NODE_ANY;
+}
+
+/**
+  @brief   This API returns the proximity domain of a PCIe function from the
+           SRAT generic initiators. A function that is not listed inherits the
+           domain of an initiator on the same segment and bus, which covers
+           root ports and devices directly below a listed root complex.
+           1. Caller       -  Test Suite, VAL
+           2. Prerequisite -  val_numa_create_info_table
+  @param   bdf - segment, bus, device and function, PCIE_CREATE_BDF format
+  @return  Proximity domain, NUMA_NODE_ANY if not described.
+**/
+uint32_t
+val_numa_get_bdf_node(uint32_t bdf)
+{
+  uint32_t i, node = NUMA_NODE_ANY;
+
+  if (g_numa_info_table == NULL)
+      return NUMA_NODE_ANY;
+
+  for (i = 0; i < g_numa_info_table->num_initiator; i++) {
+      if (g_numa_info_table->initiator[i].bdf == bdf)
+          return g_numa_info_table->initiator[i].prox_domain;
+
+      if (node == NUMA_NODE_ANY &&
+          (g_numa_info_table->initiator[i].bdf >> 16) == (bdf >> 16))
+          node = g_numa_info_table->initiator[i].prox_domain;
+  }
+
+  return node;
+}
+
+/**
+  @brief   This API returns the proximity domain of a physical address.
+           1. Caller       -  Test Suite, VAL
+           2. Prerequisite -  val_numa_create_info_table
+  @param   addr - physical address
+  @return  Proximity domain, NUMA_NODE_ANY if not described.
+**/
+uint32_t
+val_numa_get_addr_node(uint64_t addr)
+{
+  NUMA_MEM_ENTRY *mem;
+  uint32_t i;
+
+  if (g_numa_info_table == NULL)
+      return NUMA_NODE_ANY;
+
+  for (i = 0; i < g_numa_info_table->num_mem; i++) {
+      mem = &g_numa_info_table->mem[i];
+      if (addr >= mem->base && addr - mem->base < mem->length)
+          return mem->prox_domain;
+  }
+
+  return NUMA_NODE_ANY;
+}
+
+/**
+  @brief   This API returns the Nth memory range of a proximity domain.
+           1. Caller       -  Test Suite, VAL
+           2. Prerequisite -  val_numa_create_info_table
+  @param   node     - proximity domain
+  @param   instance - '0' based range number within the domain
+  @param   base     - range base address
+  @param   size     - range size in bytes
+  @return  ACS_STATUS_PASS, or ACS_STATUS_ERR if there is no such range
+**/
+uint32_t
+val_numa_get_mem_range(uint32_t node, uint32_t instance, uint64_t *base, uint64_t *size)
+{
+  uint32_t i;
+
+  if (g_numa_info_table == NULL)
+      return ACS_STATUS_ERR;
+
+  for (i = 0; i < g_numa_info_table->num_mem; i++) {
+      if (g_numa_info_table->mem[i].prox_domain != node)
+          continue;
+
+      if (instance--)
+          continue;
+
+      *base = g_numa_info_table->mem[i].base;
+      *size = g_numa_info_table->mem[i].length;
+      return ACS_STATUS_PASS;
+  }
+
+  return ACS_STATUS_ERR;
+}
+
+/**
+  @brief   This API returns the SLIT distance between two proximity domains.
+           Without a SLIT the ACPI defaults are used, 10 for local and 20
+           for remote.
+           1. Caller       -  Test Suite
+           2. Prerequisite -  val_numa_create_info_table
+  @param   from - initiator domain
+  @param   to   - target domain
+  @return  Relative distance, NUMA_DISTANCE_LOCAL for the same domain.
+**/
+uint32_t
+val_numa_get_distance(uint32_t from, uint32_t to)
+{
+  if (from == to)
+      return NUMA_DISTANCE_LOCAL;
+
+  if (g_numa_info_table && from < NUMA_MAX_DOMAINS && to < NUMA_MAX_DOMAINS &&
+      g_numa_info_table->distance[from][to])
+      return g_numa_info_table->distance[from][to];
+
+  return 2 * NUMA_DISTANCE_LOCAL;
+}
@@ -20,6 +20,7 @@
 #include "include/bsa_acs_pcie_enumeration.h"
 
 #include "include/bsa_acs_pcie.h"
+#include "include/bsa_acs_memory.h"
 #include "sys_arch_src/pcie/pcie.h"
 
 #define WARN_STR_LEN 7
@@ -29,6 +30,37 @@ uint32_t pcie_bdf_table_list_flag;
 
 uint64_t
 pal_get_mcfg_ptr(void);
+
+/* Buses of the first ECAM windows whose config space is already mapped */
+#define PCIE_ECAM_MAP_MAX  16
+static uint64_t g_pcie_ecam_bus_mapped[PCIE_ECAM_MAP_MAX][(PCIE_MAX_BUS + 63) / 64];
+
+/**
+  @brief   Map the config space of one bus the first time it is accessed, so
+           that an ECAM window is never mapped as a whole. Windows beyond
+           PCIE_ECAM_MAP_MAX are left to the MMIO map registry lookup.
+  @param   index     - ECAM window index in the PCIe info table
+  @param   ecam_base - ECAM base address of the window
+  @param   bus       - Bus number
+
+  @return  None
+**/
+static void
+val_pcie_map_ecam_bus(uint32_t index, addr_t ecam_base, uint32_t bus)
+{
+  uint64_t bit = 1ull << (bus % 64);
+
+  if ((index < PCIE_ECAM_MAP_MAX) &&
+      (__atomic_load_n(&g_pcie_ecam_bus_mapped[index][bus / 64], __ATOMIC_RELAXED) & bit))
+      return;
+
+  /* 32 devices with 8 functions of 4KB each per bus */
+  val_memory_map_add_mmio(ecam_base + ((uint64_t)bus << 20),
+                          PCIE_MAX_DEV * PCIE_MAX_FUNC * 4096);
+
+  if (index < PCIE_ECAM_MAP_MAX)
+      __atomic_fetch_or(&g_pcie_ecam_bus_mapped[index][bus / 64], bit, __ATOMIC_RELAXED);
+}
 /**
   @brief   This API reads 32-bit data from PCIe config space pointed by Bus,
            Device, Function and register offset.
@@ -79,6 +111,8 @@ val_pcie_read_cfg_width(uint32_t bdf, uint32_t offset, void *data, PCI_WIDTH_TYP
       return PCIE_NO_MAPPING;
   }
 
+  val_pcie_map_ecam_bus(i, ecam_base, bus);
+
   /* There are 8 functions / device, 32 devices / Bus and each has a 4KB config space */
   cfg_addr = (bus * PCIE_MAX_DEV * PCIE_MAX_FUNC * 4096) + \
                (dev * PCIE_MAX_FUNC * 4096) + (func * 4096);
@@ -186,6 +220,8 @@ val_pcie_write_cfg(uint32_t bdf, uint32_t offset, uint32_t data)
       return;
   }
 
+  val_pcie_map_ecam_bus(i, ecam_base, bus);
+
   /* There are 8 functions / device, 32 devices / Bus and each has a 4KB config space */
   cfg_addr = (bus * PCIE_MAX_DEV * PCIE_MAX_FUNC * 4096) + \
                (dev * PCIE_MAX_FUNC * 4096) + (func * 4096);
@@ -287,6 +323,8 @@ uint64_t val_pcie_get_bdf_config_addr(uint32_t bdf)
       return 0;
   }
 
+  val_pcie_map_ecam_bus(i, ecam_base, bus);
+
   /* There are 8 functions / device, 32 devices / Bus and each has a 4KB config space */
   cfg_addr = (bus * PCIE_MAX_DEV * PCIE_MAX_FUNC * 4096) + \
                (dev * PCIE_MAX_FUNC * 4096) + (func * 4096);
@@ -791,7 +829,8 @@ val_pcie_bdf_table_ptr()
 void
 val_pcie_free_info_table()
 {
-  pal_mem_free((void *)g_pcie_info_table);
+  val_info_table_free((void *)g_pcie_info_table);
+  g_pcie_info_table = NULL;
 }
 
 
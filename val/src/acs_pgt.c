@@ -21,371 +21,487 @@
 #include "include/bsa_acs_pgt.h"
 #include "include/bsa_acs_memory.h"
 
-#define get_min(a, b) ((a) < (b))?(a):(b)
-
 #define PGT_DEBUG_LEVEL ACS_PRINT_INFO
 
-static uint32_t page_size;
-static uint32_t bits_per_level;
-static uint64_t pgt_addr_mask;
-uint64_t is_values_init = 0;
-uint64_t offset = 0;
+/* Table pages reserved up front, further pages come from the PAL */
+#define PGT_SLAB_PAGES  64
 
-typedef struct
-{
-    uint64_t *tt_base;
-    uint64_t input_base;
-    uint64_t input_top;
-    uint64_t output_base;
-    uint32_t level;
-    uint32_t size_log2;
-    uint32_t nbits;
-} tt_descriptor_t;
+#define PGT_TABLE_SIZE  (0x1ul << PGT_PAGE_SHIFT)
 
+/* Translation parameters of one Sv39/Sv48/Sv57 (or x4) table, owned by the caller */
 typedef struct {
-    uint32_t l0_index;
-    uint32_t l1_index;
-    uint32_t l2_index;
-    uint32_t l3_index;
-    uint64_t size_used;
-} acs_pgt_t;
+    uint32_t mode;
+    uint32_t num_levels;
+    uint32_t top_level;
+    uint32_t root_index_bits;
+    uint32_t root_pages;
+    uint32_t ias;
+    uint32_t stage;
+} pgt_ctx_t;
+
+/* Pre-zeroed pool of table pages shared by all harts. Pages given back
+   are zeroed again and chained through their first word. */
+typedef struct {
+    uint8_t  *base;
+    uint32_t num_pages;
+    uint32_t next;
+    uint32_t init_done;
+    uint64_t *free_list;
+} pgt_slab_t;
 
-static acs_pgt_t acs_pgt_info;
+static pgt_slab_t pgt_slab;
+static uint32_t   pgt_slab_lock;
 
-void setup_acs_pgt_values(void)
+static void pgt_slab_acquire(void)
 {
-    acs_pgt_info.l0_index = 0;
-    acs_pgt_info.l1_index = 0;
-    acs_pgt_info.l2_index = 0;
-    acs_pgt_info.l3_index = 0;
-    acs_pgt_info.size_used = 0;
+    while (__atomic_exchange_n(&pgt_slab_lock, 1, __ATOMIC_ACQUIRE))
+        ;
 }
 
+static void pgt_slab_release(void)
+{
+    __atomic_store_n(&pgt_slab_lock, 0, __ATOMIC_RELEASE);
+}
 
-static
-uint32_t get_pgt_index(uint32_t level)
+static void pgt_zero_table(uint64_t *table, uint64_t size)
 {
-    switch (level)
-    {
-        case(PGT_LEVEL_0):
-            return acs_pgt_info.l0_index;
-        case(PGT_LEVEL_1):
-            return acs_pgt_info.l1_index;
-        case(PGT_LEVEL_2):
-            return acs_pgt_info.l2_index;
-        case(PGT_LEVEL_3):
-            return acs_pgt_info.l3_index;
-        default:
-            return 0;
-    }
+    uint64_t i;
+
+    for (i = 0; i < size / PGT_DESC_SIZE; i++)
+        table[i] = 0;
 }
 
-static
-void increment_pgt_index(uint32_t level, uint32_t max_index)
+/**
+  @brief  Allocate a zeroed translation table page, from the slab if possible.
+
+  @param  None
+
+  @return Virtual address of the table page, NULL on failure
+**/
+static uint64_t *pgt_alloc_table(void)
 {
-    switch (level)
-    {
-        case(PGT_LEVEL_1):
-            if (acs_pgt_info.l1_index == (max_index - 1)) {
-                acs_pgt_info.l1_index = 0;
-                acs_pgt_info.l0_index++;
-            }
-            break;
+    uint64_t *page = NULL;
 
-        case(PGT_LEVEL_2):
-            if (acs_pgt_info.l2_index == (max_index - 1)) {
-                acs_pgt_info.l2_index = 0;
-                acs_pgt_info.l1_index++;
-            }
-            break;
-
-        case(PGT_LEVEL_3):
-            if (acs_pgt_info.l3_index == (max_index - 1)) {
-                acs_pgt_info.l3_index = 0;
-                acs_pgt_info.l2_index++;
-            } else
-                acs_pgt_info.l3_index++;
-            break;
-        default:
-            break;
+    pgt_slab_acquire();
+
+    if (!pgt_slab.init_done) {
+        pgt_slab.init_done = 1;
+        pgt_slab.base = val_aligned_alloc(PGT_TABLE_SIZE, PGT_SLAB_PAGES * PGT_TABLE_SIZE);
+        if (pgt_slab.base != NULL) {
+            pgt_slab.num_pages = PGT_SLAB_PAGES;
+            pgt_zero_table((uint64_t *)pgt_slab.base, PGT_SLAB_PAGES * PGT_TABLE_SIZE);
+        }
+    }
+
+    if (pgt_slab.free_list != NULL) {
+        page = pgt_slab.free_list;
+        pgt_slab.free_list = (uint64_t *)page[0];
+        page[0] = 0;
+    } else if (pgt_slab.next < pgt_slab.num_pages) {
+        page = (uint64_t *)(pgt_slab.base + (uint64_t)pgt_slab.next * PGT_TABLE_SIZE);
+        pgt_slab.next++;
     }
+
+    pgt_slab_release();
+
+    if (page != NULL)
+        return page;
+
+    /* Slab exhausted, fall back to a single page from the PAL */
+    page = val_aligned_alloc(PGT_TABLE_SIZE, PGT_TABLE_SIZE);
+    if (page != NULL)
+        pgt_zero_table(page, PGT_TABLE_SIZE);
+
+    return page;
 }
 
-static
-uint32_t get_entries_per_level(uint32_t page_size)
+/**
+  @brief  Return a translation table page to where it was allocated from.
+
+  @param  page  Virtual address of the table page
+
+  @return None
+**/
+static void pgt_free_table(uint64_t *page)
 {
-    switch (page_size)
-    {
-        case(PAGE_SIZE_4K):   //4kb granule
-            return MAX_ENTRIES_4K;
-        case(PAGE_SIZE_16K):  //16kb granule
-            return MAX_ENTRIES_16K;
-        case(PAGE_SIZE_64K):  //64kb granule
-            return MAX_ENTRIES_64K;
-        default:
-            val_print(ACS_PRINT_ERR, "\n       %llx granularity not supported.", page_size);
-            return 0;
+    uint8_t *addr = (uint8_t *)page;
+
+    if ((pgt_slab.base == NULL) || (addr < pgt_slab.base) ||
+        (addr >= pgt_slab.base + (uint64_t)pgt_slab.num_pages * PGT_TABLE_SIZE)) {
+        val_memory_free_aligned(page);
+        return;
     }
+
+    pgt_zero_table(page, PGT_TABLE_SIZE);
+
+    pgt_slab_acquire();
+    page[0] = (uint64_t)pgt_slab.free_list;
+    pgt_slab.free_list = page;
+    pgt_slab_release();
 }
 
-static
-uint64_t get_block_size(uint32_t level)
+/**
+  @brief  Allocate the root table. G-stage roots span four pages and must be
+          16KiB aligned, so they bypass the slab.
+
+  @param  ctx  Page table context
+
+  @return Virtual address of the root table, NULL on failure
+**/
+static uint64_t *pgt_alloc_root(pgt_ctx_t *ctx)
 {
-    uint32_t entries = get_entries_per_level(page_size);
-    switch (level)
-    {
-        case(PGT_LEVEL_0):  // For L0 table translation
-            if (page_size == PAGE_SIZE_4K)
-                return (uint64_t)(page_size * entries * entries * entries);
-            else if (page_size == PAGE_SIZE_16K)
-                return (uint64_t)(page_size * entries * entries * 2); // only 2 lookup tables in L0
-            else {
-                val_print(ACS_PRINT_ERR, "\n       L0 tables not supported for page size %llx",
-                                                                                        page_size);
-                return 0;
-            }
+    uint64_t *root;
 
-        case(PGT_LEVEL_1):  // For L1 table translation
-            if (page_size == PAGE_SIZE_4K || page_size == PAGE_SIZE_16K)
-                return (uint64_t)(page_size * entries * entries);
-            else
-                return (uint64_t)(page_size * entries * 64); // 64 Lookup tables in L1 (64KB Gran)
+    if (ctx->root_pages == 1)
+        return pgt_alloc_table();
 
-        case(PGT_LEVEL_2):  // For L2 table translation
-            return (uint64_t)(page_size * entries);
-        case(PGT_LEVEL_3):  // For L3 table translation
-            return (uint64_t)(page_size);
-        default:
-            return 0;
-    }
+    root = val_aligned_alloc(ctx->root_pages * PGT_TABLE_SIZE, ctx->root_pages * PGT_TABLE_SIZE);
+    if (root != NULL)
+        pgt_zero_table(root, ctx->root_pages * PGT_TABLE_SIZE);
+
+    return root;
+}
+
+static void pgt_free_root(pgt_ctx_t *ctx, uint64_t *root)
+{
+    if (ctx->root_pages == 1)
+        pgt_free_table(root);
+    else
+        val_memory_free_aligned(root);
 }
 
 /**
-  @brief  This API fills the translation table
+  @brief  Select the smallest Sv39/Sv48/Sv57 mode covering the input address
+          size. Stage 2 tables use the x4 variants with a 2 bit wider root index.
 
-  @param  tt_desc   Translation Table Descriptor
-  @param  mem_desc  Memory Descriptor
+  @param  ctx    Page table context to fill
+  @param  ias    Input address size in bits
+  @param  stage  PGT_STAGE1 or PGT_STAGE2
 
-  @return 0 if Success
+  @return 0 if Success, ACS_STATUS_ERR if no mode covers ias
 **/
-static
-uint32_t fill_translation_table(tt_descriptor_t tt_desc, memory_region_descriptor_t *mem_desc)
+static uint32_t pgt_ctx_init(pgt_ctx_t *ctx, uint32_t ias, uint32_t stage)
 {
-    uint64_t block_size = 0x1ull << tt_desc.size_log2;
-    uint64_t input_address, output_address, filled_tables, table_index, max_allowed_mem;
-    uint64_t *tt_base_next_level, *table_desc;
-    tt_descriptor_t tt_desc_next_level;
-
-    val_print(PGT_DEBUG_LEVEL, "\n       tt_desc.level: %d     ", tt_desc.level);
-    val_print(PGT_DEBUG_LEVEL, "\n       tt_desc.input_base: 0x%llx     ", tt_desc.input_base);
-    val_print(PGT_DEBUG_LEVEL, "\n       tt_desc.input_top: 0x%llx     ", tt_desc.input_top);
-    val_print(PGT_DEBUG_LEVEL, "\n       tt_desc.output_base: 0x%llx     ", tt_desc.output_base);
-    val_print(PGT_DEBUG_LEVEL, "\n       tt_desc.size_log2: %d     ", tt_desc.size_log2);
-    val_print(PGT_DEBUG_LEVEL, "\n       tt_desc.nbits: %d     ", tt_desc.nbits);
-
-    if (!is_values_init) {
-        setup_acs_pgt_values();
-        is_values_init = 1;
+    uint32_t extra_bits = (stage == PGT_STAGE2) ? PGT_GSTAGE_EXTRA_BITS : 0;
+
+    if (ias <= PGT_IAS_SV39 + extra_bits) {
+        ctx->mode = PGT_MODE_SV39;
+        ctx->num_levels = 3;
+    } else if (ias <= PGT_IAS_SV48 + extra_bits) {
+        ctx->mode = PGT_MODE_SV48;
+        ctx->num_levels = 4;
+    } else if (ias <= PGT_IAS_SV57 + extra_bits) {
+        ctx->mode = PGT_MODE_SV57;
+        ctx->num_levels = 5;
+    } else {
+        val_print(ACS_PRINT_ERR, "\n       pgt: unsupported input address size %d     ", ias);
+        return ACS_STATUS_ERR;
     }
 
-    for (input_address = tt_desc.input_base, output_address = tt_desc.output_base;
-         input_address < tt_desc.input_top;
-         input_address += (block_size - offset), output_address += (block_size - offset))
-    {
-        table_index = input_address >> tt_desc.size_log2 & ((0x1ull << tt_desc.nbits) - 1);
-        table_desc = &tt_desc.tt_base[table_index];
+    ctx->top_level       = ctx->num_levels - 1;
+    ctx->root_index_bits = PGT_BITS_PER_LEVEL + extra_bits;
+    ctx->root_pages      = (stage == PGT_STAGE2) ? PGT_GSTAGE_ROOT_PAGES : 1;
+    ctx->ias             = PGT_PAGE_SHIFT + ctx->num_levels * PGT_BITS_PER_LEVEL + extra_bits;
+    ctx->stage           = stage;
 
-        val_print(PGT_DEBUG_LEVEL, "\n       table_index = %d     ", table_index);
+    return 0;
+}
 
-        if (tt_desc.level == 3)
-        {
-            //Create level 3 page descriptor entry
-            *table_desc = PGT_ENTRY_PAGE_MASK | PGT_ENTRY_VALID_MASK;
-            *table_desc |= (output_address & ~(uint64_t)(page_size - 1));
-            *table_desc |= mem_desc->attributes;
-            val_print(PGT_DEBUG_LEVEL, "\n       page_descriptor = 0x%llx     ", *table_desc);
-            /* Keep a count of number of L3 tables filled. If the number exceedes the limit, move
-               to next L2 table and continue.  */
-            increment_pgt_index(tt_desc.level, get_entries_per_level(page_size));
-            offset = 0;
-            continue;
-        }
+/* Number of input address bits translated below the given level */
+static uint32_t pgt_level_shift(uint32_t level)
+{
+    return PGT_PAGE_SHIFT + level * PGT_BITS_PER_LEVEL;
+}
+
+static uint32_t pgt_level_index_bits(pgt_ctx_t *ctx, uint32_t level)
+{
+    if (level == ctx->top_level)
+        return ctx->root_index_bits;
+
+    return PGT_BITS_PER_LEVEL;
+}
+
+/* Superpage leaves used when alignment allows: 1GiB gigapages and 2MiB megapages */
+static uint32_t pgt_leaf_allowed(uint32_t level)
+{
+    return (level == PGT_LEVEL_1 || level == PGT_LEVEL_2);
+}
+
+/**
+  @brief  Build the leaf PTE for an output address. Permission bits default
+          to read/write when the region does not specify any, and the region's
+          Svpbmt type (PMA/NC/IO) is carried over unchanged.
+
+  @param  ctx             Page table context
+  @param  output_address  Output address of the leaf
+  @param  attributes      Region attributes
+
+  @return Leaf PTE value
+**/
+static uint64_t pgt_leaf_entry(pgt_ctx_t *ctx, uint64_t output_address, uint64_t attributes)
+{
+    uint64_t pte;
+
+    pte = PGT_DESC_ATTRIBUTES(attributes) | PGT_PTE_V | PGT_PA_TO_PTE(output_address);
+
+    if ((pte & PGT_PTE_LEAF_MASK) == 0)
+        pte |= PGT_STAGE1_AP_RW;
+
+    if (ctx->stage == PGT_STAGE2)
+        pte |= PGT_PTE_U;
+
+    return pte;
+}
+
+/**
+  @brief  This API free the translation table
+
+  @param  ctx         Page table context
+  @param  tt_base     Translation Table Base
+  @param  this_level  current translation level
+
+  @return None
+**/
+static void free_translation_table(pgt_ctx_t *ctx, uint64_t *tt_base, uint32_t this_level)
+{
+    uint32_t index;
+    uint64_t *tt_base_next_virt;
+
+    if (this_level == PGT_LEVEL_0)
+        return;
 
-        //Are input and output addresses eligible for being described via block descriptor?
-        if ((input_address & (block_size - 1)) == 0 &&
-             (output_address & (block_size - 1)) == 0 &&
-             tt_desc.input_top >= (input_address + block_size - 1)) {
-            //Create a block descriptor entry
-            *table_desc = PGT_ENTRY_BLOCK_MASK | PGT_ENTRY_VALID_MASK;
-            *table_desc |= (output_address & ~(block_size - 1));
-            *table_desc |= mem_desc->attributes;
-            val_print(PGT_DEBUG_LEVEL, "\n       block_descriptor = 0x%llx     ", *table_desc);
-            increment_pgt_index(tt_desc.level, get_entries_per_level(page_size));
-            offset = 0;
+    for (index = 0; index < (0x1ul << pgt_level_index_bits(ctx, this_level)); ++index)
+    {
+        if (!IS_PGT_ENTRY_TABLE(tt_base[index]))
             continue;
-        }
-        /*
-        If there's no descriptor populated at current index of this page_table, or
-        If there's a block descriptor, allocate new page, else use the already populated address.
-        Block descriptor info will be overwritten in case its there.
-        */
-        if (*table_desc == 0 || IS_PGT_ENTRY_BLOCK(*table_desc))
-        {
-            tt_base_next_level = val_memory_alloc_pages(1);
-            if (tt_base_next_level == NULL)
-            {
-                val_print(ACS_PRINT_ERR,
-                "\n       fill_translation_table: page allocation failed     ",
-                0);
-                return ACS_STATUS_ERR;
-            }
-            val_memory_set(tt_base_next_level, page_size, 0);
-        }
-        else
-            tt_base_next_level = val_memory_phys_to_virt(*table_desc & pgt_addr_mask);
-
-        tt_desc_next_level.tt_base    = tt_base_next_level;
-        tt_desc_next_level.input_base = input_address;
-        filled_tables                 = get_pgt_index(tt_desc.level + 1);
-        offset                        = filled_tables * get_block_size(tt_desc.level + 1);
-
-        val_print(PGT_DEBUG_LEVEL, "       filled_tables in next level = 0x%llx", filled_tables);
-        val_print(PGT_DEBUG_LEVEL, "       offset = 0x%llx", offset);
-
-        // Calculate the maximum allowed mem addr that can be mapped for the L0/L1/L2 table.
-        // This prevents overwriting page tables.
-        max_allowed_mem                = input_address + block_size - offset - 1;
-        tt_desc_next_level.input_top   = get_min(tt_desc.input_top, max_allowed_mem);
-        tt_desc_next_level.output_base = output_address;
-        tt_desc_next_level.level       = tt_desc.level + 1;
-        tt_desc_next_level.size_log2   = tt_desc.size_log2 - bits_per_level;
-        tt_desc_next_level.nbits       = bits_per_level;
-        increment_pgt_index(tt_desc.level, get_entries_per_level(page_size));
-
-        if (fill_translation_table(tt_desc_next_level, mem_desc))
-        {
-            val_memory_free_pages(tt_base_next_level, 1);
-            return ACS_STATUS_ERR;
-        }
 
-        *table_desc = PGT_ENTRY_TABLE_MASK | PGT_ENTRY_VALID_MASK;
-        *table_desc |= (uint64_t)val_memory_virt_to_phys(tt_base_next_level) &
-                       ~(uint64_t)(page_size - 1);
-        val_print(PGT_DEBUG_LEVEL, "\n      table_descriptor = 0x%llx     ", *table_desc);
+        tt_base_next_virt = val_memory_phys_to_virt(PGT_PTE_TO_PA(tt_base[index]));
+        if (tt_base_next_virt == NULL)
+            continue;
+        free_translation_table(ctx, tt_base_next_virt, this_level - 1);
+        val_print(PGT_DEBUG_LEVEL,
+                  "\n       free_translation_table: tt_base_next_virt = %llx     ",
+                  (uint64_t)tt_base_next_virt);
+        pgt_free_table(tt_base_next_virt);
     }
-    return 0;
 }
 
 /**
-  @brief  This API returns the log2(page_size)
+  @brief  Build a next level table reproducing an existing superpage leaf with
+          leaves one level down, so that part of it can be remapped without
+          unmapping the rest.
 
-  @param  size   Size
+  @param  leaf   Superpage PTE to split
+  @param  level  Level of the superpage PTE
 
-  @return log2 page size
+  @return Virtual address of the new table, NULL on failure
 **/
-static uint32_t log2_page_size(uint64_t size)
+static uint64_t *pgt_split_leaf(uint64_t leaf, uint32_t level)
 {
-    int bit = 0;
-    while (size != 0)
+    uint64_t *table, next_block_size;
+    uint32_t index;
+
+    table = pgt_alloc_table();
+    if (table == NULL)
+        return NULL;
+
+    next_block_size = 0x1ull << pgt_level_shift(level - 1);
+    for (index = 0; index < MAX_ENTRIES_4K; index++)
+        table[index] = leaf + PGT_PA_TO_PTE(index * next_block_size);
+
+    return table;
+}
+
+/**
+  @brief  Map one memory region, walking the levels iteratively and greedily
+          using 1GiB and 2MiB leaves when the addresses and remaining length allow.
+
+  @param  ctx       Page table context
+  @param  tt_base   Virtual address of the root table
+  @param  mem_desc  Memory region to map
+
+  @return 0 if Success
+**/
+static uint32_t pgt_map_region(pgt_ctx_t *ctx, uint64_t *tt_base,
+                               memory_region_descriptor_t *mem_desc)
+{
+    uint64_t input_address, output_address, input_top, block_size;
+    uint64_t *table, *table_desc, *tt_base_next_level;
+    uint32_t level, shift;
+
+    input_address  = mem_desc->virtual_address;
+    output_address = mem_desc->physical_address;
+    input_top      = input_address + mem_desc->length - 1;
+
+    while (input_address <= input_top && input_address >= mem_desc->virtual_address)
     {
-        if (size & 1)
-            return bit;
-        size >>= 1;
-        ++bit;
+        table = tt_base;
+
+        for (level = ctx->top_level; ; level--)
+        {
+            shift = pgt_level_shift(level);
+            block_size = 0x1ull << shift;
+            table_desc = &table[(input_address >> shift) &
+                                ((0x1ull << pgt_level_index_bits(ctx, level)) - 1)];
+
+            if (level == PGT_LEVEL_0 ||
+                (pgt_leaf_allowed(level) &&
+                 (input_address & (block_size - 1)) == 0 &&
+                 (output_address & (block_size - 1)) == 0 &&
+                 (input_top - input_address) >= (block_size - 1)))
+            {
+                /* A table in the way is fully covered by the new leaf, release it */
+                if (level != PGT_LEVEL_0 && IS_PGT_ENTRY_TABLE(*table_desc))
+                {
+                    tt_base_next_level = val_memory_phys_to_virt(PGT_PTE_TO_PA(*table_desc));
+                    if (tt_base_next_level != NULL)
+                    {
+                        free_translation_table(ctx, tt_base_next_level, level - 1);
+                        pgt_free_table(tt_base_next_level);
+                    }
+                }
+
+                *table_desc = pgt_leaf_entry(ctx, output_address, mem_desc->attributes);
+                if (level != PGT_LEVEL_0)
+                    val_print(PGT_DEBUG_LEVEL, "\n       superpage pte = 0x%llx     ", *table_desc);
+                break;
+            }
+
+            /* Descend into the next level table, creating it if there is none yet.
+               A superpage in the way is split so the rest of it stays mapped. */
+            if (!IS_PGT_ENTRY_TABLE(*table_desc))
+            {
+                if (IS_PGT_ENTRY_LEAF(*table_desc))
+                    tt_base_next_level = pgt_split_leaf(*table_desc, level);
+                else
+                    tt_base_next_level = pgt_alloc_table();
+                if (tt_base_next_level == NULL)
+                {
+                    val_print(ACS_PRINT_ERR, "\n       pgt_map_region: page allocation failed", 0);
+                    return ACS_STATUS_ERR;
+                }
+
+                /* Non-leaf PTEs carry no permission, A/D/U or PBMT bits */
+                *table_desc = PGT_PTE_V |
+                              PGT_PA_TO_PTE(val_memory_virt_to_phys(tt_base_next_level));
+                val_print(PGT_DEBUG_LEVEL, "\n       table pte = 0x%llx     ", *table_desc);
+            }
+            else
+                tt_base_next_level = val_memory_phys_to_virt(PGT_PTE_TO_PA(*table_desc));
+
+            table = tt_base_next_level;
+        }
+
+        input_address  += block_size;
+        output_address += block_size;
     }
+
     return 0;
 }
 
 /**
-  @brief Create stage 1 or stage 2 page table, with given memory addresses and attributes
+  @brief Create stage 1 (Sv39/Sv48/Sv57) or stage 2 (Sv39x4/Sv48x4/Sv57x4) page table,
+         with given memory addresses and attributes. The mode is the smallest one
+         covering pgt_desc->ias, see val_pgt_get_mode().
          Note: This API updates existing translation table if pgt_desc->pgt_base is not NULL
                else it created new table and updated pgt_desc->pgt_base with the address.
+         All state is kept on the caller's stack, so independent tables can be created
+         from several harts at the same time.
   @param mem_desc - Array of memory addresses and attributes needed for page table creation.
+                    attributes hold the leaf PTE bits (R/W/X/U/G/A/D and PBMT).
   @param pgt_desc - Data structure for output page table base and input translation attributes.
   @return status
 **/
 uint32_t val_pgt_create(memory_region_descriptor_t *mem_desc, pgt_descriptor_t *pgt_desc)
 {
     uint64_t *tt_base;
-    tt_descriptor_t tt_desc;
-    uint32_t num_pgt_levels, page_size_log2;
+    uint32_t new_table = 0;
+    pgt_ctx_t ctx;
     memory_region_descriptor_t *mem_desc_iter;
 
-    page_size = val_memory_page_size();
-    page_size_log2 = log2_page_size(page_size);
-    bits_per_level = page_size_log2 - 3;
-    num_pgt_levels = (pgt_desc->ias - page_size_log2 + bits_per_level - 1)/bits_per_level;
-    num_pgt_levels = (num_pgt_levels > 4)?4:num_pgt_levels;
-    val_print(PGT_DEBUG_LEVEL, "\n       val_pgt_create: nbits_per_level = %d    ", bits_per_level);
-    val_print(PGT_DEBUG_LEVEL, "\n       val_pgt_create: page_size_log2 = %d     ", page_size_log2);
+    if (pgt_ctx_init(&ctx, pgt_desc->ias, pgt_desc->stage))
+        return ACS_STATUS_ERR;
+
+    val_print(PGT_DEBUG_LEVEL, "\n       val_pgt_create: mode = %d    ", ctx.mode);
+    val_print(PGT_DEBUG_LEVEL, "\n       val_pgt_create: levels = %d     ", ctx.num_levels);
 
     /* check whether input page descriptor has base addr of translation table
        to use. If the pgt_base member is NULL allocate a page to create a new
        table, else update existing translation table */
     if (pgt_desc->pgt_base == (uint64_t) NULL) {
-        tt_base = (uint64_t *) val_memory_alloc_pages(1);
+        tt_base = pgt_alloc_root(&ctx);
         if (tt_base == NULL) {
             val_print(ACS_PRINT_ERR, "\n      val_pgt_create: page allocation failed     ", 0);
             return ACS_STATUS_ERR;
         }
-        val_memory_set(tt_base, page_size, 0);
+        new_table = 1;
     }
     else
-        tt_base = (uint64_t *) pgt_desc->pgt_base;
-
-    tt_desc.tt_base = tt_base;
-    pgt_addr_mask = ((0x1ull << (pgt_desc->ias - page_size_log2)) - 1) << page_size_log2;
+        tt_base = val_memory_phys_to_virt(pgt_desc->pgt_base);
 
     for (mem_desc_iter = mem_desc; mem_desc_iter->length != 0; ++mem_desc_iter)
     {
         val_print(PGT_DEBUG_LEVEL,
                   "      val_pgt_create: input addr = 0x%x     ",
-                  mem_desc->virtual_address);
+                  mem_desc_iter->virtual_address);
         val_print(PGT_DEBUG_LEVEL,
                   "      val_pgt_create: output addr = 0x%x     ",
-                  mem_desc->physical_address);
-        val_print(PGT_DEBUG_LEVEL, "      val_pgt_create: length = 0x%x\n     ", mem_desc->length);
-        if ((mem_desc->virtual_address & (uint64_t)(page_size - 1)) != 0 ||
-            (mem_desc->physical_address & (uint64_t)(page_size - 1)) != 0)
+                  mem_desc_iter->physical_address);
+        val_print(PGT_DEBUG_LEVEL, "      val_pgt_create: length = 0x%x\n     ",
+                  mem_desc_iter->length);
+        if ((mem_desc_iter->virtual_address & (PGT_TABLE_SIZE - 1)) != 0 ||
+            (mem_desc_iter->physical_address & (PGT_TABLE_SIZE - 1)) != 0)
             {
                 val_print(ACS_PRINT_ERR, "\n       val_pgt_create: addr alignment err     ", 0);
-                return ACS_STATUS_ERR;
+                goto error;
             }
 
-        if (mem_desc->physical_address >= (0x1ull << pgt_desc->oas))
+        if (pgt_desc->oas && mem_desc_iter->physical_address >= (0x1ull << pgt_desc->oas))
         {
             val_print(ACS_PRINT_ERR,
                       "\n       val_pgt_create: output address size error     ",
                       0);
-            return ACS_STATUS_ERR;
+            goto error;
         }
 
-        if (mem_desc->virtual_address >= (0x1ull << pgt_desc->ias))
+        if (mem_desc_iter->virtual_address >= (0x1ull << ctx.ias))
         {
             val_print(ACS_PRINT_WARN,
                       "\n       val_pgt_create: input address size error, "
                       "truncating to %d-bits     ",
-                      pgt_desc->ias);
-            mem_desc->virtual_address &= ((0x1ull << pgt_desc->ias) - 1);
+                      ctx.ias);
+            mem_desc_iter->virtual_address &= ((0x1ull << ctx.ias) - 1);
         }
 
-        tt_desc.input_base = mem_desc->virtual_address & ((0x1ull << pgt_desc->ias) - 1);
-        tt_desc.input_top = tt_desc.input_base + mem_desc->length - 1;
-        tt_desc.output_base = mem_desc->physical_address & ((0x1ull << pgt_desc->oas) - 1);
-        tt_desc.level = 4 - num_pgt_levels;
-        tt_desc.size_log2 = (num_pgt_levels - 1) * bits_per_level + page_size_log2;
-        tt_desc.nbits = pgt_desc->ias - tt_desc.size_log2;
-
-        if (fill_translation_table(tt_desc, mem_desc))
-        {
-            val_memory_free_pages(tt_base, 1);
-            return ACS_STATUS_ERR;
-        }
+        if (pgt_map_region(&ctx, tt_base, mem_desc_iter))
+            goto error;
     }
 
     pgt_desc->pgt_base = (uint64_t)val_memory_virt_to_phys(tt_base);
 
     return 0;
+
+error:
+    if (new_table) {
+        free_translation_table(&ctx, tt_base, ctx.top_level);
+        pgt_free_root(&ctx, tt_base);
+    }
+    return ACS_STATUS_ERR;
+}
+
+/**
+  @brief Get the satp/hgatp MODE value matching a page table built by val_pgt_create.
+  @param pgt_desc - page table translation attributes.
+  @return PGT_MODE_SV39/SV48/SV57, or PGT_MODE_BARE if ias is not supported
+**/
+uint32_t val_pgt_get_mode(pgt_descriptor_t pgt_desc)
+{
+    pgt_ctx_t ctx;
+
+    if (pgt_ctx_init(&ctx, pgt_desc.ias, pgt_desc.stage))
+        return PGT_MODE_BARE;
+
+    return ctx.mode;
 }
 
 /**
@@ -398,10 +514,9 @@ uint32_t val_pgt_create(memory_region_descriptor_t *mem_desc, pgt_descriptor_t *
 uint64_t val_pgt_get_attributes(pgt_descriptor_t pgt_desc, uint64_t virtual_address,
                                 uint64_t *attributes)
 {
-    uint32_t ias, index, num_pgt_levels, this_level;
-    uint32_t bits_at_this_level, bits_remaining;
-    uint64_t val64, tt_base_phys, *tt_base_virt;
-    uint32_t page_size_log2 = pgt_desc.tcr.tg_size_log2;
+    pgt_ctx_t ctx;
+    uint32_t level, shift;
+    uint64_t val64, *tt_base_virt;
 
     if (attributes == NULL)
         return ACS_STATUS_ERR;
@@ -409,83 +524,32 @@ uint64_t val_pgt_get_attributes(pgt_descriptor_t pgt_desc, uint64_t virtual_addr
     if (!pgt_desc.pgt_base)
         return ACS_STATUS_ERR;
 
-    ias = (uint32_t)64 - pgt_desc.tcr.tsz;
+    if (pgt_ctx_init(&ctx, pgt_desc.ias, pgt_desc.stage))
+        return ACS_STATUS_ERR;
+
+    tt_base_virt = val_memory_phys_to_virt(pgt_desc.pgt_base);
 
-    bits_per_level = page_size_log2 - 3;
-    num_pgt_levels = (ias - page_size_log2 + bits_per_level - 1)/bits_per_level;
-    this_level = 4 - num_pgt_levels;
-    bits_remaining = (num_pgt_levels - 1) * bits_per_level + page_size_log2;
-    bits_at_this_level = ias - bits_remaining;
-    tt_base_phys = pgt_desc.pgt_base;
+    for (level = ctx.top_level; ; level--)
+    {
+        if (tt_base_virt == NULL)
+            return ACS_STATUS_ERR;
 
-    while (1) {
-        index = (virtual_address >> bits_remaining) & ((0x1u << bits_at_this_level) - 1);
-        tt_base_virt = (uint64_t*)val_memory_phys_to_virt(tt_base_phys);
-        val64 = tt_base_virt[index];
+        shift = pgt_level_shift(level);
+        val64 = tt_base_virt[(virtual_address >> shift) &
+                             ((0x1ull << pgt_level_index_bits(&ctx, level)) - 1)];
 
-        val_print(PGT_DEBUG_LEVEL,
-                  "\n       val_pgt_get_attributes: this_level = %d     ",
-                  this_level);
-        val_print(PGT_DEBUG_LEVEL,
-                  "\n       val_pgt_get_attributes: index = %d     ",
-                  index);
-        val_print(PGT_DEBUG_LEVEL,
-                  "\n       val_pgt_get_attributes: bits_remaining = %d     ",
-                  bits_remaining);
-        val_print(PGT_DEBUG_LEVEL,
-                  "\n       val_pgt_get_attributes: tt_base_virt = %x     ",
-                  (uint64_t)tt_base_virt);
-        val_print(PGT_DEBUG_LEVEL, "\n       val_pgt_get_attributes: val64 = %x     ", val64);
-        if (this_level == 3)
-        {
-            if (!IS_PGT_ENTRY_PAGE(val64))
-                return ACS_STATUS_ERR;
-            *attributes = PGT_DESC_ATTRIBUTES(val64);
-            return 0;
-        }
-        if (IS_PGT_ENTRY_BLOCK(val64)) {
+        if (IS_PGT_ENTRY_INVALID(val64))
+            return ACS_STATUS_ERR;
+
+        if (IS_PGT_ENTRY_LEAF(val64)) {
             *attributes = PGT_DESC_ATTRIBUTES(val64);
             return 0;
         }
-        tt_base_phys = val64 & (((0x1ull << (ias - page_size_log2)) - 1) << page_size_log2);
-        ++this_level;
-        bits_remaining -= bits_at_this_level;
-        bits_at_this_level = bits_per_level;
-    }
-}
 
-/**
-  @brief  This API free the translation table
-
-  @param  tt_base   Translation Table Base
-  @param  bits_at_this_level  number of bits
-  @param  this_level  current translation level
-
-  @return 0 if Success
-**/
-static void free_translation_table(uint64_t *tt_base, uint32_t bits_at_this_level,
-                                   uint32_t this_level)
-{
-    uint32_t index;
-    uint64_t *tt_base_next_virt;
+        if (level == PGT_LEVEL_0)
+            return ACS_STATUS_ERR;
 
-    if (this_level == 3)
-        return;
-    for (index = 0; index < (0x1ul << bits_at_this_level); ++index)
-    {
-        if (tt_base[index] != 0)
-        {
-            if (IS_PGT_ENTRY_BLOCK(tt_base[index]))
-                continue;
-            tt_base_next_virt = val_memory_phys_to_virt((tt_base[index] & pgt_addr_mask));
-            if (tt_base_next_virt == NULL)
-                continue;
-            free_translation_table(tt_base_next_virt, bits_per_level, this_level+1);
-            val_print(PGT_DEBUG_LEVEL,
-                      "\n       free_translation_table: tt_base_next_virt = %llx     ",
-                      (uint64_t)tt_base_next_virt);
-            val_memory_free_pages(tt_base_next_virt, 1);
-        }
+        tt_base_virt = val_memory_phys_to_virt(PGT_PTE_TO_PA(val64));
     }
 }
 
@@ -496,21 +560,17 @@ static void free_translation_table(uint64_t *tt_base, uint32_t bits_at_this_leve
 **/
 void val_pgt_destroy(pgt_descriptor_t pgt_desc)
 {
-    uint32_t page_size_log2, num_pgt_levels;
+    pgt_ctx_t ctx;
     uint64_t *pgt_base_virt = val_memory_phys_to_virt(pgt_desc.pgt_base);
 
     if (!pgt_desc.pgt_base)
         return;
 
+    if (pgt_ctx_init(&ctx, pgt_desc.ias, pgt_desc.stage))
+        return;
+
     val_print(PGT_DEBUG_LEVEL, "\n       val_pgt_destroy: pgt_base = %llx     ", pgt_desc.pgt_base);
-    page_size = val_memory_page_size();
-    page_size_log2 = log2_page_size(page_size);
-    bits_per_level =  page_size_log2 - 3;
-    pgt_addr_mask = ((0x1ull << (pgt_desc.ias - page_size_log2)) - 1) << page_size_log2;
-    num_pgt_levels = (pgt_desc.ias - page_size_log2 + bits_per_level - 1)/bits_per_level;
-
-    free_translation_table(pgt_base_virt,
-                           pgt_desc.ias - ((num_pgt_levels - 1) * bits_per_level + page_size_log2),
-                           4 - num_pgt_levels);
-    val_memory_free_pages(pgt_base_virt, 1);
+
+    free_translation_table(&ctx, pgt_base_virt, ctx.top_level);
+    pgt_free_root(&ctx, pgt_base_virt);
 }
@@ -556,6 +556,12 @@ val_check_for_error(uint32_t test_num, uint32_t num_hart, char8_t *ruleid)
   uint32_t my_index = val_hart_get_index_mpid(val_hart_get_mpid());
   (void) test_num;
 
+  /* The test is done with its scratch allocations */
+  val_scratch_reset();
+
+  /* Summarise the interrupts it took and drop its handlers */
+  val_gic_isr_report();
+
   /* this special case is needed when the Main HART is not the first entry
      of hart_info_table but num_hart is 1 for SOC tests */
   if (num_hart == 1) {
@@ -612,6 +618,22 @@ val_data_cache_ops_by_va(addr_t addr, uint32_t type)
 
 }
 
+/**
+  @brief  Perform a cache maintenance operation on an address range, using
+          Zicbom block operations when every HART reports a CBOM block size
+
+  @param  addr    Start address
+  @param  length  Length of the range in bytes
+  @param  type    type of cache operation
+
+  @return None
+**/
+void
+val_data_cache_ops_by_range(addr_t addr, uint64_t length, uint32_t type)
+{
+  pal_hart_data_cache_ops_by_range(addr, length, type, val_hart_get_cbom_block_size());
+}
+
 /**
   @brief  Update ELR based on the offset provided
 
@@ -236,6 +236,19 @@ val_get_phy_el1_timer_count(void)
   return  ArmArchTimerReadReg(CntpTval);
 }
 
+/**
+  @brief   This API returns the free running time counter of the calling hart.
+           1. Caller       -  Test Suite
+           2. Prerequisite -  None
+  @param   None
+  @return  Counter value, ticks at TIMER_INFO_CNTFREQ.
+**/
+uint64_t
+val_timer_get_counter(void)
+{
+  return pal_timer_get_counter();
+}
+
 /**
   @brief   This API programs the el1 phy timer with the input timeout value.
            1. Caller       -  Test Suite
@@ -366,7 +379,8 @@ val_timer_create_info_table(uint64_t *timer_info_table)
 void
 val_timer_free_info_table()
 {
-  pal_mem_free((void *)g_timer_info_table);
+  val_info_table_free((void *)g_timer_info_table);
+  g_timer_info_table = NULL;
 }
 
 /**
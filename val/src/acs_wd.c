@@ -144,7 +144,8 @@ val_wd_create_info_table(uint64_t *wd_info_table)
 void
 val_wd_free_info_table()
 {
-  pal_mem_free((void *)g_wd_info_table);
+  val_info_table_free((void *)g_wd_info_table);
+  g_wd_info_table = NULL;
 }
 
 /**
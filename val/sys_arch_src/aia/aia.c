@@ -1,6 +1,7 @@
 #include "include/bsa_acs_val.h"
 #include "include/bsa_acs_iic.h"
 #include "include/bsa_acs_common.h"
+#include "include/bsa_acs_hart.h"
 
 #include "aia.h"
 
@@ -10,6 +11,10 @@
 #define IMSIC_EIP0			    0x80
 #define IMSIC_EIE0			    0xc0
 
+/* On RV64 the odd numbered eipk/eiek registers do not exist, word w lives at register 2w */
+#define IMSIC_EIX_ISEL(__w, __pend) \
+	(((__pend) ? IMSIC_EIP0 : IMSIC_EIE0) + (__w) * (__riscv_xlen / IMSIC_EIPx_BITS))
+
 /* Supervisor Indirect CSR Access */
 #define CSR_SISELECT           0x150
 #define CSR_SIREG                  0x151
@@ -17,6 +22,47 @@
 #define CSR_STOPEI          0x15C
 #define CSR_STOPI                  0xDB0
 
+/* Hypervisor and VS-level IMSIC access */
+#define CSR_VSISELECT			0x250
+#define CSR_VSIREG			0x251
+#define CSR_VSTOPEI			0x25c
+#define CSR_HIE				0x604
+#define CSR_HGEIE			0x607
+#define CSR_HGEIP			0xe12
+#define HSTATUS_VGEIN_SHIFT		12
+#define HSTATUS_VGEIN			0x0003f000UL
+#define HIE_SGEIE			BIT(12)
+
+#define IMSIC_TOPEI_ID_SHIFT		16
+#define SIE_SEIE			BIT(9)
+
+/* APLIC domain registers */
+#define APLIC_DOMAINCFG			0x0000
+#define APLIC_DOMAINCFG_IE		BIT(8)
+#define APLIC_DOMAINCFG_DM		BIT(2)
+#define APLIC_SOURCECFG(__s)		(0x0004 + ((__s) - 1) * 4)
+#define APLIC_SETIPNUM			0x1CDC
+#define APLIC_CLRIPNUM			0x1DDC
+#define APLIC_SETIE(__k)		(0x1E00 + (__k) * 4)
+#define APLIC_SETIENUM			0x1EDC
+#define APLIC_CLRIE(__k)		(0x1F00 + (__k) * 4)
+#define APLIC_CLRIENUM			0x1FDC
+#define APLIC_TARGET(__s)		(0x3004 + ((__s) - 1) * 4)
+#define APLIC_TARGET_HART_SHIFT		18
+#define APLIC_TARGET_EIID_MASK		0x7FF
+#define APLIC_TARGET_IPRIO_MASK		0xFF
+
+/* APLIC interrupt delivery control of one hart, direct mode only */
+#define APLIC_IDC(__i)			(0x4000 + (__i) * 32)
+#define APLIC_IDC_IDELIVERY		0x00
+#define APLIC_IDC_ITHRESHOLD		0x08
+#define APLIC_IDC_CLAIMI		0x1C
+#define APLIC_CLAIMI_ID_SHIFT		16
+
+/* plain accesses, the claim runs in interrupt handlers and pal_mmio_* may print */
+#define aplic_read(__b, __o)		(*(volatile uint32_t *)((__b) + (__o)))
+#define aplic_write(__b, __o, __v)	(*(volatile uint32_t *)((__b) + (__o)) = (__v))
+
 #define imsic_csr_write(__c, __v)	\
 do { \
 	csr_write(CSR_SISELECT, __c); \
@@ -31,6 +77,21 @@ do { \
 	__v; \
 })
 
+/* The same through vsiselect, reaching the guest file selected by hstatus.VGEIN */
+#define vsimsic_csr_write(__c, __v)	\
+do { \
+	csr_write(CSR_VSISELECT, __c); \
+	csr_write(CSR_VSIREG, __v); \
+} while (0)
+
+#define vsimsic_csr_read(__c)	\
+({ \
+	unsigned long __v; \
+	csr_write(CSR_VSISELECT, __c); \
+	__v = csr_read(CSR_VSIREG); \
+	__v; \
+})
+
 #define imsic_csr_set(__c, __v)		\
 do { \
 	csr_write(CSR_SISELECT, __c); \
@@ -46,7 +107,8 @@ do { \
 void
 val_iic_imsic_eix_array_update (uint32_t base_id, uint32_t num_id, bool pend, bool val)
 {
-	uint32_t i, isel, ireg;
+	uint32_t i, isel;
+	unsigned long ireg;
 	uint32_t id = base_id, last_id = base_id + num_id;
 
 	while (id < last_id) {
@@ -71,7 +133,8 @@ val_iic_imsic_eix_array_update (uint32_t base_id, uint32_t num_id, bool pend, bo
 void
 val_iic_imsic_eix_update (uint32_t id, bool pend, bool val)
 {
-	uint32_t isel, ireg;
+	uint32_t isel;
+	unsigned long ireg;
 
     isel = id / __riscv_xlen;
     isel *= __riscv_xlen / IMSIC_EIPx_BITS;
@@ -114,4 +177,461 @@ val_iic_imsic_eithreshold_update (uint32_t val)
 {
 	imsic_csr_write(IMSIC_EITHRESHOLD, val);
     return imsic_csr_read(IMSIC_EITHRESHOLD);
-}
\ No newline at end of file
+}
+
+/**
+  @brief   Return the number of eip/eie words covering the implemented
+           S-level interrupt identities, identity 0 included.
+  @return  Number of words
+**/
+uint32_t
+val_iic_imsic_eix_num_words (void)
+{
+    uint32_t words = (val_gic_max_supervisor_intr_num() + __riscv_xlen) / __riscv_xlen;
+
+    return (words > IMSIC_MAX_EIX_WORDS) ? IMSIC_MAX_EIX_WORDS : words;
+}
+
+/**
+  @brief   Read one whole eip or eie word, identities 64 * word to 64 * word + 63.
+  @param   word - word number
+  @param   pend - true for eip, false for eie
+  @return  Register value
+**/
+uint64_t
+val_iic_imsic_eix_word_read (uint32_t word, bool pend)
+{
+    return imsic_csr_read(IMSIC_EIX_ISEL(word, pend));
+}
+
+/**
+  @brief   Write one whole eip or eie word, identities 64 * word to 64 * word + 63.
+  @param   word - word number
+  @param   pend - true for eip, false for eie
+  @param   val  - value to write
+  @return  None
+**/
+void
+val_iic_imsic_eix_word_write (uint32_t word, bool pend, uint64_t val)
+{
+    imsic_csr_write(IMSIC_EIX_ISEL(word, pend), val);
+}
+
+/**
+  @brief   Snapshot the S-level interrupt file of the calling hart.
+  @param   state - buffer for the eidelivery, eithreshold, eip and eie contents
+  @return  None
+**/
+void
+val_iic_imsic_file_save (IMSIC_FILE_STATE *state)
+{
+    uint32_t w;
+
+    state->num_words   = val_iic_imsic_eix_num_words();
+    state->eidelivery  = imsic_csr_read(IMSIC_EIDELIVERY);
+    state->eithreshold = imsic_csr_read(IMSIC_EITHRESHOLD);
+
+    for (w = 0; w < state->num_words; w++) {
+        state->eie[w] = imsic_csr_read(IMSIC_EIX_ISEL(w, false));
+        state->eip[w] = imsic_csr_read(IMSIC_EIX_ISEL(w, true));
+    }
+}
+
+/**
+  @brief   Restore an S-level interrupt file snapshot taken by
+           val_iic_imsic_file_save. Delivery is held off while the enable
+           and pending words are written and restored last.
+  @param   state - snapshot to restore
+  @return  None
+**/
+void
+val_iic_imsic_file_restore (IMSIC_FILE_STATE *state)
+{
+    uint32_t w;
+
+    imsic_csr_write(IMSIC_EIDELIVERY, 0);
+
+    for (w = 0; w < state->num_words; w++) {
+        imsic_csr_write(IMSIC_EIX_ISEL(w, true), state->eip[w]);
+        imsic_csr_write(IMSIC_EIX_ISEL(w, false), state->eie[w]);
+    }
+
+    imsic_csr_write(IMSIC_EITHRESHOLD, state->eithreshold);
+    imsic_csr_write(IMSIC_EIDELIVERY, state->eidelivery);
+}
+
+/**
+  @brief   Claim the highest priority pending and enabled interrupt of the
+           S-level interrupt file with a single stopei read and write.
+  @return  Claimed identity, 0 if none was pending
+**/
+uint32_t
+val_iic_imsic_claim (void)
+{
+    return (uint32_t)(csr_swap(CSR_STOPEI, 0) >> IMSIC_TOPEI_ID_SHIFT);
+}
+
+/**
+  @brief   Enable or disable supervisor external interrupts in sie.
+  @param   enable - true to set sie.SEIE, false to clear it
+  @return  None
+**/
+void
+val_iic_ext_intr_enable (bool enable)
+{
+    if (enable)
+        csr_set(CSR_SIE, SIE_SEIE);
+    else
+        csr_clear(CSR_SIE, SIE_SEIE);
+}
+
+/**
+  @brief   Save the domaincfg, source enables and targets of an APLIC
+           domain, and optionally the IDC of one hart, then disable every
+           source so only the sources a test enables can fire. Targets are
+           kept since their format changes with the delivery mode.
+  @param   base  - APLIC base address
+  @param   idc   - IDC to save, APLIC_IDC_NONE for none
+  @param   state - buffer for the saved registers
+  @return  None
+**/
+void
+val_iic_aplic_domain_save (uint64_t base, uint32_t idc, APLIC_DOMAIN_STATE *state)
+{
+    uint32_t k, source;
+
+    state->domaincfg = aplic_read(base, APLIC_DOMAINCFG);
+    for (k = 0; k < APLIC_IE_WORDS; k++) {
+        state->setie[k] = aplic_read(base, APLIC_SETIE(k));
+        if (state->setie[k])
+            aplic_write(base, APLIC_CLRIE(k), state->setie[k]);
+    }
+
+    state->target[0] = 0;
+    for (source = 1; source <= APLIC_MAX_SOURCES; source++)
+        state->target[source] = aplic_read(base, APLIC_TARGET(source));
+
+    state->idc = idc;
+    if (idc != APLIC_IDC_NONE) {
+        state->idelivery  = aplic_read(base, APLIC_IDC(idc) + APLIC_IDC_IDELIVERY);
+        state->ithreshold = aplic_read(base, APLIC_IDC(idc) + APLIC_IDC_ITHRESHOLD);
+    }
+}
+
+/**
+  @brief   Restore an APLIC domain saved by val_iic_aplic_domain_save. The
+           delivery mode and targets are put back before the sources are
+           enabled again.
+  @param   base  - APLIC base address
+  @param   state - saved registers
+  @return  None
+**/
+void
+val_iic_aplic_domain_restore (uint64_t base, APLIC_DOMAIN_STATE *state)
+{
+    uint32_t k, source;
+
+    aplic_write(base, APLIC_DOMAINCFG, state->domaincfg);
+    for (source = 1; source <= APLIC_MAX_SOURCES; source++) {
+        if (state->target[source])
+            aplic_write(base, APLIC_TARGET(source), state->target[source]);
+    }
+
+    if (state->idc != APLIC_IDC_NONE)
+        val_iic_aplic_idc_config(base, state->idc, state->idelivery, state->ithreshold);
+
+    for (k = 0; k < APLIC_IE_WORDS; k++) {
+        if (state->setie[k])
+            aplic_write(base, APLIC_SETIE(k), state->setie[k]);
+    }
+}
+
+/**
+  @brief   Select the delivery mode of an APLIC domain and enable it. A
+           domain may implement only one mode, in which case DM is read only.
+  @param   base - APLIC base address
+  @param   msi  - true for MSI delivery, false for direct delivery
+  @return  0 if the domain is now in the requested mode, 1 otherwise
+**/
+uint32_t
+val_iic_aplic_set_mode (uint64_t base, bool msi)
+{
+    uint32_t cfg = APLIC_DOMAINCFG_IE | (msi ? APLIC_DOMAINCFG_DM : 0);
+
+    aplic_write(base, APLIC_DOMAINCFG, cfg);
+
+    return ((aplic_read(base, APLIC_DOMAINCFG) & APLIC_DOMAINCFG_DM) != (cfg & APLIC_DOMAINCFG_DM));
+}
+
+/**
+  @brief   Write the source mode of a source and read it back.
+  @param   base   - APLIC base address
+  @param   source - source number, 1 based
+  @param   sm     - APLIC_SM_* source mode
+  @return  sourcecfg value read back
+**/
+uint32_t
+val_iic_aplic_source_config (uint64_t base, uint32_t source, uint32_t sm)
+{
+    aplic_write(base, APLIC_SOURCECFG(source), sm);
+    return aplic_read(base, APLIC_SOURCECFG(source));
+}
+
+/**
+  @brief   Find a source nobody uses that can be triggered by software. The
+           search starts from the top, where platforms rarely wire devices,
+           and takes the first inactive, non delegated source that accepts
+           the detached mode. The source is left inactive.
+  @param   base        - APLIC base address
+  @param   num_sources - implemented sources of the domain
+  @return  Source number, 0 if there is none
+**/
+uint32_t
+val_iic_aplic_find_free_source (uint64_t base, uint32_t num_sources)
+{
+    uint32_t source;
+
+    if (num_sources > APLIC_MAX_SOURCES)
+        num_sources = APLIC_MAX_SOURCES;
+
+    for (source = num_sources; source > 0; source--) {
+        if (aplic_read(base, APLIC_SOURCECFG(source)) != APLIC_SM_INACTIVE)
+            continue;
+        if (val_iic_aplic_source_config(base, source, APLIC_SM_DETACHED) == APLIC_SM_DETACHED) {
+            val_iic_aplic_source_config(base, source, APLIC_SM_INACTIVE);
+            return source;
+        }
+    }
+
+    return 0;
+}
+
+/**
+  @brief   Route a source to a hart's interrupt file when the domain is in
+           MSI delivery mode.
+  @param   base       - APLIC base address
+  @param   source     - source number, 1 based
+  @param   hart_index - hart index from val_iic_imsic_msi_hart_index
+  @param   eiid       - identity the MSI sets in the S-level interrupt file
+  @return  None
+**/
+void
+val_iic_aplic_target_msi (uint64_t base, uint32_t source, uint32_t hart_index, uint32_t eiid)
+{
+    aplic_write(base, APLIC_TARGET(source),
+                (hart_index << APLIC_TARGET_HART_SHIFT) | (eiid & APLIC_TARGET_EIID_MASK));
+}
+
+/**
+  @brief   Route a source to a hart's IDC when the domain is in direct
+           delivery mode.
+  @param   base   - APLIC base address
+  @param   source - source number, 1 based
+  @param   idc    - IDC number of the hart
+  @param   prio   - priority, 1 is the highest
+  @return  None
+**/
+void
+val_iic_aplic_target_direct (uint64_t base, uint32_t source, uint32_t idc, uint32_t prio)
+{
+    aplic_write(base, APLIC_TARGET(source),
+                (idc << APLIC_TARGET_HART_SHIFT) | (prio & APLIC_TARGET_IPRIO_MASK));
+}
+
+/**
+  @brief   Enable or disable one source.
+**/
+void
+val_iic_aplic_source_enable (uint64_t base, uint32_t source, bool enable)
+{
+    aplic_write(base, enable ? APLIC_SETIENUM : APLIC_CLRIENUM, source);
+}
+
+/**
+  @brief   Set or clear the pending bit of one source, as an edge on its wire
+           would.
+**/
+void
+val_iic_aplic_source_pend (uint64_t base, uint32_t source, bool pend)
+{
+    aplic_write(base, pend ? APLIC_SETIPNUM : APLIC_CLRIPNUM, source);
+}
+
+/**
+  @brief   Configure the IDC of a hart for direct delivery.
+  @param   base      - APLIC base address
+  @param   idc       - IDC number
+  @param   deliver   - enable delivery to the hart
+  @param   threshold - priorities numerically at or above it are masked, 0 masks none
+  @return  None
+**/
+void
+val_iic_aplic_idc_config (uint64_t base, uint32_t idc, bool deliver, uint32_t threshold)
+{
+    aplic_write(base, APLIC_IDC(idc) + APLIC_IDC_ITHRESHOLD, threshold);
+    aplic_write(base, APLIC_IDC(idc) + APLIC_IDC_IDELIVERY, deliver ? 1 : 0);
+}
+
+/**
+  @brief   Claim the highest priority pending source of an IDC with a
+           single claimi read.
+  @return  Claimed source number, 0 if none was pending
+**/
+uint32_t
+val_iic_aplic_idc_claim (uint64_t base, uint32_t idc)
+{
+    return aplic_read(base, APLIC_IDC(idc) + APLIC_IDC_CLAIMI) >> APLIC_CLAIMI_ID_SHIFT;
+}
+
+/**
+  @brief   Discover the implemented guest interrupt files of the calling hart
+           by writing all ones to hgeie and reading it back. hgeie is
+           restored afterwards.
+  @return  Bit g set for each implemented guest file g, bit 0 always clear
+**/
+uint64_t
+val_iic_guest_files (void)
+{
+    uint64_t saved = csr_read(CSR_HGEIE);
+    uint64_t files;
+
+    csr_write(CSR_HGEIE, ~0UL);
+    files = csr_read(CSR_HGEIE);
+    csr_write(CSR_HGEIE, saved);
+
+    return files & ~BIT(0);
+}
+
+/**
+  @brief   Select the guest interrupt file the vsiselect/vsireg and vstopei
+           CSRs reach, through hstatus.VGEIN.
+  @param   vgein - guest file number, 0 for none
+  @return  Previous hstatus.VGEIN
+**/
+uint32_t
+val_iic_guest_file_select (uint32_t vgein)
+{
+    uint64_t hstatus = val_hart_get_hstatus();
+
+    val_hart_set_hstatus((hstatus & ~HSTATUS_VGEIN) |
+                         (((uint64_t)vgein << HSTATUS_VGEIN_SHIFT) & HSTATUS_VGEIN));
+
+    return (hstatus & HSTATUS_VGEIN) >> HSTATUS_VGEIN_SHIFT;
+}
+
+/**
+  @brief   Snapshot the selected guest interrupt file, as val_iic_imsic_file_save
+           does for the S-level file.
+  @param   state - buffer for the eidelivery, eithreshold, eip and eie contents
+  @return  None
+**/
+void
+val_iic_guest_file_save (IMSIC_FILE_STATE *state)
+{
+    uint32_t w;
+
+    state->num_words = (val_gic_max_guest_intr_num() + __riscv_xlen) / __riscv_xlen;
+    if (state->num_words > IMSIC_MAX_EIX_WORDS)
+        state->num_words = IMSIC_MAX_EIX_WORDS;
+
+    state->eidelivery  = vsimsic_csr_read(IMSIC_EIDELIVERY);
+    state->eithreshold = vsimsic_csr_read(IMSIC_EITHRESHOLD);
+    for (w = 0; w < state->num_words; w++) {
+        state->eie[w] = vsimsic_csr_read(IMSIC_EIX_ISEL(w, false));
+        state->eip[w] = vsimsic_csr_read(IMSIC_EIX_ISEL(w, true));
+    }
+}
+
+/**
+  @brief   Restore a guest interrupt file snapshot taken by
+           val_iic_guest_file_save, delivery last.
+  @param   state - snapshot to restore
+  @return  None
+**/
+void
+val_iic_guest_file_restore (IMSIC_FILE_STATE *state)
+{
+    uint32_t w;
+
+    vsimsic_csr_write(IMSIC_EIDELIVERY, 0);
+    for (w = 0; w < state->num_words; w++) {
+        vsimsic_csr_write(IMSIC_EIX_ISEL(w, true), state->eip[w]);
+        vsimsic_csr_write(IMSIC_EIX_ISEL(w, false), state->eie[w]);
+    }
+    vsimsic_csr_write(IMSIC_EITHRESHOLD, state->eithreshold);
+    vsimsic_csr_write(IMSIC_EIDELIVERY, state->eidelivery);
+}
+
+/**
+  @brief   Set up the selected guest interrupt file to take one identity
+           with no threshold, every other identity disabled and clear.
+  @param   id - identity to enable
+  @return  None
+**/
+void
+val_iic_guest_file_arm (uint32_t id)
+{
+    uint32_t w, num_words = (val_gic_max_guest_intr_num() + __riscv_xlen) / __riscv_xlen;
+
+    if (num_words > IMSIC_MAX_EIX_WORDS)
+        num_words = IMSIC_MAX_EIX_WORDS;
+
+    vsimsic_csr_write(IMSIC_EIDELIVERY, 0);
+    for (w = 0; w < num_words; w++) {
+        vsimsic_csr_write(IMSIC_EIX_ISEL(w, true), 0);
+        vsimsic_csr_write(IMSIC_EIX_ISEL(w, false), (w == id / __riscv_xlen) ? BIT(id % __riscv_xlen) : 0);
+    }
+    vsimsic_csr_write(IMSIC_EITHRESHOLD, 0);
+    vsimsic_csr_write(IMSIC_EIDELIVERY, 1);
+}
+
+/**
+  @brief   Clear the pending bit of an identity in the selected guest file.
+**/
+void
+val_iic_guest_eip_clear (uint32_t id)
+{
+    csr_write(CSR_VSISELECT, IMSIC_EIX_ISEL(id / __riscv_xlen, true));
+    csr_clear(CSR_VSIREG, BIT(id % __riscv_xlen));
+}
+
+/**
+  @brief   Claim the highest priority pending identity of the selected guest
+           file with a single vstopei read and write.
+  @return  Claimed identity, 0 if none was pending
+**/
+uint32_t
+val_iic_guest_claim (void)
+{
+    return (uint32_t)(csr_swap(CSR_VSTOPEI, 0) >> IMSIC_TOPEI_ID_SHIFT);
+}
+
+/**
+  @brief   Read the guest external interrupts pending at the calling hart.
+  @return  hgeip
+**/
+uint64_t
+val_iic_guest_pending (void)
+{
+    return csr_read(CSR_HGEIP);
+}
+
+/**
+  @brief   Choose the guest files that raise a supervisor guest external
+           interrupt, and enable or disable that interrupt in hie.
+  @param   files - hgeie value, 0 to disable
+  @return  Previous hgeie
+**/
+uint64_t
+val_iic_guest_intr_enable (uint64_t files)
+{
+    uint64_t saved = csr_read(CSR_HGEIE);
+
+    csr_write(CSR_HGEIE, files);
+    if (files)
+        csr_set(CSR_HIE, HIE_SGEIE);
+    else
+        csr_clear(CSR_HIE, HIE_SGEIE);
+
+    return saved;
+}